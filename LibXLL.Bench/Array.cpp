@@ -0,0 +1,156 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Types/Array.hpp"
+#include "../Utils/Arena.hpp"
+#include "../Utils/Pipe.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr size_t Rows = 1000;
+    constexpr size_t Cols = 100;
+}    // namespace
+
+TEST_CASE( "Array<Number> Benchmarks", "[benchmark][xll::Array]" )
+{
+    const auto source = xll::Array<xll::Number>(Rows, Cols, xll::Number(3.14));
+
+    BENCHMARK("construct 1000x100") { return xll::Array<xll::Number>(Rows, Cols); };
+
+    BENCHMARK("construct filled 1000x100") { return xll::Array<xll::Number>(Rows, Cols, xll::Number(3.14)); };
+
+    BENCHMARK("copy 1000x100") { return xll::Array<xll::Number>(source); };
+
+    // Reference point for the bulk copy path: element-by-element assignment of the same data.
+    BENCHMARK("copy 1000x100 element-wise")
+    {
+        auto target = xll::Array<xll::Number>(Rows, Cols);
+        for (size_t i = 0; i < target.size(); ++i) target[i] = source[i];
+        return target;
+    };
+
+    BENCHMARK("column sum 1000x100 via col()")
+    {
+        auto sum = 0.0;
+        for (size_t j = 0; j < Cols; ++j) {
+            auto column = source.col(j);
+            for (size_t i = 0; i < column.extent(0); ++i) sum += column[i].val.num;
+        }
+        return sum;
+    };
+
+    BENCHMARK_ADVANCED("copy assign 1000x100")(Catch::Benchmark::Chronometer meter)
+    {
+        auto targets = std::vector<xll::Array<xll::Number>>(static_cast<size_t>(meter.runs()));
+        meter.measure([&](int i) { targets[i] = source; });
+    };
+
+    BENCHMARK_ADVANCED("move 1000x100")(Catch::Benchmark::Chronometer meter)
+    {
+        auto sources = std::vector<xll::Array<xll::Number>>(static_cast<size_t>(meter.runs()), source);
+        meter.measure([&](int i) { return xll::Array<xll::Number>(std::move(sources[i])); });
+    };
+}
+
+TEST_CASE( "Array Return Benchmarks", "[benchmark][xll::Array]" )
+{
+    // Handing a 1M-cell result to Excel: a deep copy of the lvalue vs. moving the cells into the returned object.
+    auto result = xll::Array<xll::Number>(1000, 1000, xll::Number(3.14));
+
+    BENCHMARK("return + free 1000x1000 AutoFree, copy")
+    {
+        auto* returned = result | xll::AutoFree();
+        xlAutoFree12(returned);
+    };
+
+    BENCHMARK("return 1000x1000 AutoFree, move")
+    {
+        auto* returned = std::move(result) | xll::AutoFree();
+
+        // Take the cells back (without the xlbitDLLFree flag), so that each run hands over the same buffer.
+        returned->xltype &= ~xlbitDLLFree;
+        result = std::move(*returned);
+        xlAutoFree12(returned);
+    };
+}
+
+TEST_CASE( "Array<String> Benchmarks", "[benchmark][xll::Array]" )
+{
+    const auto source = xll::Array<xll::String>(Rows, 10, xll::String("MSFT US Equity"));
+
+    BENCHMARK("construct 1000x10") { return xll::Array<xll::String>(Rows, 10); };
+
+    BENCHMARK("copy 1000x10") { return xll::Array<xll::String>(source); };
+
+    BENCHMARK("2-D read 1000x10")
+    {
+        size_t length = 0;
+        for (size_t i = 0; i < Rows; ++i)
+            for (size_t j = 0; j < 10; ++j) length += source[i, j].val.str[0];
+        return length;
+    };
+
+    BENCHMARK_ADVANCED("move 1000x10")(Catch::Benchmark::Chronometer meter)
+    {
+        auto sources = std::vector<xll::Array<xll::String>>(static_cast<size_t>(meter.runs()), source);
+        meter.measure([&](int i) { return xll::Array<xll::String>(std::move(sources[i])); });
+    };
+
+    // Building, returning and releasing a result from the same text: one allocation per string vs. a single
+    // block built in place. Both are released through xlAutoFree12.
+    const auto text = std::vector<std::string>(Rows * 10, "MSFT US Equity");
+
+    BENCHMARK("build + return + free 1000x10 AutoFree")
+    {
+        auto result = xll::Array<xll::String>(Rows, 10);
+        for (size_t i = 0; i < text.size(); ++i) result[i] = xll::String(text[i]);
+        xlAutoFree12(std::move(result) | xll::AutoFree());
+    };
+
+    BENCHMARK("build + return + free 1000x10 ArenaFree")
+    {
+        auto result = xll::ArenaArray(Rows, 10);
+        for (size_t i = 0; i < text.size(); ++i) result.set(i / 10, i % 10, text[i]);
+        xlAutoFree12(std::move(result) | xll::ArenaFree());
+    };
+}
+
+TEST_CASE( "Array<Variant> Benchmarks", "[benchmark][xll::Array]" )
+{
+    using variant_t = xll::Variant<xll::Nil, xll::String, xll::Int, xll::Number>;
+
+    auto source = xll::Array<variant_t>(Rows, Cols);
+    for (size_t i = 0; auto& item : source) {
+        switch (i++ % 4) {
+            case 0: item = xll::Number(1.5); break;
+            case 1: item = xll::Int(42); break;
+            case 2: item = xll::String("key"); break;
+            default: item = xll::Nil(); break;
+        }
+    }
+
+    BENCHMARK("construct 1000x100") { return xll::Array<variant_t>(Rows, Cols); };
+
+    BENCHMARK("copy mixed 1000x100") { return xll::Array<variant_t>(source); };
+
+    using plain_t = xll::Variant<xll::Nil, xll::Bool, xll::Int, xll::Number>;
+    const auto plain = xll::Array<plain_t>(Rows, Cols, plain_t(xll::Number(1.5)));
+
+    BENCHMARK("copy plain 1000x100") { return xll::Array<plain_t>(plain); };
+}
+
+TEST_CASE( "make_array Benchmarks", "[benchmark][xll::Array]" )
+{
+    auto numbers = std::vector<fxt::expected<double, std::string>>(Rows * Cols, 2.5);
+    for (size_t i = 0; i < numbers.size(); i += 7) numbers[i] = fxt::unexpected<std::string>("error");
+
+    BENCHMARK("make_array from 100k doubles") { return xll::make_array(numbers); };
+}
@@ -0,0 +1,81 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Async.hpp"
+#include "../Types.hpp"
+
+#include <chrono>
+#include <format>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr size_t Calls = 500;
+
+    // A pricing call waiting 200 us for a remote service.
+    double price(double spot)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        return spot * 1.01;
+    }
+
+    double identity(double value) { return value; }
+
+    // The same call as a coroutine, which holds no thread while it waits:
+    xll::Task<double> price_task(double spot)
+    {
+        co_await xll::sleep_for(std::chrono::microseconds(200));
+        co_return spot * 1.01;
+    }
+}    // namespace
+
+XLL_UDF(BenchSyncPrice, price, spot)
+XLL_ASYNC_UDF(BenchAsyncPrice, price, spot)
+XLL_ASYNC_UDF(BenchAsyncIdentity, identity, value)
+XLL_ASYNC_UDF(BenchTaskPrice, price_task, spot)
+
+TEST_CASE( "Async Benchmarks", "[benchmark][xll::Async]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+
+    // Excel's calculation thread, waiting for each result in turn:
+    BENCHMARK(std::format("{} calls of 200 us, synchronous", Calls))
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < Calls; ++i) total += BenchSyncPrice(static_cast<double>(i))->val.num;
+        return total;
+    };
+
+    // The same calls through the worker pool, until the last result has been returned:
+    const auto run = [&](auto procedure, size_t calls) {
+        host.reset();
+        auto handles = std::vector<XLOPER12>(calls);
+        for (size_t i = 0; i < calls; ++i) {
+            handles[i] = host.async_handle();
+            procedure(static_cast<double>(i), static_cast<const xll::AsyncHandle*>(&handles[i]));
+        }
+        return host.wait_async(calls, std::chrono::seconds(60));
+    };
+
+    for (size_t threads : { 2, 8, 32 }) {
+        xll::configure_async(threads);
+        BENCHMARK(std::format("{} calls of 200 us, {} workers", Calls, threads)) { return run(BenchAsyncPrice, Calls); };
+    }
+
+    xll::configure_async(2);
+    BENCHMARK(std::format("{} coroutine calls of 200 us, 2 workers", Calls)) { return run(BenchTaskPrice, Calls); };
+
+    // The cost of the round trip itself:
+    xll::configure_async(4);
+    BENCHMARK(std::format("{} calls of nothing, 4 workers", 10 * Calls)) { return run(BenchAsyncIdentity, 10 * Calls); };
+
+    xll::configure_async(xll::ThreadPool::default_threads());
+    host.uninstall();
+}
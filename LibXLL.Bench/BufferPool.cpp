@@ -0,0 +1,46 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Types/Array.hpp"
+#include "../Utils/BufferPool.hpp"
+#include "../Utils/Pipe.hpp"
+
+#include <format>
+#include <utility>
+
+namespace
+{
+    // An array formula being recalculated: its result is returned, and released by Excel right after.
+    double recalculate(size_t rows, size_t cols, double value)
+    {
+        auto* result = xll::AutoFree()(xll::Array<xll::Number>(rows, cols, xll::Number(value)));
+        const auto first = result->val.array.lparray[0].val.num;
+        xlAutoFree12(result);
+        return first;
+    }
+
+    double recalculate_slot(size_t rows, size_t cols, double value)
+    {
+        auto* result = xll::Array<xll::Number>(rows, cols, xll::Number(value)) | xll::ThreadLocal();
+        return result->val.array.lparray[0].val.num;
+    }
+}    // namespace
+
+TEST_CASE( "BufferPool Benchmarks", "[benchmark][xll::BufferPool]" )
+{
+    auto& pool = xll::BufferPool::instance();
+
+    for (auto [rows, cols] : { std::pair<size_t, size_t> { 10, 1 }, { 100, 10 }, { 1000, 100 } }) {
+        pool.configure(0, 0);
+        BENCHMARK(std::format("recalc {}x{} AutoFree, no pool", rows, cols)) { return recalculate(rows, cols, 1.5); };
+
+        pool.configure(8, 16 << 20);
+        BENCHMARK(std::format("recalc {}x{} AutoFree, pool", rows, cols)) { return recalculate(rows, cols, 1.5); };
+
+        BENCHMARK(std::format("recalc {}x{} ThreadLocal, pool", rows, cols)) { return recalculate_slot(rows, cols, 1.5); };
+    }
+}
@@ -0,0 +1,40 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Types/Array.hpp"
+#include "../Types/Expected.hpp"
+
+TEST_CASE( "Expected Benchmarks", "[benchmark][xll::Expected]" )
+{
+    const auto value = xll::Expected<xll::Number>(xll::Number(2.0));
+    const auto error = xll::Expected<xll::Number>(xll::Unexpected(xll::ErrNA));
+
+    auto add = [](const xll::Number& num) { return num + 1.0; };
+
+    BENCHMARK("copy value") { return xll::Expected<xll::Number>(value); };
+
+    BENCHMARK("transform value") { return value.transform(add); };
+
+    BENCHMARK("transform error") { return error.transform(add); };
+
+    BENCHMARK("transform chain of 4") { return value.transform(add).transform(add).transform(add).transform(add); };
+
+    BENCHMARK("pipe chain of 4")
+    {
+        return value | xll::transform(add) | xll::transform(add) | xll::transform(add) | xll::transform(add);
+    };
+
+    auto source = xll::Array<xll::Expected<xll::Number>>(1000, 100);
+    for (size_t i = 0; i < source.size(); i += 7) source[i] = xll::Unexpected(xll::ErrNA);
+
+    BENCHMARK("transform 1000x100 array (demo MakeNum)")
+    {
+        auto result = source;
+        for (auto& elem : result) elem = elem | xll::transform(add);
+        return result;
+    };
+}
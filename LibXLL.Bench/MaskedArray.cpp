@@ -0,0 +1,53 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Types/MaskedArray.hpp"
+
+TEST_CASE( "MaskedArray Benchmarks", "[benchmark][xll::MaskedArray]" )
+{
+    auto source = xll::Array<xll::Expected<xll::Number>>(1000, 100, xll::Number(1.5));
+    for (size_t i = 0; i < source.size(); i += 7) source[i] = xll::Unexpected(xll::ErrNA);
+
+    auto add = [](const xll::Number& num) { return num + 1.0; };
+
+    // The reference: the element-wise loop of the demo MakeNum function
+    BENCHMARK("Array<Expected<Number>> transform 1000x100")
+    {
+        auto result = source;
+        for (auto& elem : result) elem = elem | xll::transform(add);
+        return result;
+    };
+
+    BENCHMARK("MaskedArray transform 1000x100 (incl. conversions)")
+    {
+        return xll::MaskedArray(source).apply([](double v) { return v + 1.0; }).to_array();
+    };
+
+    const auto masked = xll::MaskedArray(source);
+
+    BENCHMARK("MaskedArray conversion from Array 1000x100") { return xll::MaskedArray(source); };
+
+    BENCHMARK("MaskedArray conversion to Array 1000x100") { return masked.to_array(); };
+
+    BENCHMARK_ADVANCED("MaskedArray apply 1000x100")(Catch::Benchmark::Chronometer meter)
+    {
+        auto target = masked;
+        meter.measure([&] { return target.apply([](double v) { return v * 0.5 + 1.0; }).size(); });
+    };
+
+    BENCHMARK("Array<Expected<Number>> sum 1000x100")
+    {
+        auto total = 0.0;
+        for (const auto& elem : source)
+            if (elem.has_value()) total += elem.value().val.num;
+        return total;
+    };
+
+    BENCHMARK("MaskedArray sum 1000x100") { return masked.sum(); };
+
+    BENCHMARK("MaskedArray reduce 1000x100") { return masked.reduce(0.0, [](double acc, double v) { return acc + v; }); };
+}
@@ -0,0 +1,83 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Utils/MemoryManager.hpp"
+
+#include <barrier>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // The registry as it was: one map behind one lock, with two lookups per add.
+    class SingleLockRegistry
+    {
+        std::unordered_map<LPXLOPER12, std::unique_ptr<XLOPER12>> m_xlopers {};
+        std::mutex                                                m_mutex;
+
+    public:
+        LPXLOPER12 add(const XLOPER12& obj)
+        {
+            auto       val = std::make_unique<XLOPER12>(obj);
+            const auto key = val.get();
+
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_xlopers[key] = std::move(val);
+            return m_xlopers[key].get();
+        }
+
+        void erase(LPXLOPER12 ptr)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_xlopers.erase(ptr);
+        }
+    };
+
+    constexpr size_t Operations = 20000;
+
+    // N threads, each returning results (add) and having them released (erase), with up to 16 outstanding:
+    template<typename TRegistry>
+    size_t contend(TRegistry& registry, size_t threads)
+    {
+        auto start   = std::barrier(static_cast<std::ptrdiff_t>(threads));
+        auto workers = std::vector<std::jthread>();
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                auto value   = XLOPER12 {};
+                value.xltype = xltypeNum;
+                auto window  = std::vector<LPXLOPER12>(16, nullptr);
+
+                start.arrive_and_wait();
+                for (size_t i = 0; i < Operations / threads; ++i) {
+                    auto& slot = window[i % window.size()];
+                    if (slot != nullptr) registry.erase(slot);
+                    value.val.num = static_cast<double>(i);
+                    slot          = registry.add(value);
+                }
+                for (auto* ptr : window)
+                    if (ptr != nullptr) registry.erase(ptr);
+            });
+        }
+        return workers.size();
+    }
+}    // namespace
+
+TEST_CASE( "MemoryManager Benchmarks", "[benchmark][xll::MemoryManager]" )
+{
+    auto& manager = xll::MemoryManager::Instance();
+    auto  single  = SingleLockRegistry();
+
+    for (size_t threads : { 1, 2, 4, 8 }) {
+        BENCHMARK(std::format("{} add/erase, {} threads, single lock", Operations, threads)) { return contend(single, threads); };
+
+        BENCHMARK(std::format("{} add/erase, {} threads, sharded", Operations, threads)) { return contend(manager, threads); };
+    }
+}
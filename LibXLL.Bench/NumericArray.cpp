@@ -0,0 +1,44 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Types/Array.hpp"
+#include "../Types/NumericArray.hpp"
+
+#include <numeric>
+
+namespace
+{
+    constexpr size_t Rows = 1000;
+    constexpr size_t Cols = 100;
+}    // namespace
+
+TEST_CASE( "NumericArray Benchmarks", "[benchmark][xll::NumericArray]" )
+{
+    const auto cells = xll::Array<xll::Number>(Rows, Cols, xll::Number(1.5));
+    auto       dense = xll::NumericArray::make(Rows, Cols);
+    std::fill(dense->begin(), dense->end(), 1.5);
+
+    BENCHMARK("sum Array<Number> 1000x100")
+    {
+        return std::accumulate(cells.begin(), cells.end(), 0.0, [](double acc, const xll::Number& n) { return acc + n.val.num; });
+    };
+
+    BENCHMARK("sum NumericArray 1000x100") { return std::accumulate(dense->begin(), dense->end(), 0.0); };
+
+    BENCHMARK("scale NumericArray 1000x100 into result buffer")
+    {
+        auto* result = xll::NumericArray::result(Rows, Cols);
+        std::ranges::transform(dense->span(), result->begin(), [](double d) { return d * 2.0; });
+        return result;
+    };
+
+    BENCHMARK("scale NumericArray 1000x100 in place")
+    {
+        for (auto& value : dense->span()) value *= 1.0000001;
+        return dense.get();
+    };
+}
@@ -0,0 +1,108 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Register.hpp"
+
+#include <format>
+#include <vector>
+
+using namespace xll::literals;
+
+XLL_FUNCTION xll::Number* XLLAPI BenchFunction(xll::Number const*, xll::Number const*, xll::Array<xll::Number> const*)
+{
+    return nullptr;
+}
+
+TEST_CASE( "Registration Benchmarks", "[benchmark][xll::Function]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    auto fn = xll::Function("BENCH.FUNCTION")
+        | xll::Result<xll::Number>()
+        | xll::Procedure("BenchFunction")
+        | xll::Parameter<xll::Number>("first", "The first argument")
+        | xll::Parameter<xll::Number>("second", "The second argument")
+        | xll::Parameter<xll::Array<xll::Number>>("third", "The third argument")
+        | xll::ThreadSafe()
+        | xll::Category("Benchmarks")
+        | xll::Description("A function used for benchmarking the registration path")
+        | xll::Help("https://example.com");
+
+    BENCHMARK("build Function with 3 parameters")
+    {
+        return xll::Function("BENCH.FUNCTION")
+            | xll::Result<xll::Number>()
+            | xll::Procedure("BenchFunction")
+            | xll::Parameter<xll::Number>("first", "The first argument")
+            | xll::Parameter<xll::Number>("second", "The second argument")
+            | xll::Parameter<xll::Array<xll::Number>>("third", "The third argument");
+    };
+
+    BENCHMARK("build Function with Signature<> and 3 arguments")
+    {
+        return xll::Function("BENCH.FUNCTION"_xs)
+            | xll::Procedure("BenchFunction"_xs)
+            | xll::Signature<BenchFunction, "$">()
+            | xll::Argument("first"_xs, "The first argument"_xs)
+            | xll::Argument("second"_xs, "The second argument"_xs)
+            | xll::Argument("third"_xs, "The third argument"_xs);
+    };
+
+    BENCHMARK("impl::All") { return xll::impl::All(fn.args); };
+
+    BENCHMARK("impl::All + Register") { return xll::Register(xll::impl::All(fn.args)); };
+
+    host.uninstall();
+}
+
+TEST_CASE( "Startup Benchmarks", "[benchmark][xll::Function]" )
+{
+    constexpr size_t Functions = 3000;
+
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    auto functions = std::vector<xll::impl::FunctionArgs> {};
+    for (size_t i = 0; i < Functions; ++i) {
+        auto fn = xll::Function(xll::String(std::format("BENCH.FUNCTION.{}", i)))
+            | xll::Procedure(xll::String(std::format("BenchFunction{}", i)))
+            | xll::Signature<BenchFunction, "$">()
+            | xll::Argument("first"_xs, "The first argument"_xs)
+            | xll::Argument("second"_xs, "The second argument"_xs)
+            | xll::Argument("third"_xs, "The third argument"_xs)
+            | xll::Category("Benchmarks"_xs);
+        fn.Register();
+    }
+    functions = xll::Function::functionArgs;
+    xll::Function::functionArgs.clear();
+
+    auto& payload = xll::impl::RegistrationPayload::instance();
+
+    BENCHMARK("register 3000 functions with impl::All")
+    {
+        for (const auto& fn : functions) xll::Register(xll::impl::All(fn));
+    };
+
+    BENCHMARK("register 3000 functions with a payload") { return payload.register_all(functions).total; };
+
+    // The same, with every xlfRegister call recorded by the profiler:
+    auto& profiler = xll::Profiler::instance();
+    profiler.enable();
+    BENCHMARK("register 3000 functions with a payload, profiled")
+    {
+        profiler.clear();
+        return payload.register_all(functions).total;
+    };
+    profiler.disable();
+    profiler.clear();
+
+    host.uninstall();
+}
@@ -0,0 +1,79 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Types/String.hpp"
+#include "../Types/StringRef.hpp"
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+TEST_CASE( "String Benchmarks", "[benchmark][xll::String]" )
+{
+    using namespace xll::literals;
+
+    const auto ascii   = std::string("AAPL US Equity");
+    const auto unicode = std::string("召唤😊 Ærø Straße");
+    const auto longer  = std::string(4096, 'x');
+
+    BENCHMARK("UTF-8 to XCHAR, 14 ASCII chars") { return xll::String(ascii); };
+
+    BENCHMARK("UTF-8 to XCHAR, non-ASCII") { return xll::String(unicode); };
+
+    BENCHMARK("UTF-8 to XCHAR, 4096 chars") { return xll::String(longer); };
+
+    const auto xascii   = xll::String(ascii);
+    const auto xunicode = xll::String(unicode);
+    const auto xlonger  = xll::String(longer);
+
+    BENCHMARK("XCHAR to UTF-8, 14 ASCII chars") { return xascii.to_string(); };
+
+    BENCHMARK("XCHAR to UTF-8, non-ASCII") { return xunicode.to_string(); };
+
+    BENCHMARK("XCHAR to UTF-8, 4096 chars") { return xlonger.to_string(); };
+
+    BENCHMARK("round-trip, 14 ASCII chars") { return xll::String(ascii).to_string(); };
+
+    BENCHMARK("copy, 14 ASCII chars") { return xll::String(xascii); };
+
+    BENCHMARK("literal _xs") { return "AAPL US Equity"_xs; };
+
+    BENCHMARK("compare equal") { return xascii == xll::String(xascii); };
+
+    BENCHMARK("concatenate") { return xascii + xunicode; };
+
+    // Argument handling: owning copy vs. non-owning reference.
+    const XLOPER12& argument = xascii;
+
+    BENCHMARK("argument as String, compare UTF-8") { return xll::String(argument) == ascii; };
+
+    BENCHMARK("argument as StringRef, compare UTF-8") { return xll::StringRef(argument) == ascii; };
+
+    BENCHMARK("argument as StringRef, hash") { return std::hash<xll::StringRef>()(xll::StringRef(argument)); };
+}
+
+TEST_CASE( "String Collection Benchmarks", "[benchmark][xll::String]" )
+{
+    auto keys = std::vector<xll::String> {};
+    keys.reserve(100'000);
+    for (size_t i = 0; i < 100'000; ++i) keys.emplace_back("KEY-" + std::to_string((i * 7919) % 50'000));
+
+    BENCHMARK_ADVANCED("sort 100k keys")(Catch::Benchmark::Chronometer meter)
+    {
+        auto inputs = std::vector<std::vector<xll::String>>(static_cast<size_t>(meter.runs()), keys);
+        meter.measure([&](int i) { std::ranges::sort(inputs[i]); });
+    };
+
+    BENCHMARK("deduplicate 100k keys via hash set")
+    {
+        auto seen = std::unordered_set<std::basic_string_view<XCHAR>> {};
+        seen.reserve(keys.size());
+        for (const auto& key : keys) seen.insert(key.view());
+        return seen.size();
+    };
+}
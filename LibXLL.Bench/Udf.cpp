@@ -0,0 +1,93 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Register.hpp"
+#include "../Types.hpp"
+
+#include <cmath>
+#include <numeric>
+#include <span>
+
+namespace
+{
+    constexpr size_t Rows = 1000;
+
+    double add(double lhs, double rhs) { return lhs + rhs; }
+
+    double sum(std::span<const double> values) { return std::accumulate(values.begin(), values.end(), 0.0); }
+
+    double discount(double rate, std::span<const double> flows)
+    {
+        auto result = 0.0;
+        for (size_t i = 0; i < flows.size(); ++i) result += flows[i] / std::pow(1.0 + rate, static_cast<double>(i + 1));
+        return result;
+    }
+}    // namespace
+
+XLL_UDF(BenchUdfAdd, add, lhs, rhs)
+XLL_UDF(BenchUdfSum, sum, values)
+XLL_UDF(BenchUdfDiscount, discount, rate, flows)
+XLL_UDF(BenchMemoDiscount, discount, rate, flows)
+
+// The same functions, written by hand in the usual style:
+XLL_FUNCTION xll::Number* XLLAPI BenchHandAdd(xll::Number const* lhs, xll::Number const* rhs)
+{
+    return xll::AutoFree()(xll::Number(*lhs + *rhs));
+}
+
+XLL_FUNCTION xll::Number* XLLAPI BenchSlotAdd(xll::Number const* lhs, xll::Number const* rhs)
+{
+    return xll::Number(*lhs + *rhs) | xll::ThreadLocal();
+}
+
+XLL_FUNCTION xll::Number* XLLAPI BenchHandSum(xll::Array<xll::Number> const* values)
+{
+    auto result = std::accumulate(values->begin(), values->end(), 0.0, [](double acc, const xll::Number& n) { return acc + n.val.num; });
+    return xll::AutoFree()(xll::Number(result));
+}
+
+TEST_CASE( "Udf Benchmarks", "[benchmark][xll::Udf]" )
+{
+    const auto lhs = xll::Number(1.5);
+    const auto rhs = xll::Number(2.5);
+
+    const auto cells = xll::Array<xll::Number>(Rows, 1, xll::Number(1.5));
+    auto       dense = xll::NumericArray::make(Rows, 1);
+    std::fill(dense->begin(), dense->end(), 1.5);
+
+    // The hand-written results are released by xlAutoFree12, as Excel would.
+    BENCHMARK("hand-written add (Q, AutoFree)")
+    {
+        auto* result = BenchHandAdd(&lhs, &rhs);
+        const auto value = result->val.num;
+        xlAutoFree12(result);
+        return value;
+    };
+
+    BENCHMARK("hand-written add (Q, ThreadLocal)") { return BenchSlotAdd(&lhs, &rhs)->val.num; };
+
+    BENCHMARK("wrapped add (B)") { return BenchUdfAdd(1.5, 2.5)->val.num; };
+
+    BENCHMARK("hand-written sum 1000 (Q, AutoFree)")
+    {
+        auto* result = BenchHandSum(&cells);
+        const auto value = result->val.num;
+        xlAutoFree12(result);
+        return value;
+    };
+
+    BENCHMARK("wrapped sum 1000 (K%)") { return BenchUdfSum(dense.get())->val.num; };
+
+    // A pure function recalculated with unchanged arguments: running it vs. a hit in its memo cache, which hashes
+    // and compares the 1000 arguments.
+    xll::Function("BENCH.MEMO.DISCOUNT") | xll::Procedure("BenchMemoDiscount") | xll::Signature<BenchMemoDiscount, "$">()
+        | xll::Argument("rate", "") | xll::Argument("flows", "") | xll::Memoize(64, 1 << 20) | xll::Register();
+
+    BENCHMARK("wrapped discount 1000 (K%)") { return BenchUdfDiscount(0.05, dense.get())->val.num; };
+
+    BENCHMARK("memoized discount 1000 (K%), hit") { return BenchMemoDiscount(0.05, dense.get())->val.num; };
+}
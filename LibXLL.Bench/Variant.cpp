@@ -0,0 +1,84 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <xlcall.hpp>
+#include "../Types/Variant.hpp"
+
+#include <random>
+#include <vector>
+
+TEST_CASE( "Variant Benchmarks", "[benchmark][xll::Variant]" )
+{
+    using variant_t = xll::Variant<xll::Nil, xll::String, xll::Int, xll::Number, xll::Bool, xll::Error>;
+
+    const auto number = variant_t(xll::Number(3.14));
+    const auto string = variant_t(xll::String("MSFT US Equity"));
+    const auto nil    = variant_t(xll::Nil());
+
+    BENCHMARK("copy Number") { return variant_t(number); };
+
+    BENCHMARK("copy String") { return variant_t(string); };
+
+    BENCHMARK("copy Nil") { return variant_t(nil); };
+
+    BENCHMARK_ADVANCED("assign Number over String")(Catch::Benchmark::Chronometer meter)
+    {
+        auto targets = std::vector<variant_t>(static_cast<size_t>(meter.runs()), string);
+        meter.measure([&](int i) { targets[i] = number; });
+    };
+
+    BENCHMARK_ADVANCED("assign String over Number")(Catch::Benchmark::Chronometer meter)
+    {
+        auto targets = std::vector<variant_t>(static_cast<size_t>(meter.runs()), number);
+        meter.measure([&](int i) { targets[i] = string; });
+    };
+
+    auto visitor = xll::overload {
+        [](const xll::Number& v) { return v.val.num; },
+        [](const xll::Int& v) { return static_cast<double>(v.val.w); },
+        [](const auto&) { return 0.0; },
+    };
+
+    BENCHMARK("visit Number") { return xll::visit(visitor, number); };
+
+    BENCHMARK("visit Nil") { return xll::visit(visitor, nil); };
+
+    // Mixed ranges, as found in Array<Variant<...>> arguments (in random order, so the types are not predictable)
+    auto engine = std::mt19937(42);
+    auto mixed  = std::vector<variant_t>();
+    mixed.reserve(10000);
+    for (int i = 0; i < 10000; ++i) {
+        switch (engine() % 4) {
+            case 0: mixed.emplace_back(xll::Number(i * 0.5)); break;
+            case 1: mixed.emplace_back(xll::Int(i)); break;
+            case 2: mixed.emplace_back(xll::String("MSFT US Equity")); break;
+            default: mixed.emplace_back(xll::Nil()); break;
+        }
+    }
+
+    BENCHMARK("copy mixed range (10000)") { return std::vector<variant_t>(mixed); };
+
+    BENCHMARK("visit mixed range (10000)")
+    {
+        auto total = 0.0;
+        for (const auto& v : mixed) total += xll::visit(visitor, v);
+        return total;
+    };
+
+    BENCHMARK("visit two mixed ranges (10000)")
+    {
+        auto product = xll::overload {
+            [](const xll::Number& a, const xll::Number& b) { return a.val.num * b.val.num; },
+            [](const xll::Number& a, const xll::Int& b) { return a.val.num * b.val.w; },
+            [](const xll::Int& a, const xll::Number& b) { return a.val.w * b.val.num; },
+            [](const auto&, const auto&) { return 0.0; },
+        };
+
+        auto total = 0.0;
+        for (size_t i = 0; i < mixed.size(); ++i) total += xll::visit(product, mixed[i], mixed[mixed.size() - 1 - i]);
+        return total;
+    };
+}
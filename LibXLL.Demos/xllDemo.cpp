@@ -6,6 +6,9 @@
 #include <Register.hpp>
 #include <Types.hpp>
 
+#include <numeric>
+#include <span>
+
 using namespace std::literals;
 using namespace xll::literals;
 
@@ -14,7 +17,7 @@ xll::AddInManagerInfo dllName([] { return xll::String("Awesome Add-In"); });
 auto onOpen =
     xll::OnOpen()
     | xll::Before([] { std::cerr << "xlAutoOpen called...\n"; })
-    | xll::After([] { std::cerr << "xlAutoOpen completed\n"; })
+    | xll::After([] { std::cerr << "xlAutoOpen completed: " << xll::startup_report() << "\n"; })
     | xll::OnError([](const std::string& err) { xll::alert(xll::String(err)); });
 XLL_REGISTER(onOpen);
 
@@ -66,9 +69,25 @@ XLL_FUNCTION xll::Array<xll::Expected<xll::Number>>* XLLAPI MakeNum(xll::Array<x
 
     // static xll::Array<xll::Expected<xll::Number>> result;
     // result = *arg;
-    auto result = *arg;
-    for (auto& elem : result)
-        elem = elem | xll::transform([](const xll::Number& num) { return num + 2;});
 
-    return result | xll::AutoFree();
+    auto result = xll::MaskedArray(*arg).apply([](double num) { return num + 2; }).to_array();
+
+    return std::move(result) | xll::AutoFree();
+}
+
+double ScaleSumImpl(double factor, std::span<const double> values)
+{
+    return factor * std::accumulate(values.begin(), values.end(), 0.0);
 }
+
+XLL_UDF(ScaleSum, ScaleSumImpl, factor, values)
+
+auto scaleSum =
+    xll::Function("SCALE.SUM")
+    | xll::Procedure("ScaleSum")
+    | xll::Signature<ScaleSum, "$">()
+    | xll::Argument("factor", "The scale factor")
+    | xll::Argument("values", "The values to sum")
+    | xll::Category("XLThermo")
+    | xll::Description("Sum of the values, multiplied by a factor");
+XLL_REGISTER(scaleSum);
@@ -0,0 +1,45 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "Register.hpp"
+#include "Async/Async.hpp"
+#include "Async/Task.hpp"
+
+/**
+ * @brief Defines the asynchronous exported function `procedure`, calling the plain C++ function `func` on a worker
+ * thread.
+ *
+ * @details As for XLL_UDF, the remaining arguments name the parameters of the exported function, one per parameter
+ * of `func`. The exported function takes the xll::AsyncHandle as an extra, last parameter, returns nothing, and
+ * completes the call with xlAsyncReturn once `func` has returned. Use xll::Signature<procedure>() to register the
+ * matching type text (">QBX$" in the example below):
+ *
+ *     xll::Number price(const xll::String& ticker, double notional);
+ *     XLL_ASYNC_UDF(Price, price, ticker, notional)
+ *
+ *     auto priceFn = xll::Function("PRICE") | xll::Procedure("Price") | xll::Signature<Price, "$">()
+ *                  | xll::Argument("ticker", "...") | xll::Argument("notional", "...");
+ *     XLL_REGISTER(priceFn);
+ *
+ * Arguments are copied before `func` runs, so parameters referring to Excel's memory (StringRef, NumericArray&)
+ * are not supported; string views and spans refer to copies held until `func` returns.
+ *
+ * If `func` is a coroutine returning xll::Task<T>, it is started on a worker, and the call is completed when the
+ * coroutine finishes. While it waits (co_await xll::sleep_for(...), xll::offload(...) or another Task), no thread is
+ * held, so that many cells may wait at the same time:
+ *
+ *     xll::Task<xll::Number> quote(std::string ticker)
+ *     {
+ *         auto body = co_await xll::offload([&] { return http_get("https://.../" + ticker); });
+ *         co_return parse_price(body);
+ *     }
+ *     XLL_ASYNC_UDF(Quote, quote, ticker)
+ */
+#define XLL_ASYNC_UDF(procedure, func, ...)                                                                              \
+    XLL_FUNCTION void XLLAPI procedure(__VA_OPT__(XLL_UDF_P0(func, __VA_ARGS__), ) const xll::AsyncHandle* xll_handle)     \
+    {                                                                                                                    \
+        xll::impl::AsyncThunk<func>::call(__VA_ARGS__ __VA_OPT__(, ) xll_handle);                                        \
+    }
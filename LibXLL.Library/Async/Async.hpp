@@ -0,0 +1,332 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "AsyncHandle.hpp"
+#include "ThreadPool.hpp"
+#include "TimerQueue.hpp"
+
+#include "../Auto/Auto.hpp"
+#include "../Register/Events.hpp"
+#include "../Register/Function.hpp"
+#include "../Register/Registry.hpp"
+#include "../Register/Udf.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <xlcall.hpp>
+
+namespace xll
+{
+    /**
+     * @brief Counters of the asynchronous calls made since the add-in was loaded.
+     */
+    struct AsyncStats
+    {
+        size_t launched  = 0;    // Calls accepted from Excel.
+        size_t completed = 0;    // Results handed back with xlAsyncReturn.
+        size_t canceled  = 0;    // Calls dropped because the calculation was cancelled.
+        size_t inlined   = 0;    // Calls run on Excel's thread, as the queue was full.
+    };
+
+    namespace impl
+    {
+        /**
+         * @brief Runs asynchronous functions on a ThreadPool, and hands their results back to Excel.
+         *
+         * @details Every call is tagged with the current generation, which is advanced when Excel cancels the
+         * calculation (xleventCalculationCanceled). Calls of an earlier generation are dropped before they start,
+         * and their results are not returned if they were already running, as Excel has abandoned their handles.
+         * When the queue is full, the call is run on the calling thread, which keeps Excel from queueing more work
+         * than the workers can take. The TimerQueue serves coroutines waiting for a point in time (see xll::Task).
+         */
+        class AsyncRuntime
+        {
+            AsyncRuntime() = default;
+
+            ThreadPool            m_pool {};
+            TimerQueue            m_timers {};
+            std::atomic<uint64_t> m_generation { 0 };
+            std::atomic<size_t>   m_launched { 0 };
+            std::atomic<size_t>   m_completed { 0 };
+            std::atomic<size_t>   m_canceled { 0 };
+            std::atomic<size_t>   m_inlined { 0 };
+
+            inline static thread_local const uint64_t* t_generation = nullptr;
+
+            void run(const AsyncHandle& handle, uint64_t generation, const std::function<LPXLOPER12()>& job)
+            {
+                if (generation != m_generation.load(std::memory_order_acquire)) {
+                    m_canceled.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                t_generation            = &generation;
+                const LPXLOPER12 result = job();
+                t_generation            = nullptr;
+
+                finish(handle, generation, result);
+            }
+
+        public:
+            AsyncRuntime(const AsyncRuntime&)            = delete;
+            AsyncRuntime& operator=(const AsyncRuntime&) = delete;
+
+            static AsyncRuntime& instance()
+            {
+                static AsyncRuntime runtime;
+                return runtime;
+            }
+
+            /**
+             * @brief Queues a job for the given handle; the result of the job is returned with xlAsyncReturn.
+             *
+             * @param job A callable returning the result as an LPXLOPER12, which must not throw.
+             */
+            void launch(const AsyncHandle& handle, std::function<LPXLOPER12()> job)
+            {
+                m_launched.fetch_add(1, std::memory_order_relaxed);
+
+                auto task = [this, handle, generation = m_generation.load(std::memory_order_acquire), job = std::move(job)] {
+                    run(handle, generation, job);
+                };
+
+                if (not m_pool.try_submit(task)) {
+                    m_inlined.fetch_add(1, std::memory_order_relaxed);
+                    task();
+                }
+            }
+
+            /**
+             * @brief Counts a call that is run by other means than launch() (e.g. a coroutine).
+             */
+            void started() { m_launched.fetch_add(1, std::memory_order_relaxed); }
+
+            /**
+             * @brief Runs func on a worker, as part of the call of the given generation (see cancelled()).
+             */
+            void post(const uint64_t* generation, std::function<void()> func)
+            {
+                auto task = [generation, func = std::move(func)] {
+                    const auto* previous = std::exchange(t_generation, generation);
+                    func();
+                    t_generation = previous;
+                };
+                if (not m_pool.try_submit(task)) task();
+            }
+
+            /**
+             * @brief Hands the result of a call of the given generation back to Excel, unless the calculation has
+             * been cancelled since, or there is no result (nullptr).
+             */
+            void finish(const AsyncHandle& handle, uint64_t generation, LPXLOPER12 result)
+            {
+                if (result == nullptr || generation != m_generation.load(std::memory_order_acquire)) {
+                    m_canceled.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                complete(handle, result);
+            }
+
+            /**
+             * @brief Hands a result back to Excel.
+             */
+            void complete(const AsyncHandle& handle, LPXLOPER12 value)
+            {
+                XLOPER12 status {};
+                Excel12(xlAsyncReturn, &status, 2, &handle, value);
+                m_completed.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Abandons all calls made so far; called when Excel cancels the calculation.
+             */
+            void cancel() { m_generation.fetch_add(1, std::memory_order_acq_rel); }
+
+            [[nodiscard]] uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }
+
+            /**
+             * @brief True if the calculation of the given generation has been cancelled.
+             */
+            [[nodiscard]] bool cancelled(const uint64_t* generation) const
+            {
+                return generation != nullptr && *generation != m_generation.load(std::memory_order_acquire);
+            }
+
+            /**
+             * @brief True if called from an asynchronous function whose calculation has been cancelled.
+             */
+            [[nodiscard]] bool cancelled() const { return cancelled(t_generation); }
+
+            void configure(size_t threads, size_t capacity) { m_pool.configure(threads, capacity); }
+
+            /**
+             * @brief Abandons all calls, and stops the workers once they have wound down; called from xlAutoClose.
+             */
+            void shutdown()
+            {
+                cancel();
+                m_timers.shutdown();
+                m_pool.shutdown();
+            }
+
+            [[nodiscard]] const ThreadPool& pool() const { return m_pool; }
+
+            [[nodiscard]] TimerQueue& timers() { return m_timers; }
+
+            [[nodiscard]] AsyncStats stats() const
+            {
+                return { m_launched.load(std::memory_order_relaxed),
+                         m_completed.load(std::memory_order_relaxed),
+                         m_canceled.load(std::memory_order_relaxed),
+                         m_inlined.load(std::memory_order_relaxed) };
+            }
+        };
+
+        /**
+         * @brief An owning copy of an argument of type T, which outlives the call from Excel.
+         *
+         * @details Excel's argument memory is only valid during the call, so views (strings, ranges of numbers) are
+         * copied into owning containers, and XLOPER12-based values are copied as a whole.
+         */
+        template<typename T>
+        struct AsyncArg
+        {
+            static_assert(not std::same_as<T, StringRef> && not std::same_as<T, NumericArray>,
+                          "Type refers to Excel's memory, and cannot be passed to an asynchronous function");
+
+            using type = std::remove_cvref_t<decltype(UdfArg<T>::from(std::declval<udf_arg_t<T>>()))>;
+
+            static type own(udf_arg_t<T> value) { return type(UdfArg<T>::from(value)); }
+        };
+
+        template<>
+        struct AsyncArg<std::string_view>
+        {
+            using type = std::string;
+            static type own(udf_arg_t<std::string_view> value) { return type(UdfArg<std::string_view>::from(value)); }
+        };
+
+        template<>
+        struct AsyncArg<std::basic_string_view<XCHAR>>
+        {
+            using type = std::basic_string<XCHAR>;
+            static type own(udf_arg_t<std::basic_string_view<XCHAR>> value) { return type(UdfArg<std::basic_string_view<XCHAR>>::from(value)); }
+        };
+
+        template<>
+        struct AsyncArg<std::span<const double>>
+        {
+            using type = std::vector<double>;
+
+            static type own(udf_arg_t<std::span<const double>> value)
+            {
+                const auto values = UdfArg<std::span<const double>>::from(value);
+                return { values.begin(), values.end() };
+            }
+        };
+
+        template<typename T>
+        using async_arg_t = typename AsyncArg<std::remove_cvref_t<T>>::type;
+
+        template<auto Func, typename TResult, typename TArgs>
+        struct AsyncThunkImpl;
+
+        template<auto Func, typename TResult, typename... TArgs>
+        struct AsyncThunkImpl<Func, TResult, std::tuple<TArgs...>>
+        {
+            static constexpr size_t arity = sizeof...(TArgs);
+
+            /**
+             * @brief Copies the arguments, and runs the function on the AsyncRuntime.
+             *
+             * @details Arguments of the wrong type, and exceptions thrown by the function, are returned as Excel
+             * errors, as for XLL_UDF.
+             */
+            static void call(udf_arg_t<TArgs>... args, const AsyncHandle* handle) noexcept
+            {
+                auto& runtime = AsyncRuntime::instance();
+
+                const auto error = udf_invoke([&]() -> LPXLOPER12 {
+                    runtime.launch(*handle, [owned = std::tuple<async_arg_t<TArgs>...>(AsyncArg<std::remove_cvref_t<TArgs>>::own(args)...)] {
+                        return udf_invoke([&] { return UdfResult<std::remove_cvref_t<TResult>>::store(std::apply(Func, owned)); });
+                    });
+                    return nullptr;
+                });
+
+                if (error != nullptr) runtime.complete(*handle, error);
+            }
+        };
+
+        /**
+         * @brief The exported-function side of a function wrapped with XLL_ASYNC_UDF.
+         */
+        template<auto Func>
+        struct AsyncThunk : AsyncThunkImpl<Func,
+                                           typename signature<std::remove_cvref_t<decltype(Func)>>::result_type,
+                                           typename signature<std::remove_cvref_t<decltype(Func)>>::argument_types>
+        {};
+    }    // namespace impl
+
+    /**
+     * @brief True if called from an asynchronous function whose calculation Excel has cancelled; long-running
+     * functions may check this to stop early, as their result will be discarded.
+     */
+    inline bool async_cancelled() { return impl::AsyncRuntime::instance().cancelled(); }
+
+    /**
+     * @brief Sets the number of worker threads, and the number of calls that may wait for one.
+     */
+    inline void configure_async(size_t threads, size_t capacity = 4096) { impl::AsyncRuntime::instance().configure(threads, capacity); }
+
+    inline AsyncStats async_stats() { return impl::AsyncRuntime::instance().stats(); }
+
+}    // namespace xll
+
+extern "C" inline XLL_EXPORTS int XLLAPI xllAsyncCalculationCanceled()
+{
+    xll::impl::AsyncRuntime::instance().cancel();
+    return XLL_SUCCESS;
+}
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/INCLUDE:xllAsyncCalculationCanceled")
+#endif
+
+namespace xll::impl
+{
+    /**
+     * @brief Registers the command that Excel calls when a calculation is cancelled, and stops the workers when
+     * the add-in is closed.
+     */
+    struct AsyncRegistration
+    {
+        void Register() const
+        {
+            using namespace xll::literals;
+
+            // The command name is prefixed with the add-in's name, as Excel runs the event handler by that name,
+            // and a second add-in built on the library would otherwise take it over:
+            const auto command = String(get_module_prefix() + ".XLL.ASYNC.CANCELED");
+
+            Function(command)
+                .Procedure("xllAsyncCalculationCanceled"_xs)
+                .Signature<xllAsyncCalculationCanceled>()
+                .Command()
+                .Register();
+            EventRegistry::instance().add(command, xleventCalculationCanceled);
+        }
+    };
+
+    inline AsyncRegistration asyncRegistration {};
+    inline const bool        asyncRegistered = (Registry::instance().add(asyncRegistration), true);
+    inline const Auto<Close> asyncShutdown([] { AsyncRuntime::instance().shutdown(); });
+}    // namespace xll::impl
@@ -0,0 +1,21 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <xlcall.hpp>
+
+namespace xll
+{
+    /**
+     * @brief The handle Excel passes to an asynchronous function ("X"), as an xltypeBigData XLOPER12.
+     *
+     * @details The handle identifies the calling cell until the result is handed back with xlAsyncReturn, or the
+     * calculation is cancelled. It is a plain value and may be copied to the thread that completes the call.
+     */
+    struct AsyncHandle : XLOPER12
+    {
+        [[nodiscard]] void* id() const { return val.bigdata.h.hdata; }
+    };
+}    // namespace xll
@@ -0,0 +1,363 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "Async.hpp"
+
+#include <chrono>
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace xll
+{
+    /**
+     * @brief Thrown where a coroutine resumes (see xll::schedule, xll::sleep_for and xll::offload), once Excel has
+     * cancelled the calculation it belongs to.
+     */
+    class Canceled : public std::runtime_error
+    {
+    public:
+        Canceled() : std::runtime_error("The calculation was cancelled") {}
+    };
+
+    template<typename T>
+    class Task;
+
+    namespace impl
+    {
+        /**
+         * @brief The part of a Task's promise that does not depend on the result type.
+         *
+         * @details The generation refers to the call from Excel that the coroutine is part of. It is set on the
+         * outermost Task by the async thunk, and passed on to each Task it awaits, so that the executor can tell
+         * when the calculation has been cancelled.
+         */
+        struct TaskPromiseBase
+        {
+            std::coroutine_handle<> continuation {};
+            const uint64_t*         generation = nullptr;
+            std::exception_ptr      exception {};
+
+            struct FinalAwaiter
+            {
+                [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+                template<typename TPromise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) noexcept
+                {
+                    if (auto continuation = handle.promise().continuation) return continuation;
+                    return std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+
+            void unhandled_exception() noexcept { exception = std::current_exception(); }
+        };
+
+        template<typename T>
+        struct TaskPromise : TaskPromiseBase
+        {
+            std::optional<T> value {};
+
+            template<typename U>
+                requires std::convertible_to<U, T>
+            void return_value(U&& result)
+            {
+                value.emplace(std::forward<U>(result));
+            }
+
+            T result()
+            {
+                if (exception) std::rethrow_exception(exception);
+                return std::move(*value);
+            }
+        };
+
+        template<>
+        struct TaskPromise<void> : TaskPromiseBase
+        {
+            void return_void() const noexcept {}
+
+            void result() const
+            {
+                if (exception) std::rethrow_exception(exception);
+            }
+        };
+
+        /**
+         * @brief The generation of the call that the awaiting coroutine is part of, if it is a Task.
+         */
+        template<typename TPromise>
+        const uint64_t* generation_of(std::coroutine_handle<TPromise> handle)
+        {
+            if constexpr (std::derived_from<TPromise, TaskPromiseBase>)
+                return handle.promise().generation;
+            else
+                return nullptr;
+        }
+
+        /**
+         * @brief Suspends the awaiting coroutine, and has it resumed by a worker of the AsyncRuntime.
+         */
+        struct ScheduleAwaiter
+        {
+            std::optional<TimerQueue::clock::time_point> due {};
+            const uint64_t*                              generation = nullptr;
+
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+            template<typename TPromise>
+            void await_suspend(std::coroutine_handle<TPromise> handle)
+            {
+                auto& runtime = AsyncRuntime::instance();
+                if (const auto* awaiting = generation_of(handle)) generation = awaiting;
+
+                const auto resume = [handle] { handle.resume(); };
+                if (due)
+                    runtime.timers().schedule(*due, [&runtime, generation = generation, resume] { runtime.post(generation, resume); });
+                else
+                    runtime.post(generation, resume);
+            }
+
+            void await_resume() const
+            {
+                if (AsyncRuntime::instance().cancelled(generation)) throw Canceled();
+            }
+        };
+
+        template<typename TFunc>
+        struct OffloadAwaiter
+        {
+            using result_type = std::invoke_result_t<TFunc&>;
+            using storage     = std::conditional_t<std::is_void_v<result_type>, std::monostate, std::optional<result_type>>;
+
+            TFunc              func;
+            storage            result {};
+            std::exception_ptr exception {};
+            const uint64_t*    generation = nullptr;
+
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+            template<typename TPromise>
+            void await_suspend(std::coroutine_handle<TPromise> handle)
+            {
+                generation = generation_of(handle);
+                AsyncRuntime::instance().post(generation, [this, handle] {
+                    try {
+                        if constexpr (std::is_void_v<result_type>)
+                            std::invoke(func);
+                        else
+                            result.emplace(std::invoke(func));
+                    }
+                    catch (...) {
+                        exception = std::current_exception();
+                    }
+                    handle.resume();
+                });
+            }
+
+            result_type await_resume()
+            {
+                if (exception) std::rethrow_exception(exception);
+                if (AsyncRuntime::instance().cancelled(generation)) throw Canceled();
+                if constexpr (not std::is_void_v<result_type>) return std::move(*result);
+            }
+        };
+
+        template<typename T>
+        void bind_generation(Task<T>& task, const uint64_t* generation);
+    }    // namespace impl
+
+    /**
+     * @brief The result of a coroutine, which starts when it is awaited (or returned from an async UDF).
+     *
+     * @details An add-in function returning Task<T> is run as an asynchronous function by XLL_ASYNC_UDF: the
+     * coroutine is started on a worker of the library's executor, may co_await other Tasks, xll::schedule(),
+     * xll::sleep_for() and xll::offload(), and its result is handed to Excel with xlAsyncReturn when it finishes.
+     * No thread is held while a coroutine waits, so many cells can wait for timers or I/O at the same time.
+     *
+     * @tparam T The result type; for async UDFs, any type XLL_UDF can return.
+     */
+    template<typename T = void>
+    class [[nodiscard]] Task
+    {
+    public:
+        struct promise_type : impl::TaskPromise<T>
+        {
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> m_handle {};
+
+        explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+        template<typename U>
+        friend void impl::bind_generation(Task<U>& task, const uint64_t* generation);
+
+    public:
+        Task() = default;
+
+        Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other) {
+                if (m_handle) m_handle.destroy();
+                m_handle = std::exchange(other.m_handle, {});
+            }
+            return *this;
+        }
+
+        Task(const Task&)            = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task()
+        {
+            if (m_handle) m_handle.destroy();
+        }
+
+        [[nodiscard]] bool done() const { return m_handle && m_handle.done(); }
+
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+            template<typename TPromise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> awaiting) noexcept
+            {
+                handle.promise().continuation = awaiting;
+                if (handle.promise().generation == nullptr) handle.promise().generation = impl::generation_of(awaiting);
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().result(); }
+        };
+
+        /**
+         * @brief Starts the coroutine, and resumes the awaiting one with its result once it has finished.
+         */
+        Awaiter operator co_await() && noexcept { return Awaiter { m_handle }; }
+    };
+
+    /**
+     * @brief Continues the awaiting coroutine on a worker of the library's executor.
+     */
+    inline impl::ScheduleAwaiter schedule() { return {}; }
+
+    /**
+     * @brief Continues the awaiting coroutine on a worker once the time has come, without holding a thread.
+     */
+    inline impl::ScheduleAwaiter sleep_until(TimerQueue::clock::time_point due) { return { due }; }
+
+    template<typename TRep, typename TPeriod>
+    impl::ScheduleAwaiter sleep_for(std::chrono::duration<TRep, TPeriod> duration)
+    {
+        return sleep_until(TimerQueue::clock::now() + std::chrono::duration_cast<TimerQueue::clock::duration>(duration));
+    }
+
+    /**
+     * @brief Runs a blocking function (e.g. I/O) on a worker, and continues the awaiting coroutine with its result.
+     */
+    template<typename TFunc>
+    impl::OffloadAwaiter<std::decay_t<TFunc>> offload(TFunc&& func)
+    {
+        return { std::forward<TFunc>(func) };
+    }
+
+    namespace impl
+    {
+        template<typename T>
+        void bind_generation(Task<T>& task, const uint64_t* generation)
+        {
+            task.m_handle.promise().generation = generation;
+        }
+
+        /**
+         * @brief A coroutine that starts at once, and frees itself when it finishes.
+         */
+        struct Detached
+        {
+            struct promise_type
+            {
+                Detached            get_return_object() const noexcept { return {}; }
+                std::suspend_never  initial_suspend() const noexcept { return {}; }
+                std::suspend_never  final_suspend() const noexcept { return {}; }
+                void                return_void() const noexcept {}
+                [[noreturn]] void   unhandled_exception() const noexcept { std::terminate(); }
+            };
+        };
+
+        template<auto Func, typename T, typename... TArgs>
+        struct AsyncThunkImpl<Func, Task<T>, std::tuple<TArgs...>>
+        {
+            static_assert(not std::is_void_v<T>, "The Task of an asynchronous function must have a result");
+
+            static constexpr size_t arity = sizeof...(TArgs);
+
+            /**
+             * @brief Runs the coroutine to completion, and hands its result to Excel.
+             *
+             * @details The arguments are owned by this frame, so that the coroutine may refer to them (e.g. through
+             * a std::string_view parameter) until it finishes. The generation is kept here too, for all Tasks the
+             * coroutine awaits to refer to.
+             */
+            static Detached drive(AsyncHandle handle, uint64_t generation, std::tuple<async_arg_t<TArgs>...> owned)
+            {
+                auto&      runtime = AsyncRuntime::instance();
+                LPXLOPER12 result  = nullptr;
+
+                try {
+                    auto start       = schedule();
+                    start.generation = &generation;
+                    co_await start;
+
+                    auto task = std::apply(Func, owned);
+                    impl::bind_generation(task, &generation);
+                    result = UdfResult<std::remove_cvref_t<T>>::store(co_await std::move(task));
+                }
+                catch (const Canceled&) {
+                    result = nullptr;
+                }
+                catch (...) {
+                    result = udf_invoke([]() -> LPXLOPER12 { throw; });
+                }
+
+                runtime.finish(handle, generation, result);
+            }
+
+            /**
+             * @brief Copies the arguments, and starts the coroutine on the AsyncRuntime.
+             */
+            static void call(udf_arg_t<TArgs>... args, const AsyncHandle* handle) noexcept
+            {
+                auto& runtime = AsyncRuntime::instance();
+
+                const auto error = udf_invoke([&]() -> LPXLOPER12 {
+                    runtime.started();
+                    drive(*handle, runtime.generation(), std::tuple<async_arg_t<TArgs>...>(AsyncArg<std::remove_cvref_t<TArgs>>::own(args)...));
+                    return nullptr;
+                });
+
+                if (error != nullptr) runtime.complete(*handle, error);
+            }
+        };
+    }    // namespace impl
+}    // namespace xll
@@ -0,0 +1,137 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xll
+{
+    /**
+     * @brief A fixed number of worker threads serving a bounded queue of jobs.
+     *
+     * @details The workers are started by the first job, and stopped by shutdown(), after which the next job
+     * starts them again. Jobs that are queued when the pool shuts down are still run. A job is refused when the
+     * queue is full, so the caller can decide what to do instead (e.g. run it itself) rather than piling up work
+     * that Excel may cancel anyway.
+     */
+    class ThreadPool
+    {
+        using Job = std::function<void()>;
+
+        std::vector<std::thread> m_workers {};
+        std::deque<Job>          m_queue {};
+        mutable std::mutex       m_mutex;
+        std::condition_variable  m_ready;
+        size_t                   m_threads;
+        size_t                   m_capacity;
+        bool                     m_stopping = false;
+
+        void work()
+        {
+            while (true) {
+                Job job;
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_ready.wait(lock, [&] { return m_stopping || not m_queue.empty(); });
+                    if (m_queue.empty()) return;
+                    job = std::move(m_queue.front());
+                    m_queue.pop_front();
+                }
+                job();
+            }
+        }
+
+    public:
+        static size_t default_threads() { return std::max(2U, std::thread::hardware_concurrency()); }
+
+        /**
+         * @param threads The number of worker threads.
+         * @param capacity The maximum number of jobs waiting for a worker.
+         */
+        explicit ThreadPool(size_t threads = default_threads(), size_t capacity = 4096)
+            : m_threads(std::max<size_t>(threads, 1)),
+              m_capacity(std::max<size_t>(capacity, 1))
+        {}
+
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool() { shutdown(); }
+
+        /**
+         * @brief Queues a job, starting the workers if needed.
+         *
+         * @return False if the queue is full (or the pool is shutting down), in which case the job is not run.
+         */
+        bool try_submit(Job job)
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                if (m_stopping || m_queue.size() >= m_capacity) return false;
+                if (m_workers.empty())
+                    for (size_t i = 0; i < m_threads; ++i) m_workers.emplace_back([this] { work(); });
+                m_queue.push_back(std::move(job));
+            }
+            m_ready.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief Waits for the queued and running jobs to finish, and stops the workers.
+         */
+        void shutdown()
+        {
+            std::vector<std::thread> workers;
+            {
+                std::lock_guard lock(m_mutex);
+                m_stopping = true;
+                workers    = std::move(m_workers);
+                m_workers.clear();
+            }
+            m_ready.notify_all();
+            for (auto& worker : workers)
+                if (worker.joinable()) worker.join();
+
+            std::lock_guard lock(m_mutex);
+            m_stopping = false;
+        }
+
+        /**
+         * @brief Changes the number of workers and the capacity of the queue; the pool is shut down first.
+         */
+        void configure(size_t threads, size_t capacity)
+        {
+            shutdown();
+            std::lock_guard lock(m_mutex);
+            m_threads  = std::max<size_t>(threads, 1);
+            m_capacity = std::max<size_t>(capacity, 1);
+        }
+
+        [[nodiscard]] size_t threads() const
+        {
+            std::lock_guard lock(m_mutex);
+            return m_threads;
+        }
+
+        [[nodiscard]] size_t capacity() const
+        {
+            std::lock_guard lock(m_mutex);
+            return m_capacity;
+        }
+
+        [[nodiscard]] size_t queued() const
+        {
+            std::lock_guard lock(m_mutex);
+            return m_queue.size();
+        }
+    };
+}    // namespace xll
@@ -0,0 +1,120 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace xll
+{
+    /**
+     * @brief Runs callbacks at given points in time, on a single thread that is started by the first timer.
+     *
+     * @details Callbacks should be short; they are meant to hand the actual work to a ThreadPool. Timers are
+     * ordered by their due time, and timers due at the same time in the order they were added.
+     */
+    class TimerQueue
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+    private:
+        struct Timer
+        {
+            clock::time_point     due;
+            uint64_t              sequence;
+            std::function<void()> callback;
+
+            bool operator>(const Timer& other) const { return due != other.due ? due > other.due : sequence > other.sequence; }
+        };
+
+        std::priority_queue<Timer, std::vector<Timer>, std::greater<>> m_timers {};
+        std::thread                                                    m_thread {};
+        mutable std::mutex                                             m_mutex;
+        std::condition_variable                                        m_changed;
+        uint64_t                                                       m_sequence = 0;
+        bool                                                           m_stopping = false;
+
+        void work()
+        {
+            std::unique_lock lock(m_mutex);
+            while (not m_stopping) {
+                if (m_timers.empty()) {
+                    m_changed.wait(lock);
+                    continue;
+                }
+
+                if (const auto due = m_timers.top().due; clock::now() < due) {
+                    m_changed.wait_until(lock, due);
+                    continue;
+                }
+
+                auto callback = std::move(const_cast<Timer&>(m_timers.top()).callback);
+                m_timers.pop();
+                lock.unlock();
+                callback();
+                lock.lock();
+            }
+        }
+
+    public:
+        TimerQueue() = default;
+
+        TimerQueue(const TimerQueue&)            = delete;
+        TimerQueue& operator=(const TimerQueue&) = delete;
+
+        ~TimerQueue() { shutdown(); }
+
+        /**
+         * @brief Runs the callback at the given time. Timers added while shutting down are run by shutdown().
+         */
+        void schedule(clock::time_point due, std::function<void()> callback)
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                if (not m_stopping && not m_thread.joinable()) m_thread = std::thread([this] { work(); });
+                m_timers.push({ due, m_sequence++, std::move(callback) });
+            }
+            m_changed.notify_one();
+        }
+
+        /**
+         * @brief Stops the thread, and runs the callbacks of the remaining timers at once, on the calling thread.
+         */
+        void shutdown()
+        {
+            std::thread thread;
+            {
+                std::lock_guard lock(m_mutex);
+                m_stopping = true;
+                thread     = std::move(m_thread);
+            }
+            m_changed.notify_all();
+            if (thread.joinable()) thread.join();
+
+            std::unique_lock lock(m_mutex);
+            while (not m_timers.empty()) {
+                auto callback = std::move(const_cast<Timer&>(m_timers.top()).callback);
+                m_timers.pop();
+                lock.unlock();
+                callback();
+                lock.lock();
+            }
+            m_stopping = false;
+        }
+
+        [[nodiscard]] size_t pending() const
+        {
+            std::lock_guard lock(m_mutex);
+            return m_timers.size();
+        }
+    };
+}    // namespace xll
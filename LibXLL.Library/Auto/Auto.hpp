@@ -41,14 +41,22 @@
 
 #pragma once
 
+#include "../Utils/Arena.hpp"
+#include "../Utils/BufferPool.hpp"
 #include "../Utils/Concepts.hpp"
+#include "../Utils/Memo.hpp"
+#include "../Utils/MemoryManager.hpp"
+#include "../Utils/Profiler.hpp"
 #include <Macros/Defines.hpp>
 #include <Register/Registry.hpp>
 #include <functional>
 #include <tl/expected.hpp>
 #include "../xlFunctions/Register.hpp"
 
+#include <Register/Events.hpp>
 #include <Register/Function.hpp>
+#include <Register/Payload.hpp>
+#include <Register/Udf.hpp>
 
 namespace xll
 {
@@ -211,64 +219,131 @@ namespace xll
     using OnRemove = Auto<Remove>;
     using OnFree = Auto<Free>;
 
+    namespace impl
+    {
+        // The buffers cached for reuse by Arrays, and the results of memoised functions, are released when the
+        // add-in is closed.
+        inline const Auto<Close> bufferPoolTrim([] { BufferPool::instance().trim(); });
+        inline const Auto<Close> memoClear([] { MemoCache::clear_all(); });
+    }    // namespace impl
+
     template<typename TEvent, typename TFunc>
     int xlAuto(const std::string& funcName, TFunc&& func)
     {
-        try {
-            xll::Registry::instance().register_all();
-            xll::Auto<TEvent>::template Execute<typename xll::Auto<TEvent>::BeforeTag>();
+        auto& profiler = xll::Profiler::instance();
+        int   result   = XLL_SUCCESS;
 
-            func();
+        try {
+            profiler.measure("Registry::register_all", [] { xll::Registry::instance().register_all(); });
+            profiler.measure([&] { return funcName + " Before"; },
+                             [] { xll::Auto<TEvent>::template Execute<typename xll::Auto<TEvent>::BeforeTag>(); });
+
+            profiler.measure(funcName, [&] {
+                func();
+                xll::Auto<TEvent>::Execute();
+            });
             // if (!Auto<Add>::Call()) {
             //     return FALSE;
             // }
 
-            xll::Auto<TEvent>::template Execute<typename xll::Auto<TEvent>::AfterTag>();
+            profiler.measure([&] { return funcName + " After"; },
+                             [] { xll::Auto<TEvent>::template Execute<typename xll::Auto<TEvent>::AfterTag>(); });
         }
         catch (const std::exception& ex) {
             xll::Auto<TEvent>::HandleError(ex.what());
-            return XLL_FAILURE;
+            result = XLL_FAILURE;
         }
         catch (...) {
             xll::Auto<TEvent>::HandleError(std::format("Unknown error in {}", funcName));
-            return XLL_FAILURE;
+            result = XLL_FAILURE;
         }
 
-        return XLL_SUCCESS;
+        profiler.write();
+        return result;
     }
 
+    /**
+     * @brief Hands the result to Excel with xlbitDLLFree, for xlAutoFree12 to release it once Excel is done with it.
+     *
+     * @details The result is recorded in the MemoryManager along with its type, so that xlAutoFree12 releases it
+     * as exactly that type. A pointer or std::unique_ptr is taken over as is, and must have been created with new;
+     * other values are moved into a new object. Moving takes constant time for all library types, as only the
+     * XLOPER12 itself is copied and its buffers (cells, strings) are taken over, so a result should be passed as a
+     * temporary or with std::move (e.g. `return std::move(result) | xll::AutoFree();`). An lvalue is copied.
+     */
     inline auto AutoFree()
     {
         return []<typename T>(T&& arg) {
+            auto& manager = MemoryManager::Instance();
+
             if constexpr (std::is_pointer_v<std::remove_reference_t<T>>) {
-                arg->xltype |= xlbitDLLFree;
-                return arg;
+                using U  = std::remove_pointer_t<std::remove_reference_t<T>>;
+                auto ptr = manager.adopt(std::unique_ptr<U>(arg));
+                ptr->xltype |= xlbitDLLFree;
+                return ptr;
             }
             else if constexpr (is_unique_ptr<std::remove_reference_t<T>>) {
-                arg->xltype |= xlbitDLLFree;
-                return arg.release();
+                auto ptr = manager.adopt(std::move(arg));
+                ptr->xltype |= xlbitDLLFree;
+                return ptr;
             }
             else if constexpr (not std::same_as<std::remove_reference_t<T>, xll::Function>) {
                 using U  = std::decay_t<T>;
-                auto ptr = std::make_unique<U>(std::forward<T>(arg));
+                auto ptr = manager.adopt(std::make_unique<U>(std::forward<T>(arg)));
                 ptr->xltype |= xlbitDLLFree;
-                return ptr.release();
+                return ptr;
             }
 
             throw std::runtime_error("AutoFree: Cannot free this type");
         };
     }
+
+    /**
+     * @brief Alternative to AutoFree() that returns the result from a per-thread slot, without allocating.
+     *
+     * @details The value is moved into a thread_local slot of its type, and a pointer to the slot is returned
+     * without xlbitDLLFree, so that Excel does not call xlAutoFree12. Excel copies the result before it calls
+     * another function on the same thread, so the slot can be reused by the next call, which also releases what
+     * the previous result owned (e.g. the cells of an Array). This is safe for thread-safe ($) functions, as each
+     * of Excel's calculation threads has its own slots. Scalar results (Number, Bool, Int, Error) are returned
+     * with no heap allocation at all.
+     */
+    inline auto ThreadLocal()
+    {
+        return []<typename T>(T&& arg) -> std::remove_cvref_t<T>*
+            requires std::derived_from<std::remove_cvref_t<T>, XLOPER12>
+        {
+            using U = std::remove_cvref_t<T>;
+            return static_cast<U*>(impl::UdfResult<U>::store(std::forward<T>(arg)));
+        };
+    }
+
+    /**
+     * @brief Opt-in alternative to AutoFree() that packs the result into a single contiguous block.
+     *
+     * @details The returned XLOPER12, its cells and all string payloads share one allocation (see xll::Arena),
+     * which xlAutoFree12 releases in a single operation. This is intended for large array results, in
+     * particular arrays of strings. An xll::ArenaArray (passed with std::move) is handed over as is; it is the
+     * way to build such a result without allocating each string. Any other value is copied into a new block.
+     */
+    inline auto ArenaFree()
+    {
+        return []<typename T>(T&& arg) -> LPXLOPER12
+            requires std::derived_from<std::remove_cvref_t<T>, XLOPER12> || std::same_as<T, ArenaArray>
+        {
+            if constexpr (std::same_as<T, ArenaArray>)
+                return std::move(arg).release();
+            else
+                return Arena::instance().pack(arg);
+        };
+    }
 }    // namespace xll
 
 extern "C" inline XLL_EXPORTS int XLLAPI xlAutoOpen()
 {
     return xll::xlAuto<xll::Open>("xlAutoOpen", [] {
-        for (const auto& fn : xll::Function::functionArgs) {
-            xll::Variant<xll::Nil, xll::Number> id = xll::Register(xll::impl::All(fn));
-            if (not holds_alternative<xll::Number>(id)) {
-                throw std::runtime_error(std::format("[xlAutoOpen]: Failed to register function {}", fn.functionName.to_string()));
-            }
-        }
+        xll::impl::RegistrationPayload::instance().register_all(xll::Function::functionArgs);
+        xll::Profiler::instance().measure("xlEventRegister", [] { xll::impl::EventRegistry::instance().register_all(); });
     });
 }
 
@@ -276,6 +351,79 @@ extern "C" inline XLL_EXPORTS int XLLAPI xlAutoOpen()
 #pragma comment(linker, "/INCLUDE:xlAutoOpen")
 #endif
 
+namespace xll::impl
+{
+    /**
+     * @brief The profiler report as a table with a header row: step, milliseconds, allocations and status.
+     */
+    inline Array<Variant<Nil, String, Number>> profile_table()
+    {
+        const auto& profiler = Profiler::instance();
+        if (not profiler.enabled()) {
+            auto result = Array<Variant<Nil, String, Number>>(1, 1);
+            result[0]   = String("Profiling is off; set XLL_PROFILE or call xll::Profiler::instance().enable()");
+            return result;
+        }
+
+        using ms         = std::chrono::duration<double, std::milli>;
+        const auto steps = profiler.steps();
+        auto       table = Array<Variant<Nil, String, Number>>(steps.size() + 1, 4);
+
+        table[0, 0] = String("Step");
+        table[0, 1] = String("Milliseconds");
+        table[0, 2] = String("Allocations");
+        table[0, 3] = String("Status");
+        for (size_t i = 0; i < steps.size(); ++i) {
+            const auto& step = steps[i];
+            table[i + 1, 0]  = String(std::string(2 * step.depth, ' ') + step.name);
+            table[i + 1, 1]  = Number(ms(step.elapsed).count());
+            if (profiler_counts_allocations)
+                table[i + 1, 2] = Number(static_cast<double>(step.allocations));
+            else
+                table[i + 1, 2] = String("n/a");
+            table[i + 1, 3]  = String(step.failed ? "Failed: " + step.error : "OK");
+        }
+
+        return table;
+    }
+}    // namespace xll::impl
+
+#ifdef XLL_PROFILE_FUNCTION
+extern "C" inline XLL_EXPORTS LPXLOPER12 XLLAPI xllProfile()
+{
+    return xll::impl::Thunk<xll::impl::profile_table>::call();
+}
+
+#ifdef _MSC_VER
+#pragma comment(linker, "/INCLUDE:xllProfile")
+#endif
+
+namespace xll::impl
+{
+    /**
+     * @brief Registers the hidden diagnostic function =<PREFIX>.XLL.PROFILE(), which returns the profiler report.
+     * <PREFIX> is the name of the add-in, as given by get_module_prefix().
+     */
+    struct ProfileFunction
+    {
+        void Register() const
+        {
+            using namespace xll::literals;
+
+            Function(String(get_module_prefix() + ".XLL.PROFILE"))
+                .Procedure("xllProfile"_xs)
+                .Signature<xllProfile, "!">()
+                .Hidden()
+                .Description("The startup profile of the add-in"_xs)
+                .Register();
+        }
+    };
+
+    inline ProfileFunction profileFunction {};
+    inline const bool      profileFunctionAdded = (Registry::instance().add(profileFunction), true);
+}    // namespace xll::impl
+#endif
+
 extern "C" inline XLL_EXPORTS int XLLAPI xlAutoClose()
 {
     return xll::xlAuto<xll::Close>("xlAutoClose", []{});
@@ -337,36 +485,39 @@ extern "C" inline XLL_EXPORTS void XLLAPI xlAutoFree12(LPXLOPER12 px)
     xll::Registry::instance().register_all();
     xll::Auto<xll::Free>::Execute<xll::Auto<xll::Free>::BeforeTag>();
 
-    if (not px->xltype & xlbitDLLFree) return;
-
-    px->xltype &= ~xlbitDLLFree;
-    switch (px->xltype) {
-        case xltypeMulti:
-            delete reinterpret_cast<xll::Array<xll::Variant<xll::Nil, xll::String, xll::Int, xll::Number>>*>(px);
-        break;
-        case xltypeBool:
-            delete reinterpret_cast<xll::Bool*>(px);
-        break;
-        case xltypeErr:
-            delete reinterpret_cast<xll::Error*>(px);
-        break;
-        case xltypeInt:
-            delete reinterpret_cast<xll::Int*>(px);
-        break;
-        case xltypeMissing:
-            delete reinterpret_cast<xll::Missing*>(px);
-        break;
-        case xltypeNil:
-            delete reinterpret_cast<xll::Nil*>(px);
-        break;
-        case xltypeNum:
-            delete reinterpret_cast<xll::Number*>(px);
-        break;
-        case xltypeStr:
-            delete reinterpret_cast<xll::String*>(px);
-        break;
-        default:
-            break;
+    // Results returned by xll::AutoFree() are released as the type they were created as, and results packed by
+    // xll::ArenaFree() as a single block.
+    if (not xll::MemoryManager::Instance().erase(px) && not xll::Arena::instance().release(px) && (px->xltype & xlbitDLLFree)) {
+        // Values flagged by other means are assumed to be the library's default types.
+        px->xltype &= ~xlbitDLLFree;
+        switch (px->xltype) {
+            case xltypeMulti:
+                delete reinterpret_cast<xll::Array<xll::Variant<xll::Nil, xll::String, xll::Int, xll::Number>>*>(px);
+                break;
+            case xltypeBool:
+                delete reinterpret_cast<xll::Bool*>(px);
+                break;
+            case xltypeErr:
+                delete reinterpret_cast<xll::Error*>(px);
+                break;
+            case xltypeInt:
+                delete reinterpret_cast<xll::Int*>(px);
+                break;
+            case xltypeMissing:
+                delete reinterpret_cast<xll::Missing*>(px);
+                break;
+            case xltypeNil:
+                delete reinterpret_cast<xll::Nil*>(px);
+                break;
+            case xltypeNum:
+                delete reinterpret_cast<xll::Number*>(px);
+                break;
+            case xltypeStr:
+                delete reinterpret_cast<xll::String*>(px);
+                break;
+            default:
+                break;
+        }
     }
 
     xll::Auto<xll::Free>::Execute<xll::Auto<xll::Free>::AfterTag>();
@@ -18,6 +18,9 @@
 
 #include "xlcall.h"
 
+#include <stdarg.h>
+#include <stddef.h>
+
 /*
 ** Excel 12 entry points backwards compatible with Excel 11
 **
@@ -32,11 +35,12 @@
 typedef int (*EXCEL12PROC) (int xlfn, int coper, LPXLOPER12 *rgpxloper12, LPXLOPER12 xloper12Res);
 
 // inline HMODULE hmodule;
-// inline EXCEL12PROC pexcel12;
+inline EXCEL12PROC pexcel12 = NULL;
 
 inline __attribute__((used)) void FetchExcel12EntryPt(void)
 {
-	// Stub for compiling on Linux.
+	// There is no Excel process to query on Linux. The entry point can only
+	// be provided by a host (e.g. xll::mock::ExcelHost) via SetExcel12EntryPt.
 }
 
 /*
@@ -49,6 +53,9 @@ inline __attribute__((used)) void FetchExcel12EntryPt(void)
 **
 ** First try to fetch the known good entry point,
 ** then set the passed in address.
+**
+** On Linux there is no known good entry point, so the passed in address
+** always replaces the current one. Passing NULL detaches the host.
 */
 #ifdef __cplusplus
 extern "C"
@@ -56,17 +63,55 @@ extern "C"
 __attribute__((dllexport))
 inline __attribute__((used)) void SetExcel12EntryPt(EXCEL12PROC pexcel12New)
 {
-	// Stub for compiling on Linux.
+	FetchExcel12EntryPt();
+	pexcel12 = pexcel12New;
 }
 
 inline __attribute__((used)) int Excel12(int xlfn, LPXLOPER12 operRes, int count, ...)
 {
-	// Stub for compiling on Linux.
-	return 0;
+
+	LPXLOPER12 rgxloper12[cxloper12Max];
+	va_list ap;
+	int ioper;
+	int mdRet;
+
+	FetchExcel12EntryPt();
+	if (pexcel12 == NULL)
+	{
+		mdRet = xlretFailed;
+	}
+	else
+	{
+		mdRet = xlretInvCount;
+		if ((count >= 0)  && (count <= cxloper12Max))
+		{
+			va_start(ap, count);
+			for (ioper = 0; ioper < count ; ioper++)
+			{
+				rgxloper12[ioper] = va_arg(ap, LPXLOPER12);
+			}
+			va_end(ap);
+			mdRet = (pexcel12)(xlfn, count, &rgxloper12[0], operRes);
+		}
+	}
+	return(mdRet);
+
 }
 
 inline __attribute__((used)) int Excel12v(int xlfn, LPXLOPER12 operRes, int count, LPXLOPER12 opers[])
 {
-	// Stub for compiling on Linux.
-	return 0;
+
+	int mdRet;
+
+	FetchExcel12EntryPt();
+	if (pexcel12 == NULL)
+	{
+		mdRet = xlretFailed;
+	}
+	else
+	{
+		mdRet = (pexcel12)(xlfn, count, &opers[0], operRes);
+	}
+	return(mdRet);
+
 }
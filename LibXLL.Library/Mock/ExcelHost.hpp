@@ -0,0 +1,752 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "../Auto/Auto.hpp"
+#include "../Types/String.hpp"
+#include <xlcall.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace xll::mock
+{
+    /**
+     * @brief An in-process stand-in for Excel, installed behind SetExcel12EntryPt.
+     *
+     * The ExcelHost implements the subset of the C API used by the library (xlCoerce, xlFree,
+     * xlfRegister, xlGetName, xlfGetWorkspace, xlcAlert, xlAsyncReturn and xlEventRegister), so
+     * that the add-in lifecycle and every callback round-trip can be exercised off Windows. Memory returned to the add-in
+     * is owned by the host until it is handed back through xlFree, and results returned by
+     * the add-in are released according to their xlbitXLFree/xlbitDLLFree bits, as Excel would.
+     *
+     * Additional functions can be plugged in (or the built-in ones overridden) using on().
+     *
+     * @note The host is a process-wide singleton, as the entry point is a plain function pointer.
+     */
+    class ExcelHost
+    {
+    public:
+        using Handler = std::function<int(std::span<LPXLOPER12 const> args, LPXLOPER12 result)>;
+
+        /**
+         * @brief A single xlfRegister call, with the arguments decoded to UTF-8.
+         */
+        struct Registration
+        {
+            double                   id = 0.0;
+            std::string              moduleText;
+            std::string              procedure;
+            std::string              typeText;
+            std::string              functionText;
+            std::string              argumentText;
+            int                      macroType = 1;
+            std::string              category;
+            std::string              shortcutText;
+            std::string              helpTopic;
+            std::string              functionHelp;
+            std::vector<std::string> argumentHelp;
+        };
+
+        /**
+         * @brief A result handed back with xlAsyncReturn, decoded.
+         */
+        struct AsyncResult
+        {
+            uint32_t    xltype = 0;
+            double      number = 0.0;    // xltypeNum, xltypeInt and xltypeBool
+            int         error  = 0;
+            std::string text;
+            size_t      rows    = 0;
+            size_t      columns = 0;
+        };
+
+        /**
+         * @brief A single xlEventRegister call.
+         */
+        struct EventRegistration
+        {
+            std::string procedure;
+            int         event = 0;
+        };
+
+        /**
+         * @brief A single xlcAlert call.
+         */
+        struct Alert
+        {
+            std::string message;
+            int         type = 2;
+        };
+
+        ExcelHost(const ExcelHost&)            = delete;
+        ExcelHost& operator=(const ExcelHost&) = delete;
+
+        static ExcelHost& instance()
+        {
+            static ExcelHost host;
+            return host;
+        }
+
+        /**
+         * @brief Makes the host the target of Excel12/Excel12v.
+         */
+        void install() { SetExcel12EntryPt(&ExcelHost::callback); }
+
+        /**
+         * @brief Detaches the host; Excel12/Excel12v return xlretFailed afterwards.
+         */
+        void uninstall() { SetExcel12EntryPt(nullptr); }
+
+        /**
+         * @brief Clears all recorded state (registrations, alerts, call counters and handlers).
+         *
+         * Memory still owned by the add-in is not touched; live_allocations() keeps reporting it.
+         */
+        void reset()
+        {
+            const std::lock_guard lock(m_mutex);
+            m_registrations.clear();
+            m_alerts.clear();
+            m_calls.clear();
+            m_handlers.clear();
+            m_events.clear();
+            m_async.clear();
+            m_asyncReturned = 0;
+            m_name       = "mock.xll";
+            m_strayFrees = 0;
+            m_nextId     = 1.0;
+        }
+
+        void set_name(std::string name)
+        {
+            const std::lock_guard lock(m_mutex);
+            m_name = std::move(name);
+        }
+
+        /**
+         * @brief Installs a handler for the given function number, replacing any built-in behaviour.
+         */
+        void on(int xlfn, Handler handler)
+        {
+            const std::lock_guard lock(m_mutex);
+            m_handlers[xlfn] = std::move(handler);
+        }
+
+        [[nodiscard]]
+        size_t calls(int xlfn) const
+        {
+            const std::lock_guard lock(m_mutex);
+            auto                  it = m_calls.find(xlfn);
+            return it == m_calls.end() ? 0 : it->second;
+        }
+
+        [[nodiscard]]
+        size_t total_calls() const
+        {
+            const std::lock_guard lock(m_mutex);
+            size_t                total = 0;
+            for (const auto& [_, count] : m_calls) total += count;
+            return total;
+        }
+
+        /**
+         * @brief The number of host-allocated buffers that have not yet been passed to xlFree.
+         */
+        [[nodiscard]]
+        size_t live_allocations() const
+        {
+            const std::lock_guard lock(m_mutex);
+            return m_allocations.size();
+        }
+
+        /**
+         * @brief The number of xlFree calls on string or array memory the host did not allocate.
+         */
+        [[nodiscard]]
+        size_t stray_frees() const
+        {
+            const std::lock_guard lock(m_mutex);
+            return m_strayFrees;
+        }
+
+        [[nodiscard]]
+        std::vector<Registration> registrations() const
+        {
+            const std::lock_guard lock(m_mutex);
+            return m_registrations;
+        }
+
+        [[nodiscard]]
+        std::vector<Alert> alerts() const
+        {
+            const std::lock_guard lock(m_mutex);
+            return m_alerts;
+        }
+
+        [[nodiscard]]
+        std::vector<EventRegistration> events() const
+        {
+            const std::lock_guard lock(m_mutex);
+            return m_events;
+        }
+
+        /**
+         * @brief Issues the handle for a call to an asynchronous function, as Excel does for an "X" parameter.
+         */
+        XLOPER12 async_handle()
+        {
+            const std::lock_guard lock(m_mutex);
+            XLOPER12              handle {};
+            handle.xltype              = xltypeBigData;
+            handle.val.bigdata.h.hdata = reinterpret_cast<void*>(++m_nextHandle);
+            m_async[handle.val.bigdata.h.hdata];
+            return handle;
+        }
+
+        /**
+         * @brief The result returned for the handle, if any.
+         */
+        [[nodiscard]]
+        std::optional<AsyncResult> async_result(const XLOPER12& handle) const
+        {
+            const std::lock_guard lock(m_mutex);
+            auto                  it = m_async.find(handle.val.bigdata.h.hdata);
+            return it == m_async.end() ? std::nullopt : it->second;
+        }
+
+        /**
+         * @brief The number of results returned with xlAsyncReturn since the last reset().
+         */
+        [[nodiscard]]
+        size_t async_returned() const
+        {
+            const std::lock_guard lock(m_mutex);
+            return m_asyncReturned;
+        }
+
+        /**
+         * @brief Waits until at least `count` results have been returned since the last reset().
+         *
+         * @return False if the timeout expired first.
+         */
+        bool wait_async(size_t count, std::chrono::milliseconds timeout)
+        {
+            std::unique_lock lock(m_mutex);
+            return m_asyncDone.wait_for(lock, timeout, [&] { return m_asyncReturned >= count; });
+        }
+
+        /**
+         * @brief Cancels the calculation: the pending handles are abandoned, and xlAsyncReturn fails for them.
+         *
+         * @return The procedures registered for xleventCalculationCanceled, which the caller should run, as the
+         * host can't look up exported functions by name.
+         */
+        std::vector<std::string> cancel_calculation()
+        {
+            const std::lock_guard lock(m_mutex);
+            std::erase_if(m_async, [](const auto& entry) { return not entry.second.has_value(); });
+
+            std::vector<std::string> procedures;
+            for (const auto& event : m_events)
+                if (event.event == xleventCalculationCanceled) procedures.push_back(event.procedure);
+            return procedures;
+        }
+
+        /**
+         * @brief Loads the add-in, i.e. calls xlAutoOpen as Excel would.
+         */
+        int open() { return xlAutoOpen(); }
+
+        /**
+         * @brief Unloads the add-in, i.e. calls xlAutoClose as Excel would.
+         */
+        int close() { return xlAutoClose(); }
+
+        /**
+         * @brief Disposes of a value returned by a worksheet function, as Excel does once it has copied it.
+         *
+         * Values flagged with xlbitDLLFree are passed back to the add-in through xlAutoFree12, values
+         * flagged with xlbitXLFree are freed by the host, and all other values are left untouched.
+         *
+         * @param result The pointer returned by the worksheet function.
+         */
+        void release(LPXLOPER12 result)
+        {
+            if (result == nullptr) return;
+
+            if (result->xltype & xlbitDLLFree) {
+                xlAutoFree12(result);
+                return;
+            }
+
+            if (result->xltype & xlbitXLFree) {
+                result->xltype &= ~xlbitXLFree;
+                const std::lock_guard lock(m_mutex);
+                free_oper(*result);
+            }
+        }
+
+    private:
+        ExcelHost() = default;
+
+        ~ExcelHost()
+        {
+            for (auto* ptr : m_allocations) ::operator delete(ptr);
+        }
+
+        static int callback(int xlfn, int coper, LPXLOPER12* rgpxloper12, LPXLOPER12 xloper12Res)
+        {
+            if (coper < 0) return xlretInvCount;
+            return instance().dispatch(xlfn, std::span<LPXLOPER12 const>(rgpxloper12, static_cast<size_t>(coper)), xloper12Res);
+        }
+
+        int dispatch(int xlfn, std::span<LPXLOPER12 const> args, LPXLOPER12 result)
+        {
+            Handler handler;
+            {
+                const std::lock_guard lock(m_mutex);
+                ++m_calls[xlfn];
+                if (auto it = m_handlers.find(xlfn); it != m_handlers.end()) handler = it->second;
+            }
+            if (handler) return handler(args, result);
+
+            const std::lock_guard lock(m_mutex);
+            switch (xlfn) {
+                case xlCoerce:
+                    return do_coerce(args, result);
+                case xlFree:
+                    return do_free(args);
+                case xlfRegister:
+                    return do_register(args, result);
+                case xlGetName:
+                    return do_get_name(result);
+                case xlfGetWorkspace:
+                    return do_get_workspace(args, result);
+                case xlcAlert:
+                    return do_alert(args, result);
+                case xlAsyncReturn:
+                    return do_async_return(args, result);
+                case xlEventRegister:
+                    return do_event_register(args, result);
+                default:
+                    return xlretInvXlfn;
+            }
+        }
+
+        // ===== Host-owned memory
+
+        XCHAR* make_string(std::string_view text)
+        {
+            const auto source = xll::String(text);
+            const auto length = static_cast<size_t>(source.val.str[0]);
+
+            auto* buffer = static_cast<XCHAR*>(::operator new((length + 2) * sizeof(XCHAR)));
+            std::copy_n(source.val.str, length + 1, buffer);
+            buffer[length + 1] = 0;
+            m_allocations.insert(buffer);
+            return buffer;
+        }
+
+        LPXLOPER12 make_multi(size_t rows, size_t cols)
+        {
+            auto* buffer = static_cast<LPXLOPER12>(::operator new(rows * cols * sizeof(XLOPER12)));
+            std::fill_n(buffer, rows * cols, XLOPER12 {});
+            for (size_t i = 0; i < rows * cols; ++i) buffer[i].xltype = xltypeNil;
+            m_allocations.insert(buffer);
+            return buffer;
+        }
+
+        void free_oper(XLOPER12& oper)
+        {
+            switch (oper.xltype & ~(xlbitXLFree | xlbitDLLFree)) {
+                case xltypeStr:
+                    release_buffer(oper.val.str);
+                    break;
+                case xltypeMulti:
+                    if (not m_allocations.contains(oper.val.array.lparray)) {
+                        if (oper.val.array.lparray != nullptr) ++m_strayFrees;
+                        break;
+                    }
+                    for (size_t i = 0; i < static_cast<size_t>(oper.val.array.rows) * oper.val.array.columns; ++i)
+                        free_oper(oper.val.array.lparray[i]);
+                    release_buffer(oper.val.array.lparray);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        void release_buffer(void* ptr)
+        {
+            if (ptr == nullptr) return;
+            if (m_allocations.erase(ptr) == 0) {
+                ++m_strayFrees;
+                return;
+            }
+            ::operator delete(ptr);
+        }
+
+        // ===== Helpers for decoding arguments
+
+        static std::string text(const XLOPER12* oper)
+        {
+            if (oper == nullptr) return {};
+            switch (oper->xltype & ~(xlbitXLFree | xlbitDLLFree)) {
+                case xltypeStr:
+                    return oper->val.str == nullptr ? std::string() : xll::String(*oper).to_string();
+                case xltypeNum:
+                    return std::format("{}", oper->val.num);
+                case xltypeInt:
+                    return std::format("{}", oper->val.w);
+                case xltypeBool:
+                    return oper->val.xbool ? "TRUE" : "FALSE";
+                default:
+                    return {};
+            }
+        }
+
+        static std::optional<int> integer(const XLOPER12* oper)
+        {
+            if (oper == nullptr) return std::nullopt;
+            switch (oper->xltype & ~(xlbitXLFree | xlbitDLLFree)) {
+                case xltypeInt:
+                    return oper->val.w;
+                case xltypeNum:
+                    return static_cast<int>(oper->val.num);
+                case xltypeBool:
+                    return oper->val.xbool ? 1 : 0;
+                default:
+                    return std::nullopt;
+            }
+        }
+
+        // ===== Built-in functions
+
+        /*
+         * Coercion follows the order Excel uses when several destination types are allowed:
+         * the source type is kept if it is acceptable; otherwise numbers, strings, booleans,
+         * errors, arrays and integers are tried in that order.
+         */
+        int do_coerce(std::span<LPXLOPER12 const> args, LPXLOPER12 result)
+        {
+            if (args.empty() || result == nullptr) return xlretInvCount;
+
+            const XLOPER12& src      = *args[0];
+            const auto      srcType  = src.xltype & ~(xlbitXLFree | xlbitDLLFree);
+            const auto      destType = args.size() > 1 ? integer(args[1]).value_or(0) : 0;
+
+            if (srcType == xltypeRef || srcType == xltypeSRef) return xlretUncalced;
+
+            // Without a destination type (or when the source type is acceptable), the value is copied as-is.
+            if (destType == 0 || (srcType & static_cast<unsigned>(destType))) return copy_oper(src, *result);
+
+            // Arrays are coerced through their top-left element.
+            if (srcType == xltypeMulti) {
+                if (src.val.array.rows * src.val.array.columns == 0) return xlretFailed;
+                auto first = src.val.array.lparray[0];
+                auto arg   = std::array<LPXLOPER12, 2> { &first, args[1] };
+                return do_coerce(arg, result);
+            }
+
+            for (auto type : { xltypeNum, xltypeStr, xltypeBool, xltypeErr, xltypeMulti, xltypeInt }) {
+                if (not(destType & type)) continue;
+                if (convert(src, type, *result) == xlretSuccess) return xlretSuccess;
+            }
+
+            return xlretFailed;
+        }
+
+        int convert(const XLOPER12& src, unsigned type, XLOPER12& result)
+        {
+            const auto srcType = src.xltype & ~(xlbitXLFree | xlbitDLLFree);
+            if (srcType == xltypeErr) return xlretFailed;
+
+            const auto blank = srcType == xltypeNil || srcType == xltypeMissing;
+
+            auto number = std::optional<double> {};
+            if (srcType == xltypeNum) number = src.val.num;
+            if (srcType == xltypeInt) number = src.val.w;
+            if (srcType == xltypeBool) number = src.val.xbool ? 1.0 : 0.0;
+            if (blank) number = 0.0;
+            if (srcType == xltypeStr) {
+                auto   str   = text(&src);
+                double value = 0.0;
+                auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+                if (ec == std::errc() && ptr == str.data() + str.size()) number = value;
+            }
+
+            switch (type) {
+                case xltypeNum:
+                    if (not number) return xlretFailed;
+                    result.xltype  = xltypeNum;
+                    result.val.num = *number;
+                    return xlretSuccess;
+
+                case xltypeInt:
+                    if (not number) return xlretFailed;
+                    result.xltype = xltypeInt;
+                    result.val.w  = static_cast<int>(std::lround(*number));
+                    return xlretSuccess;
+
+                case xltypeBool:
+                    if (srcType == xltypeStr) {
+                        auto str = text(&src);
+                        std::ranges::transform(str, str.begin(), [](unsigned char c) { return std::toupper(c); });
+                        if (str != "TRUE" && str != "FALSE") return xlretFailed;
+                        result.xltype    = xltypeBool;
+                        result.val.xbool = str == "TRUE";
+                        return xlretSuccess;
+                    }
+                    if (not number) return xlretFailed;
+                    result.xltype    = xltypeBool;
+                    result.val.xbool = *number != 0.0;
+                    return xlretSuccess;
+
+                case xltypeStr:
+                    result.xltype  = xltypeStr;
+                    result.val.str = make_string(blank ? std::string() : text(&src));
+                    return xlretSuccess;
+
+                case xltypeMulti: {
+                    auto* buffer = make_multi(1, 1);
+                    if (auto ret = copy_oper(src, buffer[0]); ret != xlretSuccess) return ret;
+                    result.xltype            = xltypeMulti;
+                    result.val.array.lparray = buffer;
+                    result.val.array.rows    = 1;
+                    result.val.array.columns = 1;
+                    return xlretSuccess;
+                }
+
+                default:
+                    return xlretFailed;
+            }
+        }
+
+        int copy_oper(const XLOPER12& src, XLOPER12& result)
+        {
+            const auto srcType = src.xltype & ~(xlbitXLFree | xlbitDLLFree);
+            switch (srcType) {
+                case xltypeStr:
+                    result.xltype  = xltypeStr;
+                    result.val.str = make_string(text(&src));
+                    return xlretSuccess;
+
+                case xltypeMulti: {
+                    const size_t rows = src.val.array.rows;
+                    const size_t cols = src.val.array.columns;
+                    auto*        buffer = make_multi(rows, cols);
+                    for (size_t i = 0; i < rows * cols; ++i) copy_oper(src.val.array.lparray[i], buffer[i]);
+                    result.xltype            = xltypeMulti;
+                    result.val.array.lparray = buffer;
+                    result.val.array.rows    = src.val.array.rows;
+                    result.val.array.columns = src.val.array.columns;
+                    return xlretSuccess;
+                }
+
+                default:
+                    result        = src;
+                    result.xltype = srcType;
+                    return xlretSuccess;
+            }
+        }
+
+        int do_free(std::span<LPXLOPER12 const> args)
+        {
+            for (auto* oper : args)
+                if (oper != nullptr) free_oper(*oper);
+            return xlretSuccess;
+        }
+
+        int do_register(std::span<LPXLOPER12 const> args, LPXLOPER12 result)
+        {
+            if (args.size() < 3) return xlretInvCount;
+
+            auto reg         = Registration {};
+            reg.moduleText   = text(args[0]);
+            reg.procedure    = text(args[1]);
+            reg.typeText     = text(args[2]);
+            reg.functionText = args.size() > 3 ? text(args[3]) : std::string();
+            reg.argumentText = args.size() > 4 ? text(args[4]) : std::string();
+            reg.macroType    = args.size() > 5 ? integer(args[5]).value_or(1) : 1;
+            reg.category     = args.size() > 6 ? text(args[6]) : std::string();
+            reg.shortcutText = args.size() > 7 ? text(args[7]) : std::string();
+            reg.helpTopic    = args.size() > 8 ? text(args[8]) : std::string();
+            reg.functionHelp = args.size() > 9 ? text(args[9]) : std::string();
+            for (size_t i = 10; i < args.size(); ++i) reg.argumentHelp.emplace_back(text(args[i]));
+
+            if (result == nullptr) return xlretSuccess;
+
+            // Excel reports a failed registration as #VALUE!, not through the return code.
+            if (reg.procedure.empty() || reg.typeText.empty()) {
+                result->xltype  = xltypeErr;
+                result->val.err = xlerrValue;
+                return xlretSuccess;
+            }
+
+            reg.id = m_nextId++;
+            m_registrations.push_back(reg);
+            result->xltype  = xltypeNum;
+            result->val.num = reg.id;
+            return xlretSuccess;
+        }
+
+        int do_get_name(LPXLOPER12 result)
+        {
+            if (result == nullptr) return xlretInvXloper;
+            result->xltype  = xltypeStr;
+            result->val.str = make_string(m_name);
+            return xlretSuccess;
+        }
+
+        int do_get_workspace(std::span<LPXLOPER12 const> args, LPXLOPER12 result)
+        {
+            if (args.empty()) return xlretInvCount;
+            if (result == nullptr) return xlretInvXloper;
+
+            switch (integer(args[0]).value_or(0)) {
+                case 1:
+                    result->xltype  = xltypeStr;
+                    result->val.str = make_string("Linux");
+                    return xlretSuccess;
+
+                case 2:
+                    result->xltype  = xltypeStr;
+                    result->val.str = make_string("16.0");
+                    return xlretSuccess;
+
+                case 37: {
+                    // The 45 international settings, with the values of an en-US installation.
+                    static constexpr std::array<std::string_view, 16> strings = { ".", ",", "$", "", "", "", "", "", "", "",
+                                                                                  "/", ":", "y", "m", "d", "h" };
+                    auto* buffer = make_multi(1, 45);
+                    for (size_t i = 0; i < strings.size(); ++i) {
+                        buffer[i].xltype  = xltypeStr;
+                        buffer[i].val.str = make_string(strings[i]);
+                    }
+                    for (size_t i = strings.size(); i < 45; ++i) {
+                        buffer[i].xltype  = xltypeNum;
+                        buffer[i].val.num = 0.0;
+                    }
+                    result->xltype            = xltypeMulti;
+                    result->val.array.lparray = buffer;
+                    result->val.array.rows    = 1;
+                    result->val.array.columns = 45;
+                    return xlretSuccess;
+                }
+
+                default:
+                    result->xltype  = xltypeErr;
+                    result->val.err = xlerrValue;
+                    return xlretSuccess;
+            }
+        }
+
+        int do_alert(std::span<LPXLOPER12 const> args, LPXLOPER12 result)
+        {
+            if (args.empty()) return xlretInvCount;
+
+            m_alerts.push_back({ text(args[0]), args.size() > 1 ? integer(args[1]).value_or(2) : 2 });
+            if (result != nullptr) {
+                result->xltype    = xltypeBool;
+                result->val.xbool = 1;
+            }
+            return xlretSuccess;
+        }
+
+        int do_async_return(std::span<LPXLOPER12 const> args, LPXLOPER12 result)
+        {
+            if (args.size() != 2) return xlretInvCount;
+            if (args[0] == nullptr || args[0]->xltype != xltypeBigData || args[1] == nullptr) return xlretInvXloper;
+
+            // Excel rejects unknown handles, handles abandoned by a cancelled calculation, and second results.
+            auto it = m_async.find(args[0]->val.bigdata.h.hdata);
+            if (it == m_async.end() || it->second.has_value()) {
+                if (result != nullptr) {
+                    result->xltype    = xltypeBool;
+                    result->val.xbool = 0;
+                }
+                return xlretFailed;
+            }
+
+            const auto& value = *args[1];
+            AsyncResult decoded { .xltype = static_cast<uint32_t>(value.xltype & ~(xlbitXLFree | xlbitDLLFree)) };
+            switch (decoded.xltype) {
+                case xltypeNum:
+                    decoded.number = value.val.num;
+                    break;
+                case xltypeInt:
+                    decoded.number = value.val.w;
+                    break;
+                case xltypeBool:
+                    decoded.number = value.val.xbool;
+                    break;
+                case xltypeErr:
+                    decoded.error = value.val.err;
+                    break;
+                case xltypeMulti:
+                    decoded.rows    = static_cast<size_t>(value.val.array.rows);
+                    decoded.columns = static_cast<size_t>(value.val.array.columns);
+                    break;
+                default:
+                    break;
+            }
+            decoded.text = text(&value);
+            it->second   = std::move(decoded);
+            ++m_asyncReturned;
+            m_asyncDone.notify_all();
+
+            if (result != nullptr) {
+                result->xltype    = xltypeBool;
+                result->val.xbool = 1;
+            }
+            return xlretSuccess;
+        }
+
+        int do_event_register(std::span<LPXLOPER12 const> args, LPXLOPER12 result)
+        {
+            if (args.size() != 2) return xlretInvCount;
+
+            const auto event = integer(args[1]);
+            const bool valid = not text(args[0]).empty() && event.has_value();
+            if (valid) m_events.push_back({ text(args[0]), *event });
+            if (result != nullptr) {
+                result->xltype    = xltypeBool;
+                result->val.xbool = valid;
+            }
+            return xlretSuccess;
+        }
+
+        mutable std::mutex                          m_mutex;
+        std::condition_variable                     m_asyncDone;
+        std::map<int, Handler>                      m_handlers;
+        std::map<int, size_t>                       m_calls;
+        std::unordered_set<void*>                   m_allocations;
+        std::vector<Registration>                   m_registrations;
+        std::vector<Alert>                          m_alerts;
+        std::vector<EventRegistration>              m_events;
+        std::map<void*, std::optional<AsyncResult>> m_async;
+        std::string                                 m_name          = "mock.xll";
+        size_t                                      m_asyncReturned = 0;
+        uintptr_t                                   m_nextHandle    = 0;
+        size_t                                      m_strayFrees    = 0;
+        double                                      m_nextId        = 1.0;
+    };
+
+}    // namespace xll::mock
@@ -10,7 +10,31 @@
 #include "Register/Function.hpp"
 #include "Register/AddIn.hpp"
 #include "Register/Registry.hpp"
+#include "Register/Payload.hpp"
 
 #define XLL_FUNCTION extern "C" XLL_EXPORTS
 
 #define XLL_REGISTER(func) extern const xll::AddIn func##_registered(func)
+
+/**
+ * @brief Defines the exported function `procedure`, calling the plain C++ function `func`.
+ *
+ * @details The remaining arguments name the parameters of the exported function, one per parameter of `func`;
+ * their types are derived from the signature of `func` (see xll::impl::UdfArg). Use xll::Signature<procedure>() to
+ * register the matching type text, e.g.
+ *
+ *     double scale(double factor, std::span<const double> values);
+ *     XLL_UDF(ScaleSum, scale, factor, values)
+ *
+ *     auto scaleFn = xll::Function("SCALE.SUM") | xll::Procedure("ScaleSum") | xll::Signature<ScaleSum, "$">()
+ *                  | xll::Argument("factor", "...") | xll::Argument("values", "...");
+ *     XLL_REGISTER(scaleFn);
+ *
+ * If `func` is pure, its results may be cached by adding xll::Memoize(capacity, bytes) to the registration.
+ */
+#define XLL_UDF(procedure, func, ...)                                                                                    \
+    XLL_FUNCTION LPXLOPER12 XLLAPI procedure(__VA_OPT__(XLL_UDF_P0(func, __VA_ARGS__)))                                  \
+    {                                                                                                                    \
+        static auto& xll_memo = xll::MemoCache::of(procedure);                                                           \
+        return xll::impl::Thunk<func>::call(xll_memo __VA_OPT__(, ) __VA_ARGS__);                                        \
+    }
@@ -0,0 +1,66 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "../Types/Int.hpp"
+#include "../Types/String.hpp"
+
+#include <format>
+#include <stdexcept>
+#include <vector>
+#include <xlcall.hpp>
+
+namespace xll::impl
+{
+    /**
+     * @brief The commands to register with xlEventRegister, once the add-in's functions have been registered.
+     *
+     * @details Excel calls an event command by name, so the command must itself be registered (with xlfRegister,
+     * as a command) before xlAutoOpen registers it for the event.
+     */
+    class EventRegistry
+    {
+        EventRegistry() = default;
+
+        struct Entry
+        {
+            String procedure;
+            Int    event;
+        };
+
+        std::vector<Entry> m_entries {};
+
+    public:
+        EventRegistry(const EventRegistry&)            = delete;
+        EventRegistry& operator=(const EventRegistry&) = delete;
+
+        static EventRegistry& instance()
+        {
+            static EventRegistry registry;
+            return registry;
+        }
+
+        /**
+         * @param procedure The exported name of the command.
+         * @param event One of the xlevent* constants, e.g. xleventCalculationCanceled.
+         */
+        void add(const String& procedure, int event) { m_entries.push_back({ procedure, Int(event) }); }
+
+        [[nodiscard]] size_t size() const { return m_entries.size(); }
+
+        /**
+         * @throws std::runtime_error naming the first command that Excel failed to register.
+         */
+        void register_all() const
+        {
+            for (const auto& entry : m_entries) {
+                XLOPER12   result {};
+                const auto code = Excel12(xlEventRegister, &result, 2, &entry.procedure, &entry.event);
+                if (code != xlretSuccess || result.xltype != xltypeBool || not result.val.xbool)
+                    throw std::runtime_error(std::format("[xlAutoOpen]: Failed to register event command {}", entry.procedure.to_string()));
+            }
+        }
+    };
+}    // namespace xll::impl
@@ -7,15 +7,20 @@
 #include <utility>
 
 #include "Arg.hpp"
+#include "Signature.hpp"
 
 #include "../Types/Int.hpp"
 #include "../Types/Nil.hpp"
 #include "../Types/Number.hpp"
 #include "../Types/String.hpp"
+#include "../Utils/Memo.hpp"
 #include "../Utils/Traits.hpp"
 #include "../xlFunctions/GetName.hpp"
 
+#include <format>
 #include <numeric>
+#include <optional>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -38,9 +43,16 @@ namespace xll
             xll::String functionHelpTopic;
             xll::String functionDescription;
             xll::String threadSafety;
+            xll::String typeText;
 
             std::vector<xll::String> argumentNames;
             std::vector<xll::String> argumentHelp;
+
+            void (*procedure)() = nullptr;    // The exported procedure, if given with Signature().
+            std::optional<size_t> arguments;  // The number of arguments of the procedure, if given with Signature().
+            bool   memoize      = false;
+            size_t memoCapacity = 0;
+            size_t memoBytes    = 0;
         };
 
         xll::String ProcedureName(const impl::FunctionArgs&);
@@ -89,7 +101,7 @@ namespace xll
 
 
 
-        xll::String join(const std::vector<xll::String>& strings, const xll::String& delimiter)
+        static xll::String join(const std::vector<xll::String>& strings, const xll::String& delimiter)
         {
             if (strings.empty()) return {};
 
@@ -116,15 +128,35 @@ namespace xll
         template<typename TArgument>
         Function& Parameter(const xll::String& name, const xll::String& help)
         {
-            using namespace xll::literals;
-
             auto arg = Arg<TArgument>(name, help);
             args.argTypes = args.argTypes + arg.type();
-            args.argumentNames.emplace_back(std::move(arg.name()));
-            args.argumentHelp.emplace_back(std::move(arg.help()));
 
-            args.argNames = join(args.argumentNames, ","_xs);
+            return Argument(arg.name(), arg.help());
+        }
 
+        /**
+         * @brief Sets the complete type text, derived at compile time from the exported procedure (see impl::TypeText).
+         *
+         * @details Modifiers ("$", "&", "#", "!") are given as a template argument, e.g. Signature<MyFunc, "$">().
+         * The argument names and help texts are added with Argument(), in the order of the parameters, one for each
+         * parameter (other than the handle of an asynchronous function); Register() throws if the numbers differ.
+         */
+        template<auto Func, impl::FixedString Modifiers = "">
+        Function& Signature()
+        {
+            args.typeText  = impl::TypeText<Func, Modifiers>::string();
+            args.procedure = reinterpret_cast<void (*)()>(Func);
+            args.arguments = impl::TypeText<Func, Modifiers>::arguments;
+            return *this;
+        }
+
+        /**
+         * @brief Adds the name and help text of the next argument, without adding to the type text.
+         */
+        Function& Argument(const xll::String& name, const xll::String& help)
+        {
+            args.argumentNames.emplace_back(name);
+            args.argumentHelp.emplace_back(help);
             return *this;
         }
 
@@ -134,6 +166,15 @@ namespace xll
             return *this;
         }
 
+        /**
+         * @brief Registers the procedure as a command (macro type 2) rather than as a worksheet function.
+         */
+        Function& Command()
+        {
+            args.visibility = 2;
+            return *this;
+        }
+
         Function& Category(const xll::String& category)
         {
             args.functionCategory = category;
@@ -152,8 +193,43 @@ namespace xll
             return *this;
         }
 
+        /**
+         * @brief Caches the results of the function, which must be pure and defined with XLL_UDF, by the values of
+         * its arguments (see xll::MemoCache).
+         *
+         * @details Up to capacity results, holding at most bytes of memory together with their arguments, are kept;
+         * when the cache is full, the least recently used result is evicted; zero disables the cache. The procedure
+         * must be given with Signature(). The cache is emptied when the add-in is closed, and may be inspected (stats()) or emptied
+         * (clear()) through xll::MemoCache::of(procedure).
+         */
+        Function& Memoize(size_t capacity, size_t bytes)
+        {
+            args.memoize      = true;
+            args.memoCapacity = capacity;
+            args.memoBytes    = bytes;
+            return *this;
+        }
+
         Function Register()
         {
+            using namespace xll::literals;
+
+            if (args.memoize) {
+                if (args.procedure == nullptr) throw std::runtime_error("Memoize: the procedure must be given with Signature<>()");
+                MemoCache::of(args.procedure).configure(args.memoCapacity, args.memoBytes);
+            }
+
+            // Excel matches the names and help texts to the arguments by position, so they must all be there.
+            if (args.arguments && args.argumentNames.size() != *args.arguments)
+                throw std::runtime_error(std::format("Register: {} takes {} arguments, but {} were given with Argument()",
+                                                     args.functionName.to_string(),
+                                                     *args.arguments,
+                                                     args.argumentNames.size()));
+
+            // The argument names are joined, and the type text completed, once rather than every time an argument
+            // or modifier is added.
+            args.argNames = join(args.argumentNames, ","_xs);
+            args.typeText = impl::FunctionSignature(args);
             functionArgs.emplace_back(args);
             return {};
         }
@@ -184,11 +260,27 @@ namespace xll
         return [name,help](Function&& lhs) { return lhs.Parameter<TArgument>(name, help); };
     }
 
+    template<auto Func, impl::FixedString Modifiers = "">
+    auto Signature()
+    {
+        return [](Function&& lhs) { return lhs.Signature<Func, Modifiers>(); };
+    }
+
+    inline auto Argument(const xll::String& name, const xll::String& help)
+    {
+        return [name, help](Function&& lhs) { return lhs.Argument(name, help); };
+    }
+
     inline auto Hidden()
     {
         return [](Function&& lhs) { return lhs.Hidden(); };
     }
 
+    inline auto Command()
+    {
+        return [](Function&& lhs) { return lhs.Command(); };
+    }
+
     inline auto Category(const xll::String& category)
     {
         return [category](Function&& lhs) { return lhs.Category(category); };
@@ -214,15 +306,41 @@ namespace xll
         return [](Function&& lhs) { return lhs.ThreadSafe(); };
     }
 
+    inline auto Memoize(size_t capacity, size_t bytes)
+    {
+        return [capacity, bytes](Function&& lhs) { return lhs.Memoize(capacity, bytes); };
+    }
+
     namespace impl
     {
         inline xll::String ProcedureName(const impl::FunctionArgs& args) { return args.procedureName; }
 
-        inline xll::String FunctionSignature(const impl::FunctionArgs& args) { return args.returnType + args.argTypes + args.threadSafety; }
+        inline xll::String FunctionSignature(const impl::FunctionArgs& args)
+        {
+            if (args.typeText.empty()) return args.returnType + args.argTypes + args.threadSafety;
+
+            // The modifiers trail the type text given with Signature(). ThreadSafe() adds "$" to them (unless it is
+            // there already), and the result must still be a combination that Excel accepts.
+            const auto text      = args.typeText.to_string();
+            const auto modifiers = std::string_view(text).substr(text.find_last_not_of("$&#!") + 1);
+            if (args.threadSafety.empty() || modifiers.contains('$')) return args.typeText;
+
+            if (not valid_modifiers(std::string(modifiers) + "$"))
+                throw std::runtime_error(std::format("Register: {} can't be thread safe with the modifiers \"{}\"",
+                                                     args.functionName.to_string(),
+                                                     modifiers));
+            return args.typeText + args.threadSafety;
+        }
 
         inline xll::String FunctionName(const impl::FunctionArgs& args) { return args.functionName; }
 
-        inline xll::String FunctionArguments(const impl::FunctionArgs& args) { return args.argNames; }
+        inline xll::String FunctionArguments(const impl::FunctionArgs& args)
+        {
+            using namespace xll::literals;
+
+            if (args.argNames.empty() && not args.argumentNames.empty()) return Function::join(args.argumentNames, ","_xs);
+            return args.argNames;
+        }
 
         inline xll::Int FunctionVisibility(const impl::FunctionArgs& args) { return args.visibility; }
 
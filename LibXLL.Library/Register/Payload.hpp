@@ -0,0 +1,200 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "Function.hpp"
+
+#include "../Types/String.hpp"
+#include "../Utils/Profiler.hpp"
+#include "../xlFunctions/GetName.hpp"
+
+#include <chrono>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <xlcall.hpp>
+
+namespace xll
+{
+    /**
+     * @brief Timings of the last registration of the add-in's functions (see impl::RegistrationPayload).
+     */
+    struct StartupReport
+    {
+        using duration = std::chrono::steady_clock::duration;
+
+        size_t   functions = 0;    // The number of functions registered.
+        duration moduleName {};    // Fetching the module name (xlGetName).
+        duration prepare {};       // Building the payload.
+        duration registration {};  // The xlfRegister calls.
+        duration total {};
+
+        [[nodiscard]] std::string to_string() const
+        {
+            using ms = std::chrono::duration<double, std::milli>;
+            return std::format("Registered {} functions in {:.3f} ms (module name {:.3f} ms, payload {:.3f} ms, xlfRegister {:.3f} ms)",
+                               functions,
+                               ms(total).count(),
+                               ms(moduleName).count(),
+                               ms(prepare).count(),
+                               ms(registration).count());
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const StartupReport& report) { return os << report.to_string(); }
+    };
+
+    namespace impl
+    {
+        /**
+         * @brief The xlfRegister arguments of all functions, prepared once as one contiguous array of XLOPER12s.
+         *
+         * @details Each function contributes ten descriptors (module, procedure, type text, function text, argument
+         * text, macro type, category, shortcut, help topic and description) followed by one per argument help text.
+         * The descriptors refer to the strings held in Function::functionArgs without copying them, and all of them
+         * share a single copy of the module name, which is fetched from Excel once. The payload is rebuilt by each
+         * xlAutoOpen, since the functions may have changed (and their strings been freed) since the last one.
+         */
+        class RegistrationPayload
+        {
+            RegistrationPayload() = default;
+
+            struct Entry
+            {
+                size_t offset;
+                size_t count;
+            };
+
+            String                  m_module {};
+            std::vector<XLOPER12>   m_opers {};
+            std::vector<LPXLOPER12> m_pointers {};
+            std::vector<Entry>      m_entries {};
+            std::vector<String>     m_owned {};
+            StartupReport           m_report {};
+
+            static XLOPER12 descriptor(const XLOPER12& value) { return value; }
+
+            static XLOPER12 nil()
+            {
+                XLOPER12 result {};
+                result.xltype = xltypeNil;
+                return result;
+            }
+
+        public:
+            RegistrationPayload(const RegistrationPayload&)            = delete;
+            RegistrationPayload& operator=(const RegistrationPayload&) = delete;
+
+            static RegistrationPayload& instance()
+            {
+                static RegistrationPayload payload;
+                return payload;
+            }
+
+            /**
+             * @brief Builds the payload for the given functions. It stays valid until they are modified.
+             */
+            void prepare(const std::vector<FunctionArgs>& functions)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                m_module         = Profiler::instance().measure("xlGetName", [] { return get_name(); });
+                const auto named = std::chrono::steady_clock::now();
+
+                size_t total = 0;
+                for (const auto& fn : functions) total += 10 + fn.argumentHelp.size();
+
+                m_opers.clear();
+                m_entries.clear();
+                m_owned.clear();
+                m_opers.reserve(total);
+                m_entries.reserve(functions.size());
+
+                // Strings made here (the padded help texts, and type texts not prepared by Function::Register) are
+                // referenced by the descriptors, so they must not move.
+                m_owned.reserve(2 * functions.size());
+
+                for (const auto& fn : functions) {
+                    m_entries.push_back({ m_opers.size(), 10 + fn.argumentHelp.size() });
+
+                    m_opers.push_back(descriptor(m_module));
+                    m_opers.push_back(descriptor(fn.procedureName));
+                    m_opers.push_back(descriptor(fn.typeText.empty() ? m_owned.emplace_back(FunctionSignature(fn)) : fn.typeText));
+                    m_opers.push_back(descriptor(fn.functionName));
+                    m_opers.push_back(descriptor(fn.argNames));
+                    m_opers.push_back(descriptor(fn.visibility));
+                    m_opers.push_back(descriptor(fn.functionCategory));
+                    m_opers.push_back(nil());
+                    m_opers.push_back(descriptor(fn.functionHelpTopic));
+                    m_opers.push_back(descriptor(fn.functionDescription));
+                    for (const auto& help : fn.argumentHelp) m_opers.push_back(descriptor(help));
+
+                    // Excel drops the last two characters of the last help text, so that one is padded.
+                    const auto& last = fn.argumentHelp.empty() ? fn.functionDescription : fn.argumentHelp.back();
+                    m_opers.back()   = descriptor(m_owned.emplace_back(last + "  "));
+                }
+
+                m_pointers.resize(m_opers.size());
+                for (size_t i = 0; i < m_opers.size(); ++i) m_pointers[i] = &m_opers[i];
+
+                m_report.moduleName = named - start;
+                m_report.prepare    = std::chrono::steady_clock::now() - named;
+            }
+
+            [[nodiscard]] size_t size() const { return m_entries.size(); }
+
+            /**
+             * @brief The xlfRegister arguments of the function at the given index.
+             */
+            [[nodiscard]] std::span<const LPXLOPER12> arguments(size_t index) const
+            {
+                const auto& entry = m_entries.at(index);
+                return { m_pointers.data() + entry.offset, entry.count };
+            }
+
+            [[nodiscard]] const String& module_name() const { return m_module; }
+
+            /**
+             * @brief Prepares the payload, and registers all functions with Excel.
+             *
+             * @throws std::runtime_error naming the first function that Excel failed to register.
+             */
+            const StartupReport& register_all(const std::vector<FunctionArgs>& functions)
+            {
+                const auto start    = std::chrono::steady_clock::now();
+                auto&      profiler = Profiler::instance();
+                profiler.measure("RegistrationPayload::prepare", [&] { prepare(functions); });
+                const auto ready = std::chrono::steady_clock::now();
+
+                for (size_t i = 0; i < size(); ++i) {
+                    profiler.measure([&] { return "xlfRegister " + functions[i].functionName.to_string(); }, [&] {
+                        const auto args   = arguments(i);
+                        XLOPER12   id     = {};
+                        const auto result = Excel12v(xlfRegister, &id, static_cast<int>(args.size()), const_cast<LPXLOPER12*>(args.data()));
+                        const bool failed = result != xlretSuccess || id.xltype != xltypeNum;
+                        Excel12(xlFree, nullptr, 1, &id);
+
+                        if (failed) throw std::runtime_error(std::format("[xlAutoOpen]: Failed to register function {}", functions[i].functionName.to_string()));
+                    });
+                }
+
+                const auto end = std::chrono::steady_clock::now();
+
+                m_report.functions    = size();
+                m_report.registration = end - ready;
+                m_report.total        = end - start;
+                return m_report;
+            }
+
+            [[nodiscard]] const StartupReport& report() const { return m_report; }
+        };
+    }    // namespace impl
+
+    /**
+     * @brief Returns the timings of the last registration of the add-in's functions (in xlAutoOpen).
+     */
+    inline const StartupReport& startup_report() { return impl::RegistrationPayload::instance().report(); }
+
+}    // namespace xll
@@ -0,0 +1,121 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "Udf.hpp"
+
+#include "../Types/String.hpp"
+#include "../Utils/Traits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace xll::impl
+{
+    /**
+     * @brief Satisfied by types that traits::arg_traits maps to Excel type text.
+     */
+    template<typename T>
+    concept has_type_text = requires {
+        { traits::arg_traits<T>::excel_type } -> std::convertible_to<std::string_view>;
+    };
+
+    /**
+     * @brief Checks the modifiers following the argument types: $ (thread safe), & (cluster safe), # (macro sheet
+     * equivalent) and ! (volatile). Each may appear once, and macro sheet equivalents can be neither thread nor
+     * cluster safe.
+     */
+    constexpr bool valid_modifiers(std::string_view modifiers)
+    {
+        for (size_t i = 0; i < modifiers.size(); ++i) {
+            if (std::string_view("$&#!").find(modifiers[i]) == std::string_view::npos) return false;
+            if (modifiers.find(modifiers[i], i + 1) != std::string_view::npos) return false;
+        }
+
+        const auto has = [&](char c) { return modifiers.find(c) != std::string_view::npos; };
+        return not(has('#') && (has('$') || has('&')));
+    }
+
+    /**
+     * @brief Satisfied by the handle parameter of an asynchronous function.
+     */
+    template<typename T>
+    concept async_handle = std::same_as<std::remove_cv_t<std::remove_pointer_t<T>>, AsyncHandle>;
+
+    /**
+     * @brief The type text of the result; asynchronous functions return nothing (">"), and pass their result to
+     * Excel through xlAsyncReturn instead.
+     */
+    template<typename TResult>
+    constexpr std::string_view result_type_text()
+    {
+        if constexpr (std::is_void_v<TResult>)
+            return ">";
+        else
+            return traits::arg_traits<std::remove_cv_t<TResult>>::excel_type;
+    }
+
+    template<typename TResult, typename TArgs, FixedString Modifiers>
+    struct TypeTextImpl;
+
+    template<typename TResult, typename... TArgs, FixedString Modifiers>
+    struct TypeTextImpl<TResult, std::tuple<TArgs...>, Modifiers>
+    {
+        static_assert(has_type_text<std::remove_cv_t<TResult>> || (std::is_void_v<TResult> && (async_handle<TArgs> || ...)),
+                      "The result type of the procedure has no Excel type text");
+        static_assert((has_type_text<std::remove_cv_t<TArgs>> && ...), "A parameter type of the procedure has no Excel type text");
+        static_assert(sizeof...(TArgs) <= 255, "Excel functions take at most 255 arguments");
+        static_assert(valid_modifiers(Modifiers.view()), "Invalid or conflicting modifiers for the procedure");
+
+        static constexpr size_t arity = sizeof...(TArgs);
+
+        // The number of arguments seen in Excel, i.e. excluding the handle of an asynchronous function.
+        static constexpr size_t arguments = (size_t { 0 } + ... + (async_handle<TArgs> ? 0 : 1));
+
+        static constexpr size_t size = result_type_text<TResult>().size() +
+                                       (size_t { 0 } + ... + traits::arg_traits<std::remove_cv_t<TArgs>>::excel_type.size()) +
+                                       Modifiers.view().size();
+
+        static constexpr FixedString<size + 1> text = FixedString<size + 1>([] {
+            std::array<char, size + 1> result {};
+            auto                       out = result.begin();
+            for (auto part : { result_type_text<TResult>(),
+                               traits::arg_traits<std::remove_cv_t<TArgs>>::excel_type...,
+                               Modifiers.view() })
+                out = std::ranges::copy(part, out).out;
+            return result;
+        }());
+    };
+
+    /**
+     * @brief The type text of an exported procedure, derived at compile time from its function pointer type.
+     *
+     * @details Each parameter and the result map to Excel type text through traits::arg_traits (e.g. double to "B",
+     * xll::Number const* to "Q", NumericArray* to "K%", and the xll::AsyncHandle of an asynchronous function to "X"
+     * with a ">" result), followed by the modifiers. Procedures with types that Excel can't pass, or with
+     * conflicting modifiers, are rejected at compile time. The text is placed in static storage as a
+     * length-prefixed XCHAR buffer, so string() neither allocates nor converts.
+     *
+     * @tparam Func The exported procedure; a hand-written UDF or one defined with XLL_UDF.
+     * @tparam Modifiers Any of "$", "&", "#" and "!".
+     */
+    template<auto Func, FixedString Modifiers = "">
+        requires std::is_pointer_v<decltype(Func)> && std::is_function_v<std::remove_pointer_t<decltype(Func)>>
+    struct TypeText : TypeTextImpl<typename signature<decltype(Func)>::result_type,
+                                   typename signature<decltype(Func)>::argument_types,
+                                   Modifiers>
+    {
+        using BASE = TypeTextImpl<typename signature<decltype(Func)>::result_type,
+                                  typename signature<decltype(Func)>::argument_types,
+                                  Modifiers>;
+
+        static constexpr std::string_view view() { return BASE::text.view(); }
+
+        static String string() { return xll::literals::operator""_xs<BASE::text>(); }
+    };
+}    // namespace xll::impl
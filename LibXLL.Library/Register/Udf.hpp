@@ -0,0 +1,419 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "../Types/Array.hpp"
+#include "../Types/Error.hpp"
+#include "../Types/NumericArray.hpp"
+#include "../Types/String.hpp"
+#include "../Types/StringRef.hpp"
+#include "../Utils/Memo.hpp"
+#include "../Utils/Traits.hpp"
+
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <xlcall.hpp>
+
+namespace xll::impl
+{
+    /**
+     * @brief The result and parameter types of a function, function pointer or (stateless) function object.
+     */
+    template<typename T>
+    struct signature : signature<decltype(&T::operator())>
+    {};
+
+    template<typename R, typename... Args>
+    struct signature<R (*)(Args...)>
+    {
+        using result_type    = R;
+        using argument_types = std::tuple<Args...>;
+    };
+
+    template<typename R, typename... Args>
+    struct signature<R (*)(Args...) noexcept> : signature<R (*)(Args...)>
+    {};
+
+    template<typename C, typename R, typename... Args>
+    struct signature<R (C::*)(Args...) const> : signature<R (*)(Args...)>
+    {};
+
+    template<typename C, typename R, typename... Args>
+    struct signature<R (C::*)(Args...) const noexcept> : signature<R (*)(Args...)>
+    {};
+
+    /**
+     * @brief Describes how Excel passes a UDF parameter of type T, and how it is turned into T.
+     *
+     * @details Each specialisation defines the C type of the exported function's parameter (type), matching the
+     * type text given by traits::arg_traits<T>, and a from() function converting it. The conversions are chosen to
+     * avoid copies: numbers and booleans are passed by value, ranges of numbers as one FP12 block ("K%") viewed
+     * through a span, and XLOPER12-based types by pointer to Excel's own argument. The key() function writes the
+     * value of the argument to a key sink of a MemoCache, and returns false if the call can't be cached.
+     */
+    template<typename T>
+    struct UdfArg
+    {
+        static_assert(sizeof(T) == 0, "Type is not supported as a parameter of a wrapped function");
+    };
+
+    template<>
+    struct UdfArg<double>
+    {
+        using type = double;
+        static double from(double value) { return value; }
+
+        template<typename TSink>
+        static bool key(TSink& sink, double value)
+        {
+            sink.word(std::bit_cast<uint64_t>(value));
+            return true;
+        }
+    };
+
+    template<>
+    struct UdfArg<bool>
+    {
+        using type = short;    // "A" is passed as a short int
+        static bool from(short value) { return value != 0; }
+
+        template<typename TSink>
+        static bool key(TSink& sink, short value)
+        {
+            sink.word(value != 0);
+            return true;
+        }
+    };
+
+    template<>
+    struct UdfArg<int32_t>
+    {
+        using type = int32_t;
+        static int32_t from(int32_t value) { return value; }
+
+        template<typename TSink>
+        static bool key(TSink& sink, int32_t value)
+        {
+            sink.word(static_cast<uint32_t>(value));
+            return true;
+        }
+    };
+
+    template<>
+    struct UdfArg<std::string_view>
+    {
+        using type = const char*;
+        static std::string_view from(const char* value) { return value == nullptr ? std::string_view() : std::string_view(value); }
+
+        template<typename TSink>
+        static bool key(TSink& sink, const char* value)
+        {
+            sink.bytes(value, value == nullptr ? 0 : std::strlen(value));
+            return true;
+        }
+    };
+
+    template<>
+    struct UdfArg<std::string>
+    {
+        using type = const char*;
+        static std::string from(const char* value) { return value == nullptr ? std::string() : std::string(value); }
+
+        template<typename TSink>
+        static bool key(TSink& sink, const char* value)
+        {
+            return UdfArg<std::string_view>::key(sink, value);
+        }
+    };
+
+    template<>
+    struct UdfArg<std::basic_string_view<XCHAR>>
+    {
+        using type = const XCHAR*;    // "D%" is a length-prefixed XCHAR buffer
+
+        static std::basic_string_view<XCHAR> from(const XCHAR* value)
+        {
+            if (value == nullptr) return {};
+            return { &value[1], static_cast<size_t>(value[0]) };
+        }
+
+        template<typename TSink>
+        static bool key(TSink& sink, const XCHAR* value)
+        {
+            const auto text = from(value);
+            sink.bytes(text.data(), text.size() * sizeof(XCHAR));
+            return true;
+        }
+    };
+
+    template<>
+    struct UdfArg<std::span<const double>>
+    {
+        using type = const NumericArray*;
+        static std::span<const double> from(const NumericArray* value) { return value->span(); }
+
+        template<typename TSink>
+        static bool key(TSink& sink, const NumericArray* value)
+        {
+            sink.word(value->rows());
+            sink.word(value->cols());
+            sink.bytes(value->span().data(), value->size() * sizeof(double));
+            return true;
+        }
+    };
+
+    template<>
+    struct UdfArg<NumericArray>
+    {
+        using type = NumericArray*;
+        static NumericArray& from(NumericArray* value) { return *value; }
+
+        // The array may be modified in place, which a cached result would skip.
+        template<typename TSink>
+        static bool key(TSink&, NumericArray*)
+        {
+            return false;
+        }
+    };
+
+    template<typename T>
+        requires std::derived_from<T, XLOPER12>
+    struct UdfArg<T>
+    {
+        using type = const T*;
+
+        /**
+         * @details Excel passes "Q" arguments as-is, whatever the cell holds. Scalar types are checked here, so
+         * a text argument for a Number parameter results in #VALUE! rather than in reading the wrong union member.
+         * Arrays, Variants and Expected values deal with any content themselves.
+         */
+        static const T& from(const T* value)
+        {
+            if constexpr (requires { T::has_crtp_base; } || std::same_as<T, StringRef>) {
+                if ((value->xltype & ~(xlbitXLFree | xlbitDLLFree)) != T::excel_type)
+                    throw std::invalid_argument("Argument is not of the expected type");
+            }
+            return *value;
+        }
+
+        template<typename TSink>
+        static bool key(TSink& sink, const T* value)
+        {
+            return key_value(sink, *value);
+        }
+    };
+
+    template<typename T>
+    using udf_arg_t = typename UdfArg<std::remove_cvref_t<T>>::type;
+
+    /**
+     * @brief Stores the result of a wrapped function in a per-thread slot, and returns a pointer to it.
+     *
+     * @details Excel copies a "Q" result before it calls any other function on the same thread, so the slot can be
+     * reused by the next call. Nothing is allocated for scalar results, and no xlbitDLLFree / xlAutoFree12 round
+     * trip is needed for owning ones (String, Array): the previous result is released when the slot is overwritten.
+     */
+    template<typename T>
+    struct UdfResult
+    {
+        static_assert(sizeof(T) == 0, "Type is not supported as the result of a wrapped function");
+    };
+
+    template<>
+    struct UdfResult<double>
+    {
+        static LPXLOPER12 store(double value)
+        {
+            thread_local XLOPER12 slot {};
+            slot.xltype  = xltypeNum;
+            slot.val.num = value;
+            return &slot;
+        }
+    };
+
+    template<>
+    struct UdfResult<int32_t>
+    {
+        static LPXLOPER12 store(int32_t value) { return UdfResult<double>::store(value); }
+    };
+
+    template<>
+    struct UdfResult<bool>
+    {
+        static LPXLOPER12 store(bool value)
+        {
+            thread_local XLOPER12 slot {};
+            slot.xltype    = xltypeBool;
+            slot.val.xbool = value;
+            return &slot;
+        }
+    };
+
+    template<typename T>
+        requires std::derived_from<T, XLOPER12>
+    struct UdfResult<T>
+    {
+        static T& slot()
+        {
+            thread_local T value {};
+            return value;
+        }
+
+        static LPXLOPER12 store(T&& value) { return &(slot() = std::move(value)); }
+
+        static LPXLOPER12 store(const T& value) { return &(slot() = value); }
+    };
+
+    template<>
+    struct UdfResult<std::string>
+    {
+        static LPXLOPER12 store(std::string_view value) { return UdfResult<String>::store(String(value)); }
+    };
+
+    template<>
+    struct UdfResult<std::string_view> : UdfResult<std::string>
+    {};
+
+    /**
+     * @brief Returns the given Excel error code from a wrapped function.
+     */
+    inline LPXLOPER12 udf_error(int code)
+    {
+        thread_local XLOPER12 slot {};
+        slot.xltype  = xltypeErr;
+        slot.val.err = code;
+        return &slot;
+    }
+
+    /**
+     * @brief Calls func, which returns the result of a wrapped function, and turns exceptions into Excel errors.
+     *
+     * @details Exceptions do not cross into Excel: an xll::Error that is thrown is returned as is, errors from the
+     * <stdexcept> domain_error, range_error, overflow_error and underflow_error become #NUM!, and anything else
+     * (including invalid arguments) becomes #VALUE!.
+     */
+    template<typename TFunc>
+    LPXLOPER12 udf_invoke(TFunc&& func) noexcept
+    {
+        try {
+            return std::invoke(std::forward<TFunc>(func));
+        }
+        catch (const Error& error) {
+            return udf_error(error.val.err);
+        }
+        catch (const std::domain_error&) {
+            return udf_error(xlerrNum);
+        }
+        catch (const std::range_error&) {
+            return udf_error(xlerrNum);
+        }
+        catch (const std::overflow_error&) {
+            return udf_error(xlerrNum);
+        }
+        catch (const std::underflow_error&) {
+            return udf_error(xlerrNum);
+        }
+        catch (...) {
+            return udf_error(xlerrValue);
+        }
+    }
+
+    template<auto Func, typename TResult, typename TArgs>
+    struct ThunkImpl;
+
+    template<auto Func, typename TResult, typename... TArgs>
+    struct ThunkImpl<Func, TResult, std::tuple<TArgs...>>
+    {
+        static constexpr size_t arity = sizeof...(TArgs);
+
+        /**
+         * @brief Converts the arguments, calls the function and stores the result (see udf_invoke).
+         */
+        static LPXLOPER12 call(udf_arg_t<TArgs>... args) noexcept
+        {
+            return udf_invoke([&] {
+                return UdfResult<std::remove_cvref_t<TResult>>::store(std::invoke(Func, UdfArg<std::remove_cvref_t<TArgs>>::from(args)...));
+            });
+        }
+
+        /**
+         * @brief As call(), answering calls from the cache of the procedure while it is enabled (see xll::Memoize).
+         */
+        static LPXLOPER12 call(MemoCache& memo, udf_arg_t<TArgs>... args) noexcept
+        {
+            if (not memo.enabled()) return call(args...);
+
+            // String views are cached as strings, as the viewed text may not outlive the call.
+            using result_type = std::remove_cvref_t<TResult>;
+            using value_type  = std::conditional_t<std::same_as<result_type, std::string_view>, std::string, result_type>;
+
+            return udf_invoke([&] {
+                const auto key   = [&](auto& sink) { return (UdfArg<std::remove_cvref_t<TArgs>>::key(sink, args) && ...); };
+                const auto value = memo.get<value_type>(key, [&] { return std::invoke(Func, UdfArg<std::remove_cvref_t<TArgs>>::from(args)...); });
+                return UdfResult<result_type>::store(*value);
+            });
+        }
+    };
+
+    /**
+     * @brief The exported-function side of a function wrapped with XLL_UDF.
+     *
+     * @tparam Func A function, or a constexpr stateless function object, taking plain C++ or xll types.
+     */
+    template<auto Func>
+    struct Thunk : ThunkImpl<Func,
+                             typename signature<std::remove_cvref_t<decltype(Func)>>::result_type,
+                             typename signature<std::remove_cvref_t<decltype(Func)>>::argument_types>
+    {};
+
+    template<auto Func, size_t Index>
+    using thunk_arg_t = udf_arg_t<std::tuple_element_t<Index, typename signature<std::remove_cvref_t<decltype(Func)>>::argument_types>>;
+
+}    // namespace xll::impl
+
+// Parameter list of the exported function generated by XLL_UDF: one declaration per parameter name, with the
+// type taken from the corresponding parameter of the wrapped function.
+#define XLL_UDF_PARAM(func, index, name) xll::impl::thunk_arg_t<func, index> name
+#define XLL_UDF_P0(func, name, ...)  XLL_UDF_PARAM(func, 0, name) __VA_OPT__(, XLL_UDF_P1(func, __VA_ARGS__))
+#define XLL_UDF_P1(func, name, ...)  XLL_UDF_PARAM(func, 1, name) __VA_OPT__(, XLL_UDF_P2(func, __VA_ARGS__))
+#define XLL_UDF_P2(func, name, ...)  XLL_UDF_PARAM(func, 2, name) __VA_OPT__(, XLL_UDF_P3(func, __VA_ARGS__))
+#define XLL_UDF_P3(func, name, ...)  XLL_UDF_PARAM(func, 3, name) __VA_OPT__(, XLL_UDF_P4(func, __VA_ARGS__))
+#define XLL_UDF_P4(func, name, ...)  XLL_UDF_PARAM(func, 4, name) __VA_OPT__(, XLL_UDF_P5(func, __VA_ARGS__))
+#define XLL_UDF_P5(func, name, ...)  XLL_UDF_PARAM(func, 5, name) __VA_OPT__(, XLL_UDF_P6(func, __VA_ARGS__))
+#define XLL_UDF_P6(func, name, ...)  XLL_UDF_PARAM(func, 6, name) __VA_OPT__(, XLL_UDF_P7(func, __VA_ARGS__))
+#define XLL_UDF_P7(func, name, ...)  XLL_UDF_PARAM(func, 7, name) __VA_OPT__(, XLL_UDF_P8(func, __VA_ARGS__))
+#define XLL_UDF_P8(func, name, ...)  XLL_UDF_PARAM(func, 8, name) __VA_OPT__(, XLL_UDF_P9(func, __VA_ARGS__))
+#define XLL_UDF_P9(func, name, ...)  XLL_UDF_PARAM(func, 9, name) __VA_OPT__(, XLL_UDF_P10(func, __VA_ARGS__))
+#define XLL_UDF_P10(func, name, ...) XLL_UDF_PARAM(func, 10, name) __VA_OPT__(, XLL_UDF_P11(func, __VA_ARGS__))
+#define XLL_UDF_P11(func, name, ...) XLL_UDF_PARAM(func, 11, name) __VA_OPT__(, XLL_UDF_P12(func, __VA_ARGS__))
+#define XLL_UDF_P12(func, name, ...) XLL_UDF_PARAM(func, 12, name) __VA_OPT__(, XLL_UDF_P13(func, __VA_ARGS__))
+#define XLL_UDF_P13(func, name, ...) XLL_UDF_PARAM(func, 13, name) __VA_OPT__(, XLL_UDF_P14(func, __VA_ARGS__))
+#define XLL_UDF_P14(func, name, ...) XLL_UDF_PARAM(func, 14, name) __VA_OPT__(, XLL_UDF_P15(func, __VA_ARGS__))
+#define XLL_UDF_P15(func, name, ...) XLL_UDF_PARAM(func, 15, name) __VA_OPT__(, XLL_UDF_P16(func, __VA_ARGS__))
+#define XLL_UDF_P16(func, name, ...) XLL_UDF_PARAM(func, 16, name) __VA_OPT__(, XLL_UDF_P17(func, __VA_ARGS__))
+#define XLL_UDF_P17(func, name, ...) XLL_UDF_PARAM(func, 17, name) __VA_OPT__(, XLL_UDF_P18(func, __VA_ARGS__))
+#define XLL_UDF_P18(func, name, ...) XLL_UDF_PARAM(func, 18, name) __VA_OPT__(, XLL_UDF_P19(func, __VA_ARGS__))
+#define XLL_UDF_P19(func, name, ...) XLL_UDF_PARAM(func, 19, name) __VA_OPT__(, XLL_UDF_P20(func, __VA_ARGS__))
+#define XLL_UDF_P20(func, name, ...) XLL_UDF_PARAM(func, 20, name) __VA_OPT__(, XLL_UDF_P21(func, __VA_ARGS__))
+#define XLL_UDF_P21(func, name, ...) XLL_UDF_PARAM(func, 21, name) __VA_OPT__(, XLL_UDF_P22(func, __VA_ARGS__))
+#define XLL_UDF_P22(func, name, ...) XLL_UDF_PARAM(func, 22, name) __VA_OPT__(, XLL_UDF_P23(func, __VA_ARGS__))
+#define XLL_UDF_P23(func, name, ...) XLL_UDF_PARAM(func, 23, name) __VA_OPT__(, XLL_UDF_P24(func, __VA_ARGS__))
+#define XLL_UDF_P24(func, name, ...) XLL_UDF_PARAM(func, 24, name) __VA_OPT__(, XLL_UDF_P25(func, __VA_ARGS__))
+#define XLL_UDF_P25(func, name, ...) XLL_UDF_PARAM(func, 25, name) __VA_OPT__(, XLL_UDF_P26(func, __VA_ARGS__))
+#define XLL_UDF_P26(func, name, ...) XLL_UDF_PARAM(func, 26, name) __VA_OPT__(, XLL_UDF_P27(func, __VA_ARGS__))
+#define XLL_UDF_P27(func, name, ...) XLL_UDF_PARAM(func, 27, name) __VA_OPT__(, XLL_UDF_P28(func, __VA_ARGS__))
+#define XLL_UDF_P28(func, name, ...) XLL_UDF_PARAM(func, 28, name) __VA_OPT__(, XLL_UDF_P29(func, __VA_ARGS__))
+#define XLL_UDF_P29(func, name, ...) XLL_UDF_PARAM(func, 29, name) __VA_OPT__(, XLL_UDF_P30(func, __VA_ARGS__))
+#define XLL_UDF_P30(func, name, ...) XLL_UDF_PARAM(func, 30, name) __VA_OPT__(, XLL_UDF_P31(func, __VA_ARGS__))
+#define XLL_UDF_P31(func, name, ...) XLL_UDF_PARAM(func, 31, name) __VA_OPT__(, XLL_UDF_TOO_MANY_PARAMETERS)
@@ -9,10 +9,13 @@
 #include "Types/Bool.hpp"
 #include "Types/Error.hpp"
 #include "Types/Int.hpp"
+#include "Types/MaskedArray.hpp"
 #include "Types/Missing.hpp"
 #include "Types/Nil.hpp"
 #include "Types/Number.hpp"
+#include "Types/NumericArray.hpp"
 #include "Types/String.hpp"
+#include "Types/StringRef.hpp"
 #include "Types/Variant.hpp"
 #include "Types/Expected.hpp"
 #include "Types/SingleRef.hpp"
@@ -6,7 +6,11 @@
 
 #include "Expected.hpp"
 #include "Variant.hpp"
+#include "../Utils/BufferPool.hpp"
+#include <algorithm>
+#include <array>
 #include <expected>
+#include <memory>
 #include <span>
 #ifdef _MSC_VER
 #    include <mdspan>
@@ -27,6 +31,17 @@ namespace xll
     public:
         using value_type = TValue;
 
+        using extents_type          = mds::dextents<size_t, 2>;
+        using vector_extents_type   = mds::dextents<size_t, 1>;
+        using view_type             = mds::mdspan<TValue, extents_type>;
+        using const_view_type       = mds::mdspan<const TValue, extents_type>;
+        using row_view_type         = mds::mdspan<TValue, vector_extents_type>;
+        using const_row_view_type   = mds::mdspan<const TValue, vector_extents_type>;
+        using col_view_type         = mds::mdspan<TValue, vector_extents_type, mds::layout_stride>;
+        using const_col_view_type   = mds::mdspan<const TValue, vector_extents_type, mds::layout_stride>;
+        using block_view_type       = mds::mdspan<TValue, extents_type, mds::layout_stride>;
+        using const_block_view_type = mds::mdspan<const TValue, extents_type, mds::layout_stride>;
+
         /**
          * @brief Default constructor for the Array class.
          *
@@ -62,11 +77,21 @@ namespace xll
             val.array.columns = static_cast<COL>(cols);
         }
 
-        constexpr Array(size_t rows, size_t cols, TValue v) : Array(rows, cols)
+        /**
+         * @brief Constructs a two-dimensional Array with every element initialized to the given value.
+         *
+         * @param rows The number of rows in the array.
+         * @param cols The number of columns in the array.
+         * @param v The value to fill the array with.
+         * @throws std::bad_alloc if memory allocation fails.
+         */
+        constexpr Array(size_t rows, size_t cols, TValue v) : Array()
         {
-            for (size_t i = 0; i < rows * cols; ++i) {
-                static_cast<TValue&>(val.array.lparray[i]) = v;
-            }
+            if (rows * cols == 0) return;
+
+            val.array.lparray = make_array(rows * cols, v).release();
+            val.array.rows    = static_cast<RW>(rows);
+            val.array.columns = static_cast<COL>(cols);
         }
 
         /**
@@ -109,6 +134,29 @@ namespace xll
             }
         }
 
+        /**
+         * @brief Creates a two-dimensional Array whose elements are left uninitialized.
+         *
+         * @details This is for element types owning no memory, where the caller fills the XLOPER12 buffer
+         * (val.array.lparray) directly, so that each element is written exactly once. Every element must be written
+         * before the Array is used.
+         *
+         * @param rows The number of rows in the array.
+         * @param cols The number of columns in the array.
+         * @throws std::bad_alloc if memory allocation fails.
+         */
+        static Array make_for_overwrite(size_t rows, size_t cols)
+            requires impl::plain_data<TValue>
+        {
+            auto result = Array();
+            if (rows * cols == 0) return result;
+
+            result.val.array.lparray = allocate(rows * cols).release();
+            result.val.array.rows    = static_cast<RW>(rows);
+            result.val.array.columns = static_cast<COL>(cols);
+            return result;
+        }
+
         /**
          * @brief Constructs an Array from a Missing value.
          *
@@ -161,7 +209,8 @@ namespace xll
          * This constructor creates a new Array by copying the contents of another Array instance.
          * It handles three cases:
          * 1. If the source is a multi-cell array (xltypeMulti), it allocates a new buffer of the same size,
-         *    copies the dimensions, and performs element-by-element copying of the array contents.
+         *    copies the dimensions, and copies the array contents (as a single bulk copy if the
+         *    elements own no memory, element-by-element otherwise).
          * 2. If the source is a single value (matching TValue::excel_type), it copies the value and type
          *    using TValue's assignment operator.
          * 3. For any other type, it sets this Array to an empty state (xltypeNil).
@@ -172,12 +221,9 @@ namespace xll
         constexpr Array(const Array& other) : Array()
         {
             if (other.xltype == xltypeMulti) {
-                val.array.lparray = make_array(other.size()).release();
+                val.array.lparray = copy_array(other.val.array.lparray, other.size()).release();
                 val.array.rows    = other.rows();
                 val.array.columns = other.cols();
-                for (unsigned i = 0; i < size(); ++i) {
-                    static_cast<TValue&>(val.array.lparray[i]) = static_cast<TValue&>(other.val.array.lparray[i]);
-                }
                 return;
             }
 
@@ -194,7 +240,7 @@ namespace xll
          *
          * This destructor properly cleans up resources depending on the Array's type:
          * 1. For multi-cell arrays (xltypeMulti with valid pointer):
-         *    - Calls the destructor for each TValue element in the array
+         *    - Calls the destructor for each TValue element in the array (unless the elements own no memory)
          *    - Deallocates the memory used by the array
          *    - Sets the array pointer to nullptr to prevent double deletion
          * 2. For single values (not xltypeMulti):
@@ -206,8 +252,9 @@ namespace xll
         constexpr ~Array()
         {
             if (xltype == xltypeMulti && val.array.lparray != nullptr) {
-                for (auto& item : *this) item.~TValue();
-                delete[] val.array.lparray;
+                if constexpr (not impl::plain_data<TValue>)
+                    for (auto& item : *this) item.~TValue();
+                BufferPool::instance().deallocate(val.array.lparray, size());
                 val.array.lparray = nullptr;
             }
             else if (xltype != xltypeMulti) {
@@ -231,7 +278,7 @@ namespace xll
          *    - Cleans up any existing array data
          *    - Allocates a new buffer of the same size as the source
          *    - Copies the dimensions from the source array
-         *    - Performs element-by-element copying of array contents
+         *    - Copies the array contents (in bulk if the elements own no memory)
          * 2. If the source is a single value (matching TValue::excel_type):
          *    - Calls the destructor to clean up current resources
          *    - Copies the type from the source
@@ -247,14 +294,12 @@ namespace xll
             if (this == &other) return *this;
 
             if (other.xltype == xltypeMulti) {
+                auto buffer = copy_array(other.val.array.lparray, other.size());
                 this->~Array();
                 xltype            = other.xltype;
-                val.array.lparray = make_array(other.size()).release();
+                val.array.lparray = buffer.release();
                 val.array.rows    = other.rows();
                 val.array.columns = other.cols();
-                for (unsigned i = 0; i < size(); ++i) {
-                    static_cast<TValue&>(val.array.lparray[i]) = static_cast<TValue&>(other.val.array.lparray[i]);
-                }
                 return *this;
             }
 
@@ -480,20 +525,98 @@ namespace xll
             }
         }
 
-        constexpr TValue operator[](size_t row, size_t col) const
+        constexpr TValue& operator[](size_t row, size_t col)
         {
             if (xltype == xltypeMulti) {
                 if ((row + 1) > val.array.rows || (col + 1) > val.array.columns) throw std::out_of_range("Array index out of range");
-                using ext_t = mds::extents<uint32_t, std::dynamic_extent, std::dynamic_extent>;
-                auto m      = mds::mdspan<TValue, ext_t>(static_cast<TValue*>(val.array.lparray), val.array.rows, val.array.columns);
-                return m[row, col];
+                return view()[row, col];
             }
             else {
                 if (row != 0 || col != 0) throw std::out_of_range("Array index out of range");
-                return *static_cast<TValue const*>(this);
+                return *reinterpret_cast<TValue*>(this);
             }
         }
 
+        constexpr const TValue& operator[](size_t row, size_t col) const
+        {
+            if (xltype == xltypeMulti) {
+                if ((row + 1) > val.array.rows || (col + 1) > val.array.columns) throw std::out_of_range("Array index out of range");
+                return view()[row, col];
+            }
+            else {
+                if (row != 0 || col != 0) throw std::out_of_range("Array index out of range");
+                return *reinterpret_cast<TValue const*>(this);
+            }
+        }
+
+        /**
+         * @brief Returns a non-owning, writable two-dimensional (row-major) view of the array elements.
+         *
+         * @details The view refers directly to the underlying XLOPER12 buffer; nothing is copied. It is
+         * invalidated by any operation that reallocates the array (assignment, move, destruction).
+         */
+        constexpr view_type view() { return view_type(begin(), rows(), cols()); }
+
+        constexpr const_view_type view() const { return const_view_type(begin(), rows(), cols()); }
+
+        /**
+         * @brief Returns a non-owning, writable view of the given row.
+         *
+         * @throws std::out_of_range if the row index is out of range.
+         */
+        constexpr row_view_type row(size_t index)
+        {
+            if (index >= rows()) throw std::out_of_range("Array row index out of range");
+            return row_view_type(begin() + index * cols(), cols());
+        }
+
+        constexpr const_row_view_type row(size_t index) const
+        {
+            if (index >= rows()) throw std::out_of_range("Array row index out of range");
+            return const_row_view_type(begin() + index * cols(), cols());
+        }
+
+        /**
+         * @brief Returns a non-owning, writable (strided) view of the given column.
+         *
+         * @throws std::out_of_range if the column index is out of range.
+         */
+        constexpr col_view_type col(size_t index)
+        {
+            if (index >= cols()) throw std::out_of_range("Array column index out of range");
+            return col_view_type(begin() + index, typename col_view_type::mapping_type(vector_extents_type(rows()), std::array { cols() }));
+        }
+
+        constexpr const_col_view_type col(size_t index) const
+        {
+            if (index >= cols()) throw std::out_of_range("Array column index out of range");
+            return const_col_view_type(begin() + index, typename const_col_view_type::mapping_type(vector_extents_type(rows()), std::array { cols() }));
+        }
+
+        /**
+         * @brief Returns a non-owning, writable (strided) view of a rectangular block of the array.
+         *
+         * @details The block covers the half-open ranges [row_first, row_last) and [col_first, col_last),
+         * matching the slice semantics of submdspan.
+         *
+         * @throws std::out_of_range if the block is not contained in the array.
+         */
+        constexpr block_view_type block(size_t row_first, size_t col_first, size_t row_last, size_t col_last)
+        {
+            check_block(row_first, col_first, row_last, col_last);
+            return block_view_type(begin() + row_first * cols() + col_first,
+                                   typename block_view_type::mapping_type(extents_type(row_last - row_first, col_last - col_first),
+                                                                          std::array { cols(), size_t { 1 } }));
+        }
+
+        constexpr const_block_view_type block(size_t row_first, size_t col_first, size_t row_last, size_t col_last) const
+        {
+            check_block(row_first, col_first, row_last, col_last);
+            return const_block_view_type(begin() + row_first * cols() + col_first,
+                                         typename const_block_view_type::mapping_type(extents_type(row_last - row_first, col_last - col_first),
+                                                                                      std::array { cols(), size_t { 1 } }));
+        }
+
         constexpr operator std::vector<TValue>() const
         {
             std::vector<TValue> result {};
@@ -541,17 +664,94 @@ namespace xll
         }
 
     private:
-        constexpr static std::unique_ptr<XLOPER12[]> make_array(size_t size)
+        constexpr void check_block(size_t row_first, size_t col_first, size_t row_last, size_t col_last) const
         {
-            if (size == 0) return nullptr;
+            if (row_first > row_last || col_first > col_last || row_last > rows() || col_last > cols())
+                throw std::out_of_range("Array block out of range");
+        }
 
-            // Allocate memory with proper size and error checking
-            auto buffer = std::make_unique<XLOPER12[]>(size);
-            if (!buffer) throw std::bad_alloc();
+        /**
+         * @brief Returns the XLOPER12 buffer to the BufferPool when it is not handed over to an Array.
+         */
+        struct BufferDeleter
+        {
+            size_t size;
+
+            void operator()(XLOPER12* buffer) const noexcept { BufferPool::instance().deallocate(buffer, size); }
+        };
+
+        using buffer_ptr = std::unique_ptr<XLOPER12[], BufferDeleter>;
+
+        /**
+         * @brief Takes an uninitialised buffer from the BufferPool (new XLOPER12[] if it is disabled); it is returned
+         * there by the destructor.
+         */
+        static buffer_ptr allocate(size_t size) { return buffer_ptr(BufferPool::instance().allocate(size), BufferDeleter { size }); }
+
+        constexpr static buffer_ptr make_array(size_t size)
+        {
+            if (size == 0) return buffer_ptr(nullptr, BufferDeleter { 0 });
+
+            // Elements owning no memory are filled from a prototype in a single pass.
+            if constexpr (impl::plain_data<TValue>) return make_array(size, TValue());
+
+            auto buffer = allocate(size);
+            std::fill_n(buffer.get(), size, XLOPER12 {});
             for (unsigned i = 0; i < size; ++i) *static_cast<TValue*>(&buffer[i]) = TValue();
 
             return buffer;
         }
+
+        constexpr static buffer_ptr make_array(size_t size, const TValue& init)
+        {
+            if (size == 0) return buffer_ptr(nullptr, BufferDeleter { 0 });
+
+            auto buffer = allocate(size);
+            if constexpr (impl::plain_data<TValue>) {
+                std::fill_n(buffer.get(), size, static_cast<const XLOPER12&>(init));
+            }
+            else {
+                std::fill_n(buffer.get(), size, XLOPER12 {});
+                for (unsigned i = 0; i < size; ++i) *static_cast<TValue*>(&buffer[i]) = TValue(init);
+            }
+            return buffer;
+        }
+
+        /**
+         * @brief Returns true if a cell of the given type can be held by an element (an Expected also holds its error).
+         */
+        static constexpr bool is_element_type(decltype(XLOPER12::xltype) type)
+        {
+            constexpr auto types = [] {
+                if constexpr (requires { typename TValue::error_type; })
+                    return static_cast<decltype(XLOPER12::xltype)>(TValue::excel_type | TValue::error_type::excel_type);
+                else
+                    return static_cast<decltype(XLOPER12::xltype)>(TValue::excel_type);
+            }();
+            return type != 0 && (type & ~types) == 0;
+        }
+
+        constexpr static buffer_ptr copy_array(const XLOPER12* source, size_t size)
+        {
+            if (size == 0) return buffer_ptr(nullptr, BufferDeleter { 0 });
+
+            // Elements owning no memory are copied with a single bulk copy of the XLOPER12 buffer. A range passed by
+            // Excel may hold cells of any type, so the types are checked first, as an element-wise copy would.
+            if constexpr (impl::plain_data<TValue>) {
+                if (not std::all_of(source, source + size, [](const XLOPER12& cell) { return is_element_type(cell.xltype); }))
+                    throw std::runtime_error("XLOPER12 type not convertible to type");
+
+                auto buffer = allocate(size);
+                std::copy_n(source, size, buffer.get());
+                return buffer;
+            }
+            else {
+                auto buffer = make_array(size);
+                for (unsigned i = 0; i < size; ++i)
+                    static_cast<TValue&>(buffer[i]) = static_cast<TValue const&>(source[i]);
+                return buffer;
+            }
+        }
     };
 
     // template<template<typename> class TContainer, typename T, typename E>
@@ -567,10 +767,12 @@ namespace xll
 
         Array<Expected<value_t>> result(input.size(), 1);
         for (unsigned i = 0; i < input.size(); ++i) {
-            if (input[i].has_value())
-                result[i].value() = *input[i];
+            if (not input[i].has_value())
+                static_cast<XLOPER12&>(result[i]) = xll::ErrNull;
+            else if constexpr (impl::plain_data<value_t>)
+                static_cast<XLOPER12&>(result[i]) = value_t(*input[i]);
             else
-                result[i] = xll::ErrNull;
+                result[i] = value_t(*input[i]);
         }
         return result;
     }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "../Utils/Ensure.hpp"
+#include <concepts>
 #include <iostream>
 #include <type_traits>
 #include <xlcall.hpp>
@@ -29,6 +30,17 @@ namespace xll::impl
                                     Value == xltypeErr || Value == xltypeFlow || Value == xltypeMulti || Value == xltypeMissing ||
                                     Value == xltypeNil || Value == xltypeSRef || Value == xltypeInt);
 
+    /**
+     * \brief Satisfied by types whose XLOPER12 representation owns no memory.
+     *
+     * Such types can be copied, filled and destroyed as raw XLOPER12 structs, without
+     * going through their constructors, assignment operators or destructors.
+     */
+    template<typename T>
+    concept plain_data = requires {
+        { T::is_plain_data } -> std::convertible_to<bool>;
+    } && T::is_plain_data;
+
     template<typename TDerived, size_t ValueType, size_t... OtherTypes>
         requires is_excel_type<ValueType>
     class Base;
@@ -88,6 +100,7 @@ namespace xll::impl
         static constexpr size_t excel_type = XLType;
         constexpr bool is_valid() const { return xltype == XLType; }
         static constexpr bool has_crtp_base = true;
+        static constexpr bool is_plain_data = XLType != xltypeStr && XLType != xltypeMulti && XLType != xltypeRef;
 
         // clang-format off
         using value_type =
@@ -4,6 +4,14 @@
 
 #pragma once
 
+#include "Bool.hpp"
+#include "Error.hpp"
+#include "Int.hpp"
+#include "Missing.hpp"
+#include "Nil.hpp"
+#include "Number.hpp"
+#include "String.hpp"
+
 #include <fxt.hpp>
 
 namespace xll
@@ -42,6 +50,9 @@ namespace xll
 
         static constexpr size_t excel_type = TValue::excel_type;
 
+        // True if neither the value nor the error own memory, i.e. the Expected can be copied as a raw XLOPER12
+        static constexpr bool is_plain_data = impl::plain_data<TValue> && impl::plain_data<TError>;
+
         /**
          * @brief Default constructor.
          *
@@ -0,0 +1,465 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "Array.hpp"
+#include "Error.hpp"
+#include "Expected.hpp"
+#include "Number.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX__)
+#    include <immintrin.h>
+#    define XLL_MASKED_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define XLL_MASKED_SSE2 1
+#endif
+
+namespace xll
+{
+    /**
+     * @brief A columnar representation of Array<Expected<Number>>, for numeric kernels on ranges that may hold errors.
+     *
+     * @details An Array<Expected<Number>> stores every cell as a full XLOPER12, so a loop over it has to check the
+     * type of each cell and cannot be vectorised. MaskedArray splits the same data into
+     *
+     *  - a dense buffer of doubles (one per cell, in row-major order),
+     *  - a validity bitmap (one bit per cell, set if the cell holds a number), and
+     *  - a sparse side table with the error code of each cell that holds an error, ordered by index.
+     *
+     * The conversion from and to the Excel (xltypeMulti) layout is a single pass in each direction, intended to be
+     * done once at the boundary of a UDF. In between, apply()/transform() run as plain loops over the doubles (which
+     * the compiler vectorises), sum() masks out invalid cells with SIMD instructions, and reduce() skips invalid
+     * cells 64 at a time using the bitmap words.
+     *
+     * The doubles of cells holding an error are unspecified (they are 0.0 after conversion, but a transform is
+     * applied to them as well); only the bitmap decides whether a cell holds a value.
+     */
+    class MaskedArray
+    {
+    public:
+        using value_type = double;
+        using mask_type  = uint64_t;
+
+        // The number of cells covered by one word of the validity bitmap
+        static constexpr size_t mask_bits = 64;
+
+        struct ErrorEntry
+        {
+            size_t index;
+            int    code;
+
+            friend bool operator==(const ErrorEntry&, const ErrorEntry&) = default;
+        };
+
+        MaskedArray() = default;
+
+        /**
+         * @brief Creates a MaskedArray of the given shape, with all cells holding the value 0.0.
+         */
+        MaskedArray(size_t rows, size_t cols)
+            : m_rows(rows),
+              m_cols(cols),
+              m_values(rows * cols, 0.0),
+              m_mask(words(rows * cols), ~mask_type {})
+        {
+            clear_tail();
+        }
+
+        /**
+         * @brief Converts an XLOPER12 (an xltypeMulti array, or a single cell) in one pass.
+         *
+         * @details Numbers are copied to the value buffer, errors are recorded in the side table, and any other
+         * type (strings, booleans, empty cells) is treated as #VALUE!, as for an Expected<Number> argument.
+         */
+        explicit MaskedArray(const XLOPER12& value)
+        {
+            const auto  type  = value.xltype & ~(xlbitDLLFree | xlbitXLFree);
+            const auto* cells = &value;
+            if (type == xltypeMulti) {
+                cells  = value.val.array.lparray;
+                m_rows = cells == nullptr ? 0 : static_cast<size_t>(value.val.array.rows);
+                m_cols = cells == nullptr ? 0 : static_cast<size_t>(value.val.array.columns);
+            }
+            else {
+                m_rows = 1;
+                m_cols = 1;
+            }
+
+            const auto count = size();
+            m_values.resize(count);
+            m_mask.resize(words(count));
+
+            for (size_t word = 0; word < m_mask.size(); ++word) {
+                const auto first = word * mask_bits;
+                const auto last  = std::min(first + mask_bits, count);
+
+                mask_type bits = 0;
+                for (size_t i = first; i < last; ++i) {
+                    const auto valid = cells[i].xltype == xltypeNum;
+                    m_values[i]      = valid ? cells[i].val.num : 0.0;
+                    bits |= mask_type { valid } << (i - first);
+                }
+                m_mask[word] = bits;
+
+                if (bits != mask_bits_for(last - first))
+                    for (size_t i = first; i < last; ++i)
+                        if (cells[i].xltype != xltypeNum)
+                            m_errors.push_back({ i, cells[i].xltype == xltypeErr ? cells[i].val.err : xlerrValue });
+            }
+        }
+
+        explicit MaskedArray(const Array<Expected<Number>>& array) : MaskedArray(static_cast<const XLOPER12&>(array)) {}
+
+        /**
+         * @brief Converts back to the Excel layout, in one pass.
+         */
+        [[nodiscard]] Array<Expected<Number>> to_array() const
+        {
+            auto result = Array<Expected<Number>>::make_for_overwrite(m_rows, m_cols);
+            if (result.empty()) return result;
+
+            auto* cells = result.val.array.lparray;
+            auto  error = m_errors.begin();
+            for (size_t i = 0; i < size(); ++i) {
+                if (has_value(i)) {
+                    cells[i].xltype  = xltypeNum;
+                    cells[i].val.num = m_values[i];
+                }
+                else {
+                    cells[i].xltype  = xltypeErr;
+                    cells[i].val.err = (error++)->code;
+                }
+            }
+
+            return result;
+        }
+
+        explicit operator Array<Expected<Number>>() const { return to_array(); }
+
+        [[nodiscard]] size_t rows() const { return m_rows; }
+
+        [[nodiscard]] size_t cols() const { return m_cols; }
+
+        [[nodiscard]] size_t size() const { return m_rows * m_cols; }
+
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        /**
+         * @brief Returns the value buffer. The values of cells holding an error are unspecified.
+         */
+        [[nodiscard]] std::span<double> values() { return m_values; }
+
+        [[nodiscard]] std::span<const double> values() const { return m_values; }
+
+        /**
+         * @brief Returns the validity bitmap; bit (i % 64) of word (i / 64) is set if cell i holds a value.
+         */
+        [[nodiscard]] std::span<const mask_type> mask() const { return m_mask; }
+
+        /**
+         * @brief Returns the error codes of the cells holding an error, ordered by index.
+         */
+        [[nodiscard]] std::span<const ErrorEntry> errors() const { return m_errors; }
+
+        [[nodiscard]] bool has_value(size_t index) const { return (m_mask[index / mask_bits] >> (index % mask_bits)) & 1; }
+
+        /**
+         * @brief Returns the number of cells holding a value.
+         */
+        [[nodiscard]] size_t count() const
+        {
+            size_t result = 0;
+            for (const auto word : m_mask) result += static_cast<size_t>(std::popcount(word));
+            return result;
+        }
+
+        /**
+         * @brief Returns the error held by the cell.
+         *
+         * @throws std::runtime_error if the cell holds a value.
+         */
+        [[nodiscard]] xll::Error error(size_t index) const
+        {
+            check_index(index);
+            const auto entry = find_error(index);
+            if (entry == m_errors.end() || entry->index != index) throw std::runtime_error("MaskedArray element holds a value");
+            return make_error(entry->code);
+        }
+
+        /**
+         * @brief Returns the cell as an Expected<Number>.
+         *
+         * @throws std::out_of_range if the index is out of range.
+         */
+        Expected<Number> operator[](size_t index) const
+        {
+            check_index(index);
+            if (has_value(index)) return Number(m_values[index]);
+            return Unexpected(error(index));
+        }
+
+        Expected<Number> operator[](size_t row, size_t col) const
+        {
+            if (row >= m_rows || col >= m_cols) throw std::out_of_range("MaskedArray index out of range");
+            return (*this)[row * m_cols + col];
+        }
+
+        /**
+         * @brief Sets the cell to a value.
+         */
+        void set(size_t index, double value)
+        {
+            check_index(index);
+            m_values[index] = value;
+            if (has_value(index)) return;
+
+            m_mask[index / mask_bits] |= mask_type { 1 } << (index % mask_bits);
+            m_errors.erase(find_error(index));
+        }
+
+        /**
+         * @brief Sets the cell to an error.
+         */
+        void set(size_t index, const xll::Error& error)
+        {
+            check_index(index);
+            m_values[index] = 0.0;
+            if (not has_value(index)) {
+                find_error(index)->code = error.error_id();
+                return;
+            }
+
+            m_mask[index / mask_bits] &= ~(mask_type { 1 } << (index % mask_bits));
+            m_errors.insert(find_error(index), { index, error.error_id() });
+        }
+
+        /**
+         * @brief Applies a function to the value of every cell, in place.
+         *
+         * @details The function is applied to every element of the value buffer, without checking the bitmap, so
+         * the loop can be vectorised. It must therefore be free of side effects and accept any double (the values
+         * of cells holding an error are unspecified). Cells holding an error keep their error.
+         */
+        template<typename TFunc>
+            requires std::is_invocable_r_v<double, TFunc, double>
+        MaskedArray& apply(TFunc func)
+        {
+            auto* values = m_values.data();
+            for (size_t i = 0; i < m_values.size(); ++i) values[i] = func(values[i]);
+            return *this;
+        }
+
+        /**
+         * @brief Returns a copy with a function applied to the value of every cell (see apply()).
+         */
+        template<typename TFunc>
+            requires std::is_invocable_r_v<double, TFunc, double>
+        [[nodiscard]] MaskedArray transform(TFunc func) const
+        {
+            auto result = MaskedArray(*this);
+            result.apply(std::move(func));
+            return result;
+        }
+
+        /**
+         * @brief Combines the values of two arrays of the same shape element-wise.
+         *
+         * @details A cell of the result holds a value if it does in both arrays; otherwise it holds the error of
+         * this array or, if this array holds a value, the error of the other. As for apply(), the function is
+         * applied to all cells.
+         *
+         * @throws std::runtime_error if the shapes differ.
+         */
+        template<typename TFunc>
+            requires std::is_invocable_r_v<double, TFunc, double, double>
+        [[nodiscard]] MaskedArray transform(const MaskedArray& other, TFunc func) const
+        {
+            if (m_rows != other.m_rows || m_cols != other.m_cols) throw std::runtime_error("MaskedArray shapes do not match");
+
+            auto result   = MaskedArray();
+            result.m_rows = m_rows;
+            result.m_cols = m_cols;
+            result.m_values.resize(size());
+            result.m_mask.resize(m_mask.size());
+
+            const auto* lhs    = m_values.data();
+            const auto* rhs    = other.m_values.data();
+            auto*       values = result.m_values.data();
+            for (size_t i = 0; i < result.m_values.size(); ++i) values[i] = func(lhs[i], rhs[i]);
+            for (size_t i = 0; i < m_mask.size(); ++i) result.m_mask[i] = m_mask[i] & other.m_mask[i];
+
+            // Merge the (ordered) error tables; errors of this array take precedence.
+            result.m_errors.reserve(m_errors.size() + other.m_errors.size());
+            auto left = m_errors.begin();
+            for (const auto& entry : other.m_errors) {
+                while (left != m_errors.end() && left->index < entry.index) result.m_errors.push_back(*left++);
+                if (left != m_errors.end() && left->index == entry.index) continue;
+                result.m_errors.push_back(entry);
+            }
+            result.m_errors.insert(result.m_errors.end(), left, m_errors.end());
+
+            return result;
+        }
+
+        /**
+         * @brief Folds the values of the cells holding a value, in index order.
+         *
+         * @details The bitmap is processed one word at a time: words with all bits set are folded as a dense loop,
+         * words with no bits set are skipped, and only partially valid words are walked bit by bit.
+         */
+        template<typename T, typename TOp>
+            requires std::is_invocable_r_v<T, TOp, T, double>
+        [[nodiscard]] T reduce(T init, TOp op) const
+        {
+            const auto* values = m_values.data();
+            for (size_t word = 0; word < m_mask.size(); ++word) {
+                const auto first = word * mask_bits;
+                const auto last  = std::min(first + mask_bits, size());
+                auto       bits  = m_mask[word];
+
+                if (bits == mask_bits_for(last - first))
+                    for (size_t i = first; i < last; ++i) init = op(std::move(init), values[i]);
+                else
+                    for (; bits != 0; bits &= bits - 1) init = op(std::move(init), values[first + static_cast<size_t>(std::countr_zero(bits))]);
+            }
+
+            return init;
+        }
+
+        /**
+         * @brief Returns the sum of the cells holding a value.
+         *
+         * @details With SSE2 or AVX, the bitmap bits are expanded to lane masks through a small lookup table, and
+         * invalid cells are masked out with a bitwise AND (so unspecified values, even NaN, never contribute). The
+         * sum is accumulated in several independent vectors, so the result may differ from a sequential sum in the
+         * last bits.
+         */
+        [[nodiscard]] double sum() const
+        {
+            const auto* values = m_values.data();
+            const auto  full   = size() / mask_bits;
+            auto        result = 0.0;
+            size_t      word   = 0;
+
+#if defined(XLL_MASKED_AVX)
+            auto acc0 = _mm256_setzero_pd();
+            auto acc1 = _mm256_setzero_pd();
+            auto acc2 = _mm256_setzero_pd();
+            auto acc3 = _mm256_setzero_pd();
+            for (; word < full; ++word) {
+                const auto bits = m_mask[word];
+                if (bits == 0) continue;
+
+                const auto* block = values + word * mask_bits;
+                for (size_t i = 0; i < mask_bits; i += 16) {
+                    const auto mask = [&](size_t offset) {
+                        return _mm256_loadu_pd(reinterpret_cast<const double*>(lane_masks<4>[(bits >> (i + offset)) & 0xF].data()));
+                    };
+                    acc0 = _mm256_add_pd(acc0, _mm256_and_pd(_mm256_loadu_pd(block + i + 0), mask(0)));
+                    acc1 = _mm256_add_pd(acc1, _mm256_and_pd(_mm256_loadu_pd(block + i + 4), mask(4)));
+                    acc2 = _mm256_add_pd(acc2, _mm256_and_pd(_mm256_loadu_pd(block + i + 8), mask(8)));
+                    acc3 = _mm256_add_pd(acc3, _mm256_and_pd(_mm256_loadu_pd(block + i + 12), mask(12)));
+                }
+            }
+
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, _mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+            result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(XLL_MASKED_SSE2)
+            auto acc0 = _mm_setzero_pd();
+            auto acc1 = _mm_setzero_pd();
+            auto acc2 = _mm_setzero_pd();
+            auto acc3 = _mm_setzero_pd();
+            for (; word < full; ++word) {
+                const auto bits = m_mask[word];
+                if (bits == 0) continue;
+
+                const auto* block = values + word * mask_bits;
+                for (size_t i = 0; i < mask_bits; i += 8) {
+                    const auto mask = [&](size_t offset) {
+                        return _mm_loadu_pd(reinterpret_cast<const double*>(lane_masks<2>[(bits >> (i + offset)) & 0x3].data()));
+                    };
+                    acc0 = _mm_add_pd(acc0, _mm_and_pd(_mm_loadu_pd(block + i + 0), mask(0)));
+                    acc1 = _mm_add_pd(acc1, _mm_and_pd(_mm_loadu_pd(block + i + 2), mask(2)));
+                    acc2 = _mm_add_pd(acc2, _mm_and_pd(_mm_loadu_pd(block + i + 4), mask(4)));
+                    acc3 = _mm_add_pd(acc3, _mm_and_pd(_mm_loadu_pd(block + i + 6), mask(6)));
+                }
+            }
+
+            alignas(16) double lanes[2];
+            _mm_store_pd(lanes, _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3)));
+            result = lanes[0] + lanes[1];
+#endif
+
+            // The last (partial) word, or everything if no SIMD instructions are available
+            for (; word < m_mask.size(); ++word)
+                for (auto bits = m_mask[word]; bits != 0; bits &= bits - 1)
+                    result += values[word * mask_bits + static_cast<size_t>(std::countr_zero(bits))];
+
+            return result;
+        }
+
+    private:
+        size_t                  m_rows = 0;
+        size_t                  m_cols = 0;
+        std::vector<double>     m_values {};
+        std::vector<mask_type>  m_mask {};
+        std::vector<ErrorEntry> m_errors {};
+
+        // Lane masks for N validity bits: lane j of entry k is all ones if bit j of k is set
+        template<size_t N>
+        static constexpr auto lane_masks = [] {
+            std::array<std::array<mask_type, N>, (size_t { 1 } << N)> result {};
+            for (size_t k = 0; k < result.size(); ++k)
+                for (size_t j = 0; j < N; ++j) result[k][j] = ((k >> j) & 1) ? ~mask_type {} : mask_type {};
+            return result;
+        }();
+
+        static constexpr size_t words(size_t count) { return (count + mask_bits - 1) / mask_bits; }
+
+        // The bitmap word with the lowest 'count' bits set
+        static constexpr mask_type mask_bits_for(size_t count) { return count >= mask_bits ? ~mask_type {} : (mask_type { 1 } << count) - 1; }
+
+        static xll::Error make_error(int code)
+        {
+            auto error    = XLOPER12();
+            error.xltype  = xltypeErr;
+            error.val.err = code;
+            return xll::Error(error);
+        }
+
+        void clear_tail()
+        {
+            if (not m_mask.empty()) m_mask.back() &= mask_bits_for(size() - (m_mask.size() - 1) * mask_bits);
+        }
+
+        void check_index(size_t index) const
+        {
+            if (index >= size()) throw std::out_of_range("MaskedArray index out of range");
+        }
+
+        std::vector<ErrorEntry>::iterator find_error(size_t index)
+        {
+            return std::ranges::lower_bound(m_errors, index, {}, &ErrorEntry::index);
+        }
+
+        std::vector<ErrorEntry>::const_iterator find_error(size_t index) const
+        {
+            return std::ranges::lower_bound(m_errors, index, {}, &ErrorEntry::index);
+        }
+    };
+
+}    // namespace xll
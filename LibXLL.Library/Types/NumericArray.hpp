@@ -0,0 +1,199 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <xlcall.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#ifdef _MSC_VER
+#    include <mdspan>
+namespace mds = std;
+#else
+#    include <experimental/mdspan>
+namespace mds = std::experimental;
+#endif
+
+namespace xll
+{
+    /**
+     * @brief A dense, row-major block of doubles with the memory layout of Excel's FP12 structure.
+     *
+     * @details NumericArray is registered with the "K%" type string, so Excel passes numeric ranges
+     * as one contiguous block of doubles instead of one XLOPER12 per cell. The class adds no data
+     * members to FP12 and is only ever handled through pointers: either the argument pointer passed
+     * by Excel, a buffer from NumericArray::make(), or the per-thread return buffer from
+     * NumericArray::result().
+     *
+     * All views (span(), mdspan(), iterators) refer directly to the underlying doubles; no data is
+     * copied or converted.
+     */
+    class NumericArray : public FP12
+    {
+        NumericArray() = default;
+
+        static std::size_t bytes(std::size_t rows, std::size_t cols)
+        {
+            return offsetof(FP12, array) + std::max<std::size_t>(rows * cols, 1) * sizeof(double);
+        }
+
+        static void check_shape(std::size_t rows, std::size_t cols)
+        {
+            if (rows > 1'048'576 || cols > 16'384) throw std::length_error("NumericArray dimensions exceed the Excel grid");
+        }
+
+        static NumericArray* create(void* storage, std::size_t rows, std::size_t cols)
+        {
+            auto* result          = ::new (storage) NumericArray();
+            result->FP12::rows    = static_cast<decltype(FP12::rows)>(rows);
+            result->FP12::columns = static_cast<decltype(FP12::columns)>(cols);
+            return result;
+        }
+
+    public:
+        using value_type = double;
+        using extents_t  = mds::extents<uint32_t, std::dynamic_extent, std::dynamic_extent>;
+
+        struct Deleter
+        {
+            void operator()(NumericArray* ptr) const { ::operator delete(ptr); }
+        };
+
+        NumericArray(const NumericArray&)            = delete;
+        NumericArray& operator=(const NumericArray&) = delete;
+
+        /**
+         * @brief Allocates a NumericArray owned by the caller.
+         *
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @return A unique_ptr owning the (uninitialized) array.
+         * @throws std::length_error if the dimensions exceed the Excel grid.
+         */
+        static std::unique_ptr<NumericArray, Deleter> make(std::size_t rows, std::size_t cols)
+        {
+            check_shape(rows, cols);
+            return std::unique_ptr<NumericArray, Deleter>(create(::operator new(bytes(rows, cols)), rows, cols));
+        }
+
+        /**
+         * @brief Provides a return buffer of the given shape, owned by the calling thread.
+         *
+         * @details Excel does not release FP12 return values, so they must stay valid until Excel has
+         * copied them. The buffer returned here is reused by the next call to result() on the same
+         * thread; it is intended to be filled and returned directly from a UDF.
+         *
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @return A pointer to the (uninitialized) thread-local array.
+         * @throws std::length_error if the dimensions exceed the Excel grid.
+         */
+        static NumericArray* result(std::size_t rows, std::size_t cols)
+        {
+            check_shape(rows, cols);
+
+            thread_local std::vector<double> buffer {};
+            const auto count = (bytes(rows, cols) + sizeof(double) - 1) / sizeof(double);
+            if (buffer.size() < count) buffer.resize(count);
+
+            return create(buffer.data(), rows, cols);
+        }
+
+        /**
+         * @brief Shrinks the array to the given shape, keeping the leading elements in row-major order.
+         *
+         * @details This is used for in-place return (see xll::InPlace), where the result may be smaller
+         * than the argument but never larger.
+         *
+         * @throws std::out_of_range if the new shape holds more elements than the current one.
+         */
+        void resize(std::size_t rows, std::size_t cols)
+        {
+            if (rows * cols > size()) throw std::out_of_range("NumericArray cannot grow in place");
+            FP12::rows    = static_cast<decltype(FP12::rows)>(rows);
+            FP12::columns = static_cast<decltype(FP12::columns)>(cols);
+        }
+
+        [[nodiscard]] std::size_t rows() const { return static_cast<std::size_t>(FP12::rows); }
+
+        [[nodiscard]] std::size_t cols() const { return static_cast<std::size_t>(FP12::columns); }
+
+        [[nodiscard]] std::size_t size() const { return rows() * cols(); }
+
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        [[nodiscard]] double* data() { return FP12::array; }
+
+        [[nodiscard]] const double* data() const { return FP12::array; }
+
+        double*       begin() { return data(); }
+        const double* begin() const { return data(); }
+        double*       end() { return data() + size(); }
+        const double* end() const { return data() + size(); }
+
+        /**
+         * @brief Returns a zero-copy, contiguous view of the elements in row-major order.
+         */
+        [[nodiscard]] std::span<double> span() { return { data(), size() }; }
+
+        [[nodiscard]] std::span<const double> span() const { return { data(), size() }; }
+
+        /**
+         * @brief Returns a zero-copy, two-dimensional (row-major) view of the elements.
+         */
+        [[nodiscard]] mds::mdspan<double, extents_t> mdspan()
+        {
+            return mds::mdspan<double, extents_t>(data(), static_cast<uint32_t>(rows()), static_cast<uint32_t>(cols()));
+        }
+
+        [[nodiscard]] mds::mdspan<const double, extents_t> mdspan() const
+        {
+            return mds::mdspan<const double, extents_t>(data(), static_cast<uint32_t>(rows()), static_cast<uint32_t>(cols()));
+        }
+
+        double& operator[](std::size_t index)
+        {
+            if (index >= size()) throw std::out_of_range("NumericArray index out of range");
+            return data()[index];
+        }
+
+        const double& operator[](std::size_t index) const
+        {
+            if (index >= size()) throw std::out_of_range("NumericArray index out of range");
+            return data()[index];
+        }
+
+        double& operator[](std::size_t row, std::size_t col)
+        {
+            if (row >= rows() || col >= cols()) throw std::out_of_range("NumericArray index out of range");
+            return data()[row * cols() + col];
+        }
+
+        const double& operator[](std::size_t row, std::size_t col) const
+        {
+            if (row >= rows() || col >= cols()) throw std::out_of_range("NumericArray index out of range");
+            return data()[row * cols() + col];
+        }
+    };
+
+    /**
+     * @brief Return type marker for functions that modify their N-th argument in place.
+     *
+     * @details Registering a function with Result<InPlace<N>>() makes Excel treat the (void) function's
+     * N-th argument as its return value. Combined with NumericArray arguments, this allows numeric
+     * results to be written straight into the buffer Excel passed in, without any allocation.
+     */
+    template<unsigned N>
+        requires(N >= 1 && N <= 9)
+    struct InPlace
+    {};
+
+}    // namespace xll
@@ -13,21 +13,151 @@
 #include <xlcall.hpp>
 #include <ranges>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <compare>
+#include <cstdint>
+#include <functional>
 
-#ifndef _WIN32
-#include <utf8.h>
-#endif
+#include "../Utils/Transcode.hpp"
 
 namespace xll
 {
+    namespace impl
+    {
+        template<size_t N>
+        struct FixedString
+        {
+            char data[N] {};
+
+            constexpr FixedString(const char (&str)[N]) { std::copy_n(str, N, data); }    // NOLINT
+
+            constexpr explicit FixedString(const std::array<char, N>& str) { std::copy_n(str.data(), N, data); }
+
+            [[nodiscard]] constexpr std::string_view view() const { return { data, N - 1 }; }
+        };
+
+        /**
+         * @brief A length-prefixed XCHAR buffer, built at compile time from a UTF-8 string literal.
+         */
+        template<FixedString Text>
+        struct StaticString
+        {
+            static constexpr auto buffer = [] {
+                std::array<XCHAR, Text.view().size() + 2> result {};
+                result[0] = static_cast<XCHAR>(utf::from_utf8(Text.view(), result.data() + 1));
+                return result;
+            }();
+        };
+
+        /**
+         * @brief The set of static buffers that Strings may borrow (see String::borrow).
+         *
+         * @details Whether a String borrows its buffer is decided by looking up its pointer here, and never by
+         * anything stored in the XLOPER12 itself, so a string received from Excel can't be mistaken for a
+         * borrowed one. The table is insert-only and lock-free; a buffer that can't be admitted within a few
+         * probes is refused, and the caller makes an owned copy instead.
+         */
+        class BorrowedBuffers
+        {
+            static constexpr std::size_t capacity   = 4096;
+            static constexpr std::size_t max_probes = 16;
+
+            inline static std::array<std::atomic<const XCHAR*>, capacity> m_slots {};
+
+            static std::size_t slot(const XCHAR* buffer) noexcept
+            {
+                return static_cast<std::size_t>((reinterpret_cast<std::uintptr_t>(buffer) >> 1) * 0x9E3779B97F4A7C15ull);
+            }
+
+        public:
+            static bool contains(const XCHAR* buffer) noexcept
+            {
+                const auto first = slot(buffer);
+                for (std::size_t i = 0; i < max_probes; ++i) {
+                    const auto* entry = m_slots[(first + i) % capacity].load(std::memory_order_acquire);
+                    if (entry == buffer) return true;
+                    if (entry == nullptr) return false;
+                }
+                return false;
+            }
+
+            static bool insert(const XCHAR* buffer) noexcept
+            {
+                const auto first = slot(buffer);
+                for (std::size_t i = 0; i < max_probes; ++i) {
+                    const XCHAR* expected = nullptr;
+                    auto&        entry    = m_slots[(first + i) % capacity];
+                    if (entry.compare_exchange_strong(expected, buffer, std::memory_order_acq_rel) || expected == buffer) return true;
+                }
+                return false;
+            }
+        };
+    }    // namespace impl
+
+    class String;
+
+    namespace literals
+    {
+        template<impl::FixedString Text>
+        String operator""_xs();
+    }    // namespace literals
+
     class String : public impl::Base<String, xltypeStr>
     {
         using BASE = impl::Base<String, xltypeStr>;
 
+        template<impl::FixedString Text>
+        friend String literals::operator""_xs();
+
+        // Borrowed strings refer to static storage and are never freed. Only String::borrow (and the default
+        // constructor, for the static empty string) creates them; see impl::BorrowedBuffers.
+        struct BorrowTag
+        {};
+
+        constexpr String(BorrowTag, const XCHAR* buffer) : Base() { val.str = const_cast<XCHAR*>(buffer); }
+
+        constexpr void release()
+        {
+            if (not is_borrowed()) delete[] val.str;
+            val.str = nullptr;
+        }
+
+        constexpr void assign(const String& other)
+        {
+            if (other.is_borrowed())
+                val = other.val;
+            else
+                value() = copy_string(other.val.str).release();
+        }
+
+        // Creates a String that refers to a buffer of impl::StaticString without copying it. The buffer enters
+        // impl::BorrowedBuffers for good, so this is private and only used by the _xs literal: a buffer that is
+        // freed later would make any String allocated at the same address count as borrowed. Should the table
+        // be full, the String owns a copy of the buffer instead.
+        static String borrow(const XCHAR* buffer)
+        {
+            if (impl::BorrowedBuffers::insert(buffer)) return String(BorrowTag {}, buffer);
+
+            auto result    = String(BorrowTag {}, nullptr);
+            result.value() = copy_string(buffer).release();
+            return result;
+        }
+
     public:
         using BASE::BASE;
 
-        constexpr String() : String("") {}
+        constexpr String() : String(BorrowTag {}, impl::StaticString<"">::buffer.data()) {}
+
+        /**
+         * @brief Returns true if the String refers to static storage rather than owning its buffer.
+         */
+        [[nodiscard]] constexpr bool is_borrowed() const
+        {
+            if (val.str == nullptr) return false;
+            if (val.str == impl::StaticString<"">::buffer.data()) return true;
+            return not std::is_constant_evaluated() && impl::BorrowedBuffers::contains(val.str);
+        }
 
         constexpr String(const char* str) : String(std::string_view(str)) {}    // NOLINT
 
@@ -40,7 +170,7 @@ namespace xll
         {
             switch (v.xltype == xltypeStr) {
                 case true:
-                    value() = make_string(to_string(v.val.str)).release();
+                    value() = copy_string(v.val.str).release();
                     break;
                 default:
                     throw std::runtime_error("XLOPER12 type not convertible to type");
@@ -51,7 +181,7 @@ namespace xll
         {
             ensure(other.is_valid());
             ensure(xltype == other.xltype);
-            value() = make_string(to_string(other.val.str)).release();
+            assign(other);
 
             // switch (other.xltype == xltypeStr) {
             //     case true:
@@ -69,7 +199,7 @@ namespace xll
             // ensure(xltype == other.xltype);
 
             xltype = xltypeStr;
-            val.str = other.val.str;
+            val = other.val;
             other.val.str = nullptr;
 
             // using std::swap;
@@ -87,8 +217,7 @@ namespace xll
 
         constexpr ~String()
         {
-            delete[] val.str;
-            val.str = nullptr;
+            release();
         }
 
         constexpr String& operator=(const String& other)
@@ -98,9 +227,8 @@ namespace xll
             ensure(xltype == other.xltype);
 
             if (this == &other) return *this;
-            delete[] val.str;
-            val.str  = nullptr;
-            value() = make_string(to_string(other.val.str)).release();
+            release();
+            assign(other);
             return *this;
         }
 
@@ -115,11 +243,10 @@ namespace xll
 
             if (this == &other) return *this;
 
-            delete[] val.str;
-            val.str = nullptr;
+            release();
 
             xltype = xltypeStr;
-            value() = other.val.str;
+            val = other.val;
             other.val.str = nullptr;
 
             // switch (other.xltype == xltypeStr) {
@@ -167,28 +294,53 @@ namespace xll
             return os;
         }
 
+        /**
+         * @brief Returns a view of the characters (excluding the length prefix), without any conversion.
+         */
+        [[nodiscard]] constexpr std::basic_string_view<XCHAR> view() const
+        {
+            if (val.str == nullptr) return {};
+            return { &val.str[1], static_cast<size_t>(val.str[0]) };
+        }
+
         constexpr friend bool operator==(const String& lhs, const String& rhs) {
-            return to_string(lhs.val.str) == to_string(rhs.val.str);
+            return lhs.view() == rhs.view();
+        }
+
+        constexpr friend bool operator==(const String& lhs, std::basic_string_view<XCHAR> rhs) {
+            return lhs.view() == rhs;
         }
 
         template<typename TOther>
             requires (!std::same_as<String, TOther>) && std::convertible_to<TOther, std::string>
         constexpr friend bool operator==(const String& lhs, TOther&& rhs)
         {
-            return to_string(lhs.val.str) == rhs;
+            if constexpr (std::convertible_to<TOther, std::string_view>)
+                return impl::utf::compare_utf8(lhs.view(), std::string_view(rhs)) == 0;
+            else
+                return impl::utf::compare_utf8(lhs.view(), std::string_view(std::string(std::forward<TOther>(rhs)))) == 0;
         }
 
+        // Strings are ordered by code point, also where XCHAR is UTF-16, which agrees with the comparison with
+        // UTF-8 text below.
+        constexpr friend std::strong_ordering operator<=>(const String& lhs, const String& rhs)
+        {
+            return impl::utf::compare_wide(lhs.view(), rhs.view());
+        }
 
-        constexpr friend auto operator<=>(const String& lhs, const String& rhs)
+        constexpr friend std::strong_ordering operator<=>(const String& lhs, std::basic_string_view<XCHAR> rhs)
         {
-            return to_string(lhs.val.str) <=> to_string(rhs.val.str);
+            return impl::utf::compare_wide(lhs.view(), rhs);
         }
 
         template<typename TOther>
             requires (!std::same_as<String, TOther>) && std::convertible_to<TOther, std::string>
-        constexpr friend auto operator<=>(const String& lhs, TOther&& rhs)
+        constexpr friend std::strong_ordering operator<=>(const String& lhs, TOther&& rhs)
         {
-            return to_string(lhs.val.str) <=> rhs;
+            if constexpr (std::convertible_to<TOther, std::string_view>)
+                return impl::utf::compare_utf8(lhs.view(), std::string_view(rhs));
+            else
+                return impl::utf::compare_utf8(lhs.view(), std::string_view(std::string(std::forward<TOther>(rhs))));
         }
 
         constexpr bool empty() const
@@ -211,8 +363,7 @@ namespace xll
 
         constexpr void clear()
         {
-            delete[] val.str;
-            val.str = nullptr;
+            release();
         }
 
 
@@ -220,94 +371,62 @@ namespace xll
     private:
         constexpr static std::string to_string(XCHAR const* str)
         {
-#ifdef _WIN32
-
-            if (not str or str[0] == '\0') return "";
-
-            const int size = WideCharToMultiByte(CP_UTF8,    // Code page
-                                           0,          // Flags
-                                           &str[1],    // Source wide string
-                                           str[0],     // Source length
-                                           nullptr,    // Destination buffer (null for size calculation)
-                                           0,          // Destination buffer size
-                                           nullptr,    // Default char
-                                           nullptr     // Used default char flag
-            );
-
-            if (size == 0) throw std::runtime_error("String conversion failed");
-
-            // Create the output string with the required size
-            std::string text(size, '\0');
+            if (not str or str[0] == 0) return "";
+            return impl::utf::to_utf8(std::basic_string_view<XCHAR>(&str[1], static_cast<size_t>(str[0])));
+        }
 
-            // Convert the wide string to UTF-8
-            if (WideCharToMultiByte(CP_UTF8, 0, &str[1], str[0], text.data(), size, nullptr, nullptr) == 0) {
-                throw std::runtime_error("String conversion failed");
-            }
+        constexpr static std::unique_ptr<XCHAR[]> copy_string(XCHAR const* str)
+        {
+            const auto size   = str == nullptr ? size_t { 0 } : static_cast<size_t>(str[0]);
+            auto       buffer = std::make_unique_for_overwrite<XCHAR[]>(size + 2);
+            buffer[0]        = static_cast<XCHAR>(size);
+            buffer[size + 1] = 0;
+            if (size > 0) std::copy_n(&str[1], size, &buffer[1]);
 
-            return text;
-#else
-            static_assert(sizeof(wchar_t) == sizeof(char32_t), "wchat_t and char32_t does not have the same size!");
-            auto view = std::u32string(reinterpret_cast<const char32_t*>(&str[1]));
-            auto result = utf8::utf32to8(view);
-            return result;
-#endif
+            return buffer;
         }
 
         constexpr static std::unique_ptr<XCHAR[]> make_string(std::string_view str)
         {
-            if (str.empty()) {
-                // Handle empty string case
-                auto buffer = std::make_unique<XCHAR[]>(2);
-                if (!buffer) throw std::bad_alloc();
-                buffer[0] = 0;
-                buffer[1] = 0;
-                return buffer;
-            }
-
-#ifdef _WIN32
-            // Get required buffer size
-            auto data = str.data();
-            auto sz   = MultiByteToWideChar(CP_UTF8, 0, data, static_cast<int>(str.size()), nullptr, 0);
-            if (sz == 0) throw std::runtime_error("String conversion failed");
-
-            // Allocate memory with proper size and error checking
-            auto buffer = std::make_unique<XCHAR[]>(sz + 2);
-            if (!buffer) throw std::bad_alloc();
+            // A UTF-8 string never needs more UTF-16/UTF-32 code units than it has bytes, so the conversion
+            // can write straight into the final, length-prefixed buffer.
+            auto buffer = std::make_unique_for_overwrite<XCHAR[]>(str.size() + 2);
+            auto size   = impl::utf::from_utf8(str, &buffer[1]);
 
             // Setup the Excel string format (length byte + contents + null terminator)
-            buffer[0]      = static_cast<XCHAR>(sz);
-            buffer[sz + 1] = 0;
-
-            if (MultiByteToWideChar(CP_UTF8, 0, data, static_cast<int>(str.size()), &buffer[1], sz) == 0) {
-                throw std::runtime_error("String conversion failed");
-            }
+            buffer[0]        = static_cast<XCHAR>(size);
+            buffer[size + 1] = 0;
 
             return buffer;
-#else
-            auto input = std::string(str);
-            auto output = utf8::utf8to32(input);
-            auto sz = output.size();
+        }
+    };
 
-            // Allocate memory with proper size and error checking
-            auto buffer = std::make_unique<XCHAR[]>(sz + 2);
-            if (!buffer) throw std::bad_alloc();
+    /**
+     * @brief Transparent hash for String keys, allowing lookup by String, StringRef or XCHAR view without
+     * creating a String (use together with std::equal_to<>).
+     */
+    struct StringHash
+    {
+        using is_transparent = void;
 
-            // Setup the Excel string format (length byte + contents + null terminator)
-            buffer[0]      = static_cast<XCHAR>(sz);
-            buffer[sz + 1] = 0;
+        size_t operator()(std::basic_string_view<XCHAR> str) const noexcept { return std::hash<std::basic_string_view<XCHAR>>()(str); }
 
-            for (int idx = 1; auto c : output) {
-                buffer[idx++] = static_cast<XCHAR>(c);
-            }
-
-            return buffer;
-#endif
-        }
+        size_t operator()(const String& str) const noexcept { return (*this)(str.view()); }
     };
 
     namespace literals
     {
-        inline constexpr String operator""_xs(const char* str, std::size_t len) { return String(std::string_view(str, len)); }
+        /**
+         * @brief Creates a String from a literal, without any allocation or conversion at run time.
+         *
+         * @details The length-prefixed XCHAR buffer is built at compile time and placed in static storage;
+         * the resulting String (and any copy of it) borrows that buffer, which is never freed.
+         */
+        template<impl::FixedString Text>
+        String operator""_xs()
+        {
+            return String::borrow(impl::StaticString<Text>::buffer.data());
+        }
     }    // namespace literals
 
     constexpr inline xll::String trim(const xll::String& str)
@@ -349,3 +468,9 @@ struct std::formatter<xll::String> : std::formatter<std::string> {
         return std::formatter<std::string>::format(str.to_string(), ctx);
     }
 };
+
+template<>
+struct std::hash<xll::String>
+{
+    size_t operator()(const xll::String& str) const noexcept { return xll::StringHash()(str); }
+};
@@ -0,0 +1,122 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include "String.hpp"
+#include "../Utils/Transcode.hpp"
+
+#include <compare>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <xlcall.hpp>
+
+namespace xll
+{
+    /**
+     * @brief A non-owning reference to a length-prefixed Excel string.
+     *
+     * @details StringRef has the same layout as XLOPER12, so it can be used as a UDF argument type in place of
+     * String. It wraps the XCHAR buffer provided by Excel without copying it, and never releases it. Reading,
+     * comparing and hashing works directly on the XCHAR data; conversion to UTF-8 only happens on request
+     * (to_string()).
+     *
+     * A StringRef is only valid as long as the buffer it refers to; Excel's argument buffers are valid for the
+     * duration of the function call. As with other "Q" arguments, Excel passes the cell value as-is, so a
+     * function receiving a StringRef pointer must check that xltype is xltypeStr before using it.
+     */
+    class StringRef : public XLOPER12
+    {
+        static XCHAR* empty_buffer()
+        {
+            static XCHAR buffer[2] = { 0, 0 };
+            return buffer;
+        }
+
+    public:
+        static constexpr int  excel_type    = xltypeStr;
+        static constexpr bool is_plain_data = true;
+
+        using view_type = std::basic_string_view<XCHAR>;
+
+        StringRef() : XLOPER12()
+        {
+            xltype  = xltypeStr;
+            val.str = empty_buffer();
+        }
+
+        /**
+         * @brief Refers to the string held by the given XLOPER12.
+         *
+         * @throws std::runtime_error if the XLOPER12 does not hold a string.
+         */
+        explicit StringRef(const XLOPER12& value) : XLOPER12(value)
+        {
+            if ((value.xltype & ~(xlbitDLLFree | xlbitXLFree)) != xltypeStr) throw std::runtime_error("XLOPER12 type not convertible to type");
+            xltype = xltypeStr;
+            if (val.str == nullptr) val.str = empty_buffer();
+        }
+
+        StringRef(const String& value) : StringRef(static_cast<const XLOPER12&>(value)) {}    // NOLINT
+
+        StringRef(String&&) = delete;
+
+        /**
+         * @brief Returns a view of the characters, excluding the length prefix.
+         */
+        [[nodiscard]] view_type view() const { return { &val.str[1], static_cast<size_t>(val.str[0]) }; }
+
+        operator view_type() const { return view(); }    // NOLINT
+
+        [[nodiscard]] size_t size() const { return static_cast<size_t>(val.str[0]); }
+
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        /**
+         * @brief Converts the string to UTF-8. This is the only operation that allocates.
+         */
+        [[nodiscard]] std::string to_string() const { return impl::utf::to_utf8(view()); }
+
+        explicit operator std::string() const { return to_string(); }
+
+        /**
+         * @brief Creates an owning copy of the string.
+         */
+        [[nodiscard]] String to_owned() const { return String(static_cast<const XLOPER12&>(*this)); }
+
+        friend bool operator==(const StringRef& lhs, const StringRef& rhs) { return lhs.view() == rhs.view(); }
+
+        friend std::strong_ordering operator<=>(const StringRef& lhs, const StringRef& rhs) { return impl::utf::compare_wide(lhs.view(), rhs.view()); }
+
+        friend bool operator==(const StringRef& lhs, const String& rhs) { return lhs.view() == rhs.view(); }
+
+        friend std::strong_ordering operator<=>(const StringRef& lhs, const String& rhs) { return impl::utf::compare_wide(lhs.view(), rhs.view()); }
+
+        friend bool operator==(const StringRef& lhs, view_type rhs) { return lhs.view() == rhs; }
+
+        friend std::strong_ordering operator<=>(const StringRef& lhs, view_type rhs) { return impl::utf::compare_wide(lhs.view(), rhs); }
+
+        /**
+         * @brief Compares with UTF-8 text by code point, without converting either side to a new string.
+         */
+        friend bool operator==(const StringRef& lhs, std::string_view rhs) { return impl::utf::compare_utf8(lhs.view(), rhs) == 0; }
+
+        friend std::strong_ordering operator<=>(const StringRef& lhs, std::string_view rhs) { return impl::utf::compare_utf8(lhs.view(), rhs); }
+
+        friend bool operator==(const StringRef& lhs, const char* rhs) { return lhs == std::string_view(rhs); }
+
+        friend std::strong_ordering operator<=>(const StringRef& lhs, const char* rhs) { return lhs <=> std::string_view(rhs); }
+
+        friend std::ostream& operator<<(std::ostream& os, const StringRef& str) { return os << str.to_string(); }
+    };
+
+}    // namespace xll
+
+template<>
+struct std::hash<xll::StringRef>
+{
+    size_t operator()(const xll::StringRef& str) const noexcept { return xll::StringHash()(str.view()); }
+};
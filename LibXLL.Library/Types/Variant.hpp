@@ -12,7 +12,13 @@
 #include "Number.hpp"
 #include "String.hpp"
 
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <functional>
+#include <new>
+#include <tuple>
+#include <utility>
 #include <variant>
 
 namespace xll
@@ -51,7 +57,7 @@ namespace xll
     constexpr const U& get(const Variant<T, Ts...>& v);
 
     template<typename Visitor, typename T, typename... Ts>
-    constexpr auto visit(Visitor&& vis, const Variant<T, Ts...>& va);
+    constexpr decltype(auto) visit(Visitor&& vis, const Variant<T, Ts...>& va);
 
     template<class... Ts>
     struct overload : Ts...
@@ -72,230 +78,136 @@ namespace xll
         // Bit pattern for the xltype field of the XLOPER12 structure
         static constexpr size_t excel_type = xltypeMissing | T::excel_type | (Ts::excel_type | ...);
 
-        constexpr Variant() : XLOPER12()
-        {
-            xltype = T().xltype;
-            reinterpret_cast<T&>(*this) = T();
-        }
+        // True if none of the alternatives own memory, i.e. the Variant can be copied as a raw XLOPER12
+        static constexpr bool is_plain_data = impl::plain_data<T> && (impl::plain_data<Ts> && ...);
+
+        constexpr Variant() : XLOPER12() { ::new (static_cast<void*>(this)) T(); }
 
         template<typename U>
             requires(std::same_as<U, xll::Missing> || std::same_as<U, T> || (std::same_as<U, Ts> || ...))
-        constexpr Variant(const U& u) : Variant()    // NOLINT
+        constexpr Variant(const U& u) : XLOPER12()    // NOLINT
         {
-            if constexpr (std::same_as<U, xll::Missing>) {
-                xltype                             = xll::Nil().xltype;
-                reinterpret_cast<xll::Nil&>(*this) = xll::Nil();
-            }
-            else {
-                xltype                      = u.xltype;
-                reinterpret_cast<U&>(*this) = u;
-            }
+            copy_from(u);
         }
 
         template<typename U>
             requires(std::same_as<U, xll::Missing> || std::same_as<U, T> || (std::same_as<U, Ts> || ...))
-        constexpr Variant(U&& u) noexcept : Variant()   // NOLINT
+        constexpr Variant(U&& u) noexcept : XLOPER12()    // NOLINT
         {
-            if constexpr (std::same_as<U, xll::Missing>) {
-                xltype                             = xll::Nil().xltype;
-                reinterpret_cast<xll::Nil&>(*this) = xll::Nil();
-            }
-            else {
-                xltype                      = u.xltype;
-                reinterpret_cast<U&>(*this) = std::move(u);
-            }
+            relocate_from(u);
         }
 
-        constexpr Variant(const Variant& v) : Variant()
-        {
-            xltype = v.xltype;
-
-            if constexpr ((std::same_as<xll::Bool, T> || (std::same_as<xll::Bool, Ts> || ...)))
-                if (xll::holds_alternative<xll::Bool>(v))
-                    xll::get<xll::Bool>(*this) = xll::get<xll::Bool>(v);
-
-            if constexpr ((std::same_as<xll::Error, T> || (std::same_as<xll::Error, Ts> || ...)))
-                if (xll::holds_alternative<xll::Error>(v))
-                    xll::get<xll::Error>(*this) = xll::get<xll::Error>(v);
+        constexpr Variant(const Variant& v) : XLOPER12() { copy_from(v); }
 
-            if constexpr ((std::same_as<xll::Int, T> || (std::same_as<xll::Int, Ts> || ...)))
-                if (xll::holds_alternative<xll::Int>(v))
-                    xll::get<xll::Int>(*this) = xll::get<xll::Int>(v);
+        constexpr Variant(Variant&& v) noexcept : XLOPER12() { relocate_from(v); }
 
-            if constexpr ((std::same_as<xll::Number, T> || (std::same_as<xll::Number, Ts> || ...)))
-                if (xll::holds_alternative<xll::Number>(v))
-                    xll::get<xll::Number>(*this) = xll::get<xll::Number>(v);
+        constexpr ~Variant() { destroy(); }
 
-            if constexpr ((std::same_as<xll::String, T> || (std::same_as<xll::String, Ts> || ...)))
-                if (xll::holds_alternative<xll::String>(v))
-                    xll::get<xll::String>(*this) = xll::get<xll::String>(v);
-
-            if constexpr ((std::same_as<xll::Nil, T> || (std::same_as<xll::Nil, Ts> || ...)))
-                if (xll::holds_alternative<xll::Nil>(v))
-                    xll::get<xll::Nil>(*this) = xll::get<xll::Nil>(v);
-        }
-
-        constexpr Variant(Variant&& v) noexcept : Variant()
+        constexpr Variant& operator=(const Variant& v)
         {
-            xltype = v.xltype;
-
-            if constexpr ((std::same_as<xll::Bool, T> || (std::same_as<xll::Bool, Ts> || ...)))
-                if (xll::holds_alternative<xll::Bool>(v))
-                    xll::get<xll::Bool>(*this) = xll::get<xll::Bool>(v);
-
-            if constexpr ((std::same_as<xll::Error, T> || (std::same_as<xll::Error, Ts> || ...)))
-                if (xll::holds_alternative<xll::Error>(v))
-                    xll::get<xll::Error>(*this) = xll::get<xll::Error>(v);
-
-            if constexpr ((std::same_as<xll::Int, T> || (std::same_as<xll::Int, Ts> || ...)))
-                if (xll::holds_alternative<xll::Int>(v))
-                    xll::get<xll::Int>(*this) = xll::get<xll::Int>(v);
-
-            if constexpr ((std::same_as<xll::Number, T> || (std::same_as<xll::Number, Ts> || ...)))
-                if (xll::holds_alternative<xll::Number>(v))
-                    xll::get<xll::Number>(*this) = xll::get<xll::Number>(v);
-
-            if constexpr ((std::same_as<xll::String, T> || (std::same_as<xll::String, Ts> || ...)))
-                if (xll::holds_alternative<xll::String>(v))
-                    xll::get<xll::String>(*this) = xll::get<xll::String>(v);
-
-            if constexpr ((std::same_as<xll::Nil, T> || (std::same_as<xll::Nil, Ts> || ...)))
-                if (xll::holds_alternative<xll::Nil>(v))
-                    xll::get<xll::Nil>(*this) = xll::get<xll::Nil>(v);
+            if (this == &v) return *this;
+            destroy();
+            copy_from(v);
+            return *this;
         }
 
-        constexpr ~Variant()
+        constexpr Variant& operator=(Variant&& v) noexcept
         {
-            if constexpr ((std::same_as<xll::Bool, T> || (std::same_as<xll::Bool, Ts> || ...)))
-                if (xll::holds_alternative<xll::Bool>(*this))
-                    xll::get<xll::Bool>(*this).~Bool();
-
-            if constexpr ((std::same_as<xll::Error, T> || (std::same_as<xll::Error, Ts> || ...)))
-                if (xll::holds_alternative<xll::Error>(*this))
-                    xll::get<xll::Error>(*this).~Error();
-
-            if constexpr ((std::same_as<xll::Int, T> || (std::same_as<xll::Int, Ts> || ...)))
-                if (xll::holds_alternative<xll::Int>(*this))
-                    xll::get<xll::Int>(*this).~Int();
-
-            if constexpr ((std::same_as<xll::Number, T> || (std::same_as<xll::Number, Ts> || ...)))
-                if (xll::holds_alternative<xll::Number>(*this))
-                    xll::get<xll::Number>(*this).~Number();
-
-            if constexpr ((std::same_as<xll::String, T> || (std::same_as<xll::String, Ts> || ...)))
-                if (xll::holds_alternative<xll::String>(*this))
-                    xll::get<xll::String>(*this).~String();
-
-            if constexpr ((std::same_as<xll::Nil, T> || (std::same_as<xll::Nil, Ts> || ...)))
-                if (xll::holds_alternative<xll::Nil>(*this))
-                    xll::get<xll::Nil>(*this).~Nil();
-
-            static_cast<XLOPER12&>(*this) = XLOPER12();
+            if (this == &v) return *this;
+            destroy();
+            relocate_from(v);
+            return *this;
         }
 
-        constexpr Variant& operator=(const Variant& v)
+        template<typename U>
+            requires(std::same_as<U, xll::Missing> || std::same_as<U, T> || (std::same_as<U, Ts> || ...))
+        constexpr Variant& operator=(const U& u)
         {
-            this->~Variant();
-            static_cast<XLOPER12&>(*this) = XLOPER12();
-            xltype = v.xltype;
-
-            if constexpr ((std::same_as<xll::Bool, T> || (std::same_as<xll::Bool, Ts> || ...)))
-                if (xll::holds_alternative<xll::Bool>(v))
-                    xll::get<xll::Bool>(*this) = xll::get<xll::Bool>(v);
-
-            if constexpr ((std::same_as<xll::Error, T> || (std::same_as<xll::Error, Ts> || ...)))
-                if (xll::holds_alternative<xll::Error>(v))
-                    xll::get<xll::Error>(*this) = xll::get<xll::Error>(v);
-
-            if constexpr ((std::same_as<xll::Int, T> || (std::same_as<xll::Int, Ts> || ...)))
-                if (xll::holds_alternative<xll::Int>(v))
-                    xll::get<xll::Int>(*this) = xll::get<xll::Int>(v);
-
-            if constexpr ((std::same_as<xll::Number, T> || (std::same_as<xll::Number, Ts> || ...)))
-                if (xll::holds_alternative<xll::Number>(v))
-                    xll::get<xll::Number>(*this) = xll::get<xll::Number>(v);
-
-            if constexpr ((std::same_as<xll::String, T> || (std::same_as<xll::String, Ts> || ...)))
-                if (xll::holds_alternative<xll::String>(v))
-                    xll::get<xll::String>(*this) = xll::get<xll::String>(v);
-
-            if constexpr ((std::same_as<xll::Nil, T> || (std::same_as<xll::Nil, Ts> || ...)))
-                if (xll::holds_alternative<xll::Nil>(v))
-                    xll::get<xll::Nil>(*this) = xll::get<xll::Nil>(v);
-
+            if (static_cast<const XLOPER12*>(&u) == static_cast<const XLOPER12*>(this)) return *this;
+            destroy();
+            copy_from(u);
             return *this;
         }
 
-        constexpr Variant& operator=(Variant&& v) noexcept
+        template<typename U>
+            requires(std::same_as<U, xll::Missing> || std::same_as<U, T> || (std::same_as<U, Ts> || ...))
+        constexpr Variant& operator=(U&& u) noexcept
         {
-            this->~Variant();
-            static_cast<XLOPER12&>(*this) = XLOPER12();
-            xltype = v.xltype;
-
-            if constexpr ((std::same_as<xll::Bool, T> || (std::same_as<xll::Bool, Ts> || ...)))
-                if (xll::holds_alternative<xll::Bool>(v))
-                    xll::get<xll::Bool>(*this) = xll::get<xll::Bool>(v);
-
-            if constexpr ((std::same_as<xll::Error, T> || (std::same_as<xll::Error, Ts> || ...)))
-                if (xll::holds_alternative<xll::Error>(v))
-                    xll::get<xll::Error>(*this) = xll::get<xll::Error>(v);
-
-            if constexpr ((std::same_as<xll::Int, T> || (std::same_as<xll::Int, Ts> || ...)))
-                if (xll::holds_alternative<xll::Int>(v))
-                    xll::get<xll::Int>(*this) = xll::get<xll::Int>(v);
-
-            if constexpr ((std::same_as<xll::Number, T> || (std::same_as<xll::Number, Ts> || ...)))
-                if (xll::holds_alternative<xll::Number>(v))
-                    xll::get<xll::Number>(*this) = xll::get<xll::Number>(v);
-
-            if constexpr ((std::same_as<xll::String, T> || (std::same_as<xll::String, Ts> || ...)))
-                if (xll::holds_alternative<xll::String>(v))
-                    xll::get<xll::String>(*this) = xll::get<xll::String>(v);
+            if (static_cast<const XLOPER12*>(&u) == static_cast<const XLOPER12*>(this)) return *this;
+            destroy();
+            relocate_from(u);
+            return *this;
+        }
 
-            if constexpr ((std::same_as<xll::Nil, T> || (std::same_as<xll::Nil, Ts> || ...)))
-                if (xll::holds_alternative<xll::Nil>(v))
-                    xll::get<xll::Nil>(*this) = xll::get<xll::Nil>(v);
+    private:
+        // The copy, move and destroy operations below dispatch on xltype once. Alternatives that don't own memory
+        // are copied and relocated bitwise; only an owning alternative (i.e. String) runs its own constructor or
+        // destructor. For a Variant of plain alternatives, the checks are compiled away entirely.
 
-            return *this;
+        static constexpr bool is_owning(decltype(XLOPER12::xltype) type)
+        {
+            return ((not impl::plain_data<T> && type == T::excel_type) || ... || (not impl::plain_data<Ts> && type == Ts::excel_type));
         }
 
         template<typename U>
-            requires(std::same_as<U, xll::Missing> || std::same_as<U, T> || (std::same_as<U, Ts> || ...))
-        constexpr Variant& operator=(const U& u)
+        constexpr bool copy_owning(const XLOPER12& v)
         {
-            this->~Variant();
-            static_cast<XLOPER12&>(*this)          = XLOPER12();
-
-            if constexpr (std::same_as<U, xll::Missing>) {
-                xltype                             = xll::Nil().xltype;
-                reinterpret_cast<xll::Nil&>(*this) = xll::Nil();
-            }
+            if constexpr (impl::plain_data<U>)
+                return false;
             else {
-                xltype                      = u.xltype;
-                reinterpret_cast<U&>(*this) = u;
+                if (v.xltype != U::excel_type) return false;
+
+                // Leave a valid (Nil) state behind, should the copy throw
+                static_cast<XLOPER12&>(*this) = XLOPER12();
+                xltype                        = xltypeNil;
+                ::new (static_cast<void*>(this)) U(reinterpret_cast<const U&>(v));
+                return true;
             }
+        }
 
-            return *this;
+        // Initialises the (destroyed or uninitialised) storage as a copy of v. Missing is stored as Nil.
+        constexpr void copy_from(const XLOPER12& v)
+        {
+            if constexpr (not is_plain_data)
+                if (copy_owning<T>(v) || (copy_owning<Ts>(v) || ...)) return;
+
+            static_cast<XLOPER12&>(*this) = v;
+            if (xltype == xltypeMissing) xltype = xltypeNil;
         }
 
-        template<typename U>
-            requires(std::same_as<U, xll::Missing> || std::same_as<U, T> || (std::same_as<U, Ts> || ...))
-        constexpr Variant& operator=(U&& u) noexcept
+        // Takes over the value of v bitwise. An owning alternative is detached from v, which is left holding an
+        // empty value of the same type (the same state as a moved-from String).
+        constexpr void relocate_from(XLOPER12& v) noexcept
         {
-            this->~Variant();
-            static_cast<XLOPER12&>(*this) = XLOPER12();
+            static_cast<XLOPER12&>(*this) = v;
+            if (xltype == xltypeMissing) xltype = xltypeNil;
+
+            if constexpr (not is_plain_data)
+                if (is_owning(v.xltype)) {
+                    const auto type = v.xltype;
+                    v               = XLOPER12();
+                    v.xltype        = type;
+                }
+        }
 
-            if constexpr (std::same_as<U, xll::Missing>) {
-                xltype                             = xll::Nil().xltype;
-                reinterpret_cast<xll::Nil&>(*this) = xll::Nil();
-            }
+        template<typename U>
+        constexpr bool destroy_owning()
+        {
+            if constexpr (impl::plain_data<U>)
+                return false;
             else {
-                xltype                      = u.xltype;
-                reinterpret_cast<U&>(*this) = std::move(u);
+                if (xltype != U::excel_type) return false;
+                reinterpret_cast<U&>(*this).~U();
+                return true;
             }
+        }
 
-            return *this;
+        constexpr void destroy()
+        {
+            if constexpr (not is_plain_data) static_cast<void>(destroy_owning<T>() || (destroy_owning<Ts>() || ...));
         }
+
+    public:
         // template<typename T>
         //     requires impl::is_valid_type<T>
         // Variant& operator=(T&& t) noexcept
@@ -347,34 +259,105 @@ namespace xll
         return reinterpret_cast<const U&>(v);
     }
 
-    template<typename Visitor, typename T, typename... Ts>
-    constexpr auto visit(Visitor&& vis, const Variant<T, Ts...>& va)
+    namespace impl
     {
-        if constexpr (std::same_as<xll::Bool, T> || (std::same_as<xll::Bool, Ts> || ...))
-            if (holds_alternative<xll::Bool>(va))
-                return std::invoke(std::forward<Visitor>(vis), get<xll::Bool>(va));
-
-        if constexpr (std::same_as<xll::Error, T> || (std::same_as<xll::Error, Ts> || ...))
-            if (holds_alternative<xll::Error>(va))
-                return std::invoke(std::forward<Visitor>(vis), get<xll::Error>(va));
+        /**
+         * @brief Maps the xltype of a Variant to the index of its alternative, for table-based dispatch.
+         *
+         * @details Each Excel type is a single bit in the lower 12 bits of xltype, so the position of that bit
+         * indexes a small lookup table. Missing maps to the Nil alternative; anything else maps to npos.
+         */
+        template<typename... Ts>
+        struct VariantIndex
+        {
+            static constexpr size_t npos = sizeof...(Ts);
+
+            static constexpr auto table = [] {
+                std::array<uint8_t, 12> result {};
+                result.fill(static_cast<uint8_t>(npos));
+
+                uint8_t index = 0;
+                ((result[std::countr_zero(static_cast<unsigned>(Ts::excel_type))] = index++), ...);
+                result[std::countr_zero(static_cast<unsigned>(xltypeMissing))] = result[std::countr_zero(static_cast<unsigned>(xltypeNil))];
+                return result;
+            }();
+
+            static constexpr size_t of(decltype(XLOPER12::xltype) type)
+            {
+                const auto bit = std::countr_zero(static_cast<unsigned>(type));
+                if (bit >= static_cast<int>(table.size()) || type != (1u << bit)) return npos;
+                return table[bit];
+            }
+        };
+
+        template<size_t I, typename... Us>
+        using nth_type = std::tuple_element_t<I, std::tuple<Us...>>;
+
+        /**
+         * @brief Calls func with the value reinterpreted as alternative number 'index' of Us.
+         *
+         * @details The dense switch is compiled to a jump table, and (unlike a table of function pointers) lets
+         * the compiler inline the call for each alternative. A Variant has at most six alternatives.
+         */
+        template<typename... Us, typename TFunc>
+        constexpr decltype(auto) dispatch(size_t index, const XLOPER12& value, TFunc&& func)
+        {
+            static_assert(sizeof...(Us) <= 6);
+
+            // clang-format off
+            switch (index) {
+                case 0: return std::invoke(std::forward<TFunc>(func), reinterpret_cast<const nth_type<0, Us...>&>(value));
+                case 1: if constexpr (sizeof...(Us) > 1) return std::invoke(std::forward<TFunc>(func), reinterpret_cast<const nth_type<1, Us...>&>(value)); else std::unreachable();
+                case 2: if constexpr (sizeof...(Us) > 2) return std::invoke(std::forward<TFunc>(func), reinterpret_cast<const nth_type<2, Us...>&>(value)); else std::unreachable();
+                case 3: if constexpr (sizeof...(Us) > 3) return std::invoke(std::forward<TFunc>(func), reinterpret_cast<const nth_type<3, Us...>&>(value)); else std::unreachable();
+                case 4: if constexpr (sizeof...(Us) > 4) return std::invoke(std::forward<TFunc>(func), reinterpret_cast<const nth_type<4, Us...>&>(value)); else std::unreachable();
+                case 5: if constexpr (sizeof...(Us) > 5) return std::invoke(std::forward<TFunc>(func), reinterpret_cast<const nth_type<5, Us...>&>(value)); else std::unreachable();
+                default: std::unreachable();
+            }
+            // clang-format on
+        }
+    }    // namespace impl
 
-        if constexpr (std::same_as<xll::Int, T> || (std::same_as<xll::Int, Ts> || ...))
-            if (holds_alternative<xll::Int>(va))
-                return std::invoke(std::forward<Visitor>(vis), get<xll::Int>(va));
+    /**
+     * @brief Calls the visitor with the alternative held by the Variant.
+     *
+     * @details The alternative is found with a single xltype-indexed table lookup, followed by a jump table.
+     * As with std::visit, the visitor must return the same type for all alternatives.
+     *
+     * @throws std::bad_variant_access if the Variant does not hold any of its alternatives.
+     */
+    template<typename Visitor, typename T, typename... Ts>
+    constexpr decltype(auto) visit(Visitor&& vis, const Variant<T, Ts...>& va)
+    {
+        using index_type = impl::VariantIndex<T, Ts...>;
 
-        if constexpr (std::same_as<xll::Number, T> || (std::same_as<xll::Number, Ts> || ...))
-            if (holds_alternative<xll::Number>(va))
-                return std::invoke(std::forward<Visitor>(vis), get<xll::Number>(va));
+        const auto index = index_type::of(va.xltype);
+        if (index == index_type::npos) throw std::bad_variant_access();
+        return impl::dispatch<T, Ts...>(index, va, std::forward<Visitor>(vis));
+    }
 
-        if constexpr (std::same_as<xll::String, T> || (std::same_as<xll::String, Ts> || ...))
-            if (holds_alternative<xll::String>(va))
-                return std::invoke(std::forward<Visitor>(vis), get<xll::String>(va));
+    /**
+     * @brief Calls the visitor with the alternatives held by two Variants, e.g. for element-wise operations on
+     * mixed ranges.
+     *
+     * @details Both alternatives are found with xltype-indexed lookups, so the cost does not depend on the number
+     * of combinations. The visitor must return the same type for all combinations.
+     *
+     * @throws std::bad_variant_access if either Variant does not hold any of its alternatives.
+     */
+    template<typename Visitor, typename T, typename... Ts, typename U, typename... Us>
+    constexpr decltype(auto) visit(Visitor&& vis, const Variant<T, Ts...>& va, const Variant<U, Us...>& vb)
+    {
+        using left_index  = impl::VariantIndex<T, Ts...>;
+        using right_index = impl::VariantIndex<U, Us...>;
 
-        if constexpr (std::same_as<xll::Nil, T> || (std::same_as<xll::Nil, Ts> || ...))
-            if (holds_alternative<xll::Nil>(va))
-                return std::invoke(std::forward<Visitor>(vis), get<xll::Nil>(va));
+        const auto left  = left_index::of(va.xltype);
+        const auto right = right_index::of(vb.xltype);
+        if (left == left_index::npos || right == right_index::npos) throw std::bad_variant_access();
 
-        throw std::bad_variant_access();
+        return impl::dispatch<T, Ts...>(left, va, [&](const auto& a) -> decltype(auto) {
+            return impl::dispatch<U, Us...>(right, vb, [&](const auto& b) -> decltype(auto) { return std::invoke(std::forward<Visitor>(vis), a, b); });
+        });
     }
 
 }    // namespace xll
\ No newline at end of file
@@ -0,0 +1,348 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <xlcall.hpp>
+
+#include "Transcode.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+namespace xll
+{
+
+    /**
+     * @brief Packs return values into single contiguous blocks that can be released in one operation.
+     *
+     * @details A regular Array result consists of one allocation for the XLOPER12 buffer plus one for every
+     * string cell, all of which have to be released individually by xlAutoFree12. An Arena block is laid out as
+     *
+     *     [ XLOPER12 header | XLOPER12 cells... | XCHAR string payloads... ]
+     *
+     * with all internal pointers referring into the block itself. The block is recorded in a registry, so
+     * that xlAutoFree12 can recognise it and release it with a single deallocation.
+     *
+     * Large results should be built in this form directly with xll::ArenaArray, which needs no allocation per
+     * string at all. pack() converts a value that has already been built (any Array or String, regardless of the
+     * element type), at the cost of copying it.
+     */
+    class Arena
+    {
+        Arena()  = default;
+        ~Arena() = default;
+
+        std::unordered_set<const void*> m_blocks {};
+        std::mutex                      m_mutex;
+
+        static std::size_t payload_size(const XLOPER12& cell)
+        {
+            if ((cell.xltype & ~(xlbitDLLFree | xlbitXLFree)) != xltypeStr || cell.val.str == nullptr) return 0;
+            return static_cast<std::size_t>(cell.val.str[0]) + 2;
+        }
+
+        static void copy_cell(const XLOPER12& source, XLOPER12& target, XCHAR*& payload)
+        {
+            target = source;
+            if (const auto size = payload_size(source); size > 0) {
+                std::copy_n(source.val.str, size - 1, payload);
+                payload[size - 1] = 0;
+                target.val.str    = payload;
+                payload += size;
+            }
+        }
+
+    public:
+        Arena(const Arena&)            = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        static Arena& instance()
+        {
+            static Arena arena;
+            return arena;
+        }
+
+        /**
+         * @brief Takes over a block built by ArenaArray, so that release() recognises it.
+         */
+        void adopt(XLOPER12* block)
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_blocks.insert(block);
+        }
+
+        /**
+         * @brief Copies a value (and everything it points to) into a single contiguous block.
+         *
+         * @param value The value to copy. Multi-cell arrays and strings are packed; other types are copied as-is.
+         * @return A pointer to the packed XLOPER12, flagged with xlbitDLLFree.
+         * @throws std::bad_alloc if the allocation fails.
+         */
+        LPXLOPER12 pack(const XLOPER12& value)
+        {
+            const auto type  = value.xltype & ~(xlbitDLLFree | xlbitXLFree);
+            const auto cells = (type == xltypeMulti && value.val.array.lparray != nullptr)
+                                   ? static_cast<std::size_t>(value.val.array.rows) * static_cast<std::size_t>(value.val.array.columns)
+                                   : std::size_t { 0 };
+
+            auto chars = payload_size(value);
+            for (std::size_t i = 0; i < cells; ++i) chars += payload_size(value.val.array.lparray[i]);
+
+            auto* block   = static_cast<XLOPER12*>(::operator new((1 + cells) * sizeof(XLOPER12) + chars * sizeof(XCHAR)));
+            auto* payload = reinterpret_cast<XCHAR*>(block + 1 + cells);
+
+            copy_cell(value, block[0], payload);
+            if (type == xltypeMulti) {
+                block[0].val.array.lparray = cells > 0 ? block + 1 : nullptr;
+                for (std::size_t i = 0; i < cells; ++i) copy_cell(value.val.array.lparray[i], block[1 + i], payload);
+            }
+            block[0].xltype = type | xlbitDLLFree;
+
+            try {
+                adopt(block);
+            }
+            catch (...) {
+                ::operator delete(block);
+                throw;
+            }
+            return block;
+        }
+
+        /**
+         * @brief Releases a block created by pack().
+         *
+         * @param ptr The pointer returned by pack().
+         * @return true if the pointer was an Arena block (and has been released), false otherwise.
+         */
+        bool release(LPXLOPER12 ptr)
+        {
+            {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_blocks.erase(ptr) == 0) return false;
+            }
+
+            ::operator delete(ptr);
+            return true;
+        }
+
+        /**
+         * @brief Returns the number of blocks that have been handed out, but not yet released.
+         */
+        std::size_t size()
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            return m_blocks.size();
+        }
+    };
+
+    /**
+     * @brief Builds an array result directly in the packed form used by the Arena.
+     *
+     * @details Cells and string payloads are written straight into a single block, which grows geometrically
+     * when the strings don't fit (passing the expected number of characters to the constructor avoids that). Building an R x C array of strings therefore takes a handful of allocations
+     * rather than one per string, and handing the result to Excel copies nothing. Cells that are not set are Nil;
+     * setting a string cell a second time leaves the space of the first string unused.
+     *
+     * @code
+     * auto result = xll::ArenaArray(names.size(), 1);
+     * for (size_t i = 0; i < names.size(); ++i) result.set(i, 0, names[i]);
+     * return std::move(result) | xll::ArenaFree();
+     * @endcode
+     */
+    class ArenaArray
+    {
+        XLOPER12*   m_block    = nullptr;
+        std::size_t m_rows     = 0;
+        std::size_t m_columns  = 0;
+        std::size_t m_used     = 0;    // XCHARs of string payload written so far
+        std::size_t m_capacity = 0;    // XCHARs of string payload the block has room for
+
+        [[nodiscard]] std::size_t cell_count() const { return m_rows * m_columns; }
+
+        [[nodiscard]] XLOPER12* cells() const { return m_block + 1; }
+
+        [[nodiscard]] XCHAR* payload() const { return reinterpret_cast<XCHAR*>(m_block + 1 + cell_count()); }
+
+        static XLOPER12* allocate(std::size_t cells, std::size_t chars)
+        {
+            return static_cast<XLOPER12*>(::operator new((1 + cells) * sizeof(XLOPER12) + chars * sizeof(XCHAR)));
+        }
+
+        [[nodiscard]] std::size_t index(std::size_t row, std::size_t column) const
+        {
+            if (row >= m_rows || column >= m_columns) throw std::out_of_range("ArenaArray: Index out of range");
+            return row * m_columns + column;
+        }
+
+        // Makes room for a string of (at most) the given number of characters, and returns where to write it.
+        // Growing moves the block, so references to cells taken before the call are invalidated.
+        XCHAR* reserve(std::size_t chars)
+        {
+            const auto needed = m_used + chars + 2;
+            if (needed <= m_capacity) return payload() + m_used;
+
+            // The first string suggests that there will be more: make room for a short string (up to 14 characters)
+            // in every cell.
+            const auto capacity = std::max({ needed, 2 * m_capacity, 16 * cell_count() });
+            auto*      block    = allocate(cell_count(), capacity);
+            std::memcpy(static_cast<void*>(block), m_block, (1 + cell_count()) * sizeof(XLOPER12) + m_used * sizeof(XCHAR));
+
+            const auto* source = payload();
+            auto*       target = reinterpret_cast<XCHAR*>(block + 1 + cell_count());
+            for (std::size_t i = 0; i < cell_count(); ++i)
+                if (block[1 + i].xltype == xltypeStr) block[1 + i].val.str = target + (block[1 + i].val.str - source);
+
+            ::operator delete(m_block);
+            m_block    = block;
+            m_capacity = capacity;
+            return target + m_used;
+        }
+
+        void assign_string(std::size_t at, XCHAR* buffer, std::size_t size)
+        {
+            buffer[0]        = static_cast<XCHAR>(size);
+            buffer[size + 1] = 0;
+            m_used += size + 2;
+
+            auto& cell   = cells()[at];
+            cell         = XLOPER12();
+            cell.xltype  = xltypeStr;
+            cell.val.str = buffer;
+        }
+
+    public:
+        /**
+         * @brief Creates an array of Nil cells.
+         *
+         * @param rows The number of rows.
+         * @param columns The number of columns.
+         * @param chars The total number of string characters to make room for up front (optional).
+         */
+        ArenaArray(std::size_t rows, std::size_t columns, std::size_t chars = 0)
+            : m_block(allocate(rows * columns, chars)),
+              m_rows(rows),
+              m_columns(columns),
+              m_capacity(chars)
+        {
+            m_block[0]                   = XLOPER12();
+            m_block[0].xltype            = xltypeMulti;
+            m_block[0].val.array.rows    = static_cast<decltype(XLOPER12::val.array.rows)>(rows);
+            m_block[0].val.array.columns = static_cast<decltype(XLOPER12::val.array.columns)>(columns);
+            for (std::size_t i = 0; i < cell_count(); ++i) {
+                cells()[i]        = XLOPER12();
+                cells()[i].xltype = xltypeNil;
+            }
+        }
+
+        ArenaArray(ArenaArray&& other) noexcept
+            : m_block(std::exchange(other.m_block, nullptr)),
+              m_rows(other.m_rows),
+              m_columns(other.m_columns),
+              m_used(other.m_used),
+              m_capacity(other.m_capacity)
+        {}
+
+        ArenaArray& operator=(ArenaArray&& other) noexcept
+        {
+            if (this == &other) return *this;
+            ::operator delete(m_block);
+            m_block    = std::exchange(other.m_block, nullptr);
+            m_rows     = other.m_rows;
+            m_columns  = other.m_columns;
+            m_used     = other.m_used;
+            m_capacity = other.m_capacity;
+            return *this;
+        }
+
+        ArenaArray(const ArenaArray&)            = delete;
+        ArenaArray& operator=(const ArenaArray&) = delete;
+
+        ~ArenaArray() { ::operator delete(m_block); }
+
+        [[nodiscard]] std::size_t rows() const { return m_rows; }
+
+        [[nodiscard]] std::size_t columns() const { return m_columns; }
+
+        /**
+         * @brief Returns a cell; the reference is invalidated by the next string that is set.
+         */
+        [[nodiscard]] const XLOPER12& at(std::size_t row, std::size_t column) const { return cells()[index(row, column)]; }
+
+        void set(std::size_t row, std::size_t column, double value)
+        {
+            auto& cell   = cells()[index(row, column)];
+            cell         = XLOPER12();
+            cell.xltype  = xltypeNum;
+            cell.val.num = value;
+        }
+
+        /**
+         * @brief Sets a string cell from UTF-8 text, converting it straight into the block.
+         */
+        void set(std::size_t row, std::size_t column, std::string_view value)
+        {
+            const auto at     = index(row, column);
+            auto*      buffer = reserve(value.size());
+            assign_string(at, buffer, impl::utf::from_utf8(value, buffer + 1));
+        }
+
+        void set(std::size_t row, std::size_t column, std::basic_string_view<XCHAR> value)
+        {
+            const auto at     = index(row, column);
+            auto*      buffer = reserve(value.size());
+            std::copy_n(value.data(), value.size(), buffer + 1);
+            assign_string(at, buffer, value.size());
+        }
+
+        /**
+         * @brief Sets a cell from a scalar XLOPER12 (e.g. a Number, String, Bool, Int, Error or Variant).
+         *
+         * @throws std::invalid_argument if the value is an array or a reference.
+         */
+        void set(std::size_t row, std::size_t column, const XLOPER12& value)
+        {
+            switch (const auto type = value.xltype & ~(xlbitDLLFree | xlbitXLFree)) {
+                case xltypeStr:
+                    if (value.val.str == nullptr)
+                        set(row, column, std::basic_string_view<XCHAR>());
+                    else
+                        set(row, column, std::basic_string_view<XCHAR>(value.val.str + 1, static_cast<std::size_t>(value.val.str[0])));
+                    break;
+                case xltypeNum:
+                case xltypeBool:
+                case xltypeErr:
+                case xltypeInt:
+                case xltypeNil:
+                case xltypeMissing: {
+                    auto& cell  = cells()[index(row, column)];
+                    cell        = value;
+                    cell.xltype = type == xltypeMissing ? xltypeNil : type;
+                    break;
+                }
+                default:
+                    throw std::invalid_argument("ArenaArray: Cell type not supported");
+            }
+        }
+
+        /**
+         * @brief Hands the block over to the Arena, and returns it flagged with xlbitDLLFree, for returning to Excel.
+         */
+        LPXLOPER12 release() &&
+        {
+            m_block[0].xltype            = xltypeMulti | xlbitDLLFree;
+            m_block[0].val.array.lparray = cell_count() > 0 ? cells() : nullptr;
+            Arena::instance().adopt(m_block);
+            return std::exchange(m_block, nullptr);
+        }
+    };
+
+}    // namespace xll
@@ -0,0 +1,243 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <xlcall.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace xll
+{
+    /**
+     * @brief Counters of the BufferPool since the add-in was loaded; only kept while the pool is enabled.
+     */
+    struct BufferPoolStats
+    {
+        size_t hits     = 0;    // Buffers taken from a cache.
+        size_t misses   = 0;    // Buffers allocated, as no cached buffer of the size was available.
+        size_t returned = 0;    // Buffers put in a cache when released.
+        size_t released = 0;    // Buffers deallocated: too large, evicted from a full cache, or trimmed.
+        size_t bytes    = 0;    // Bytes currently held by the caches.
+        size_t peak     = 0;    // The most bytes held by the caches at any time since the last trim.
+    };
+
+    /**
+     * @brief Recycles the XLOPER12 buffers of Arrays, so that a result of the same size as a previous one reuses
+     * its buffer instead of allocating a new one.
+     *
+     * @details An array formula that is recalculated creates a buffer for its result, which Excel hands back to
+     * xlAutoFree12 moments later, only for the next calculation to create one of the same size. Released buffers
+     * are therefore kept in a cache of the releasing thread, keyed by their number of cells, where the next Array
+     * of that size on the same thread picks them up. Each of Excel's calculation threads has its own cache, so
+     * thread-safe ($) functions don't share buffers (or locks) across threads.
+     *
+     * A cache holds at most a given number of buffers and bytes; when it is full, the oldest buffer is evicted.
+     * The caches are emptied when the add-in is closed (xlAutoClose), or by trim().
+     *
+     * The pool is disabled until configure() is called, as most allocators already hand a just-freed block back to
+     * the next allocation of the same size on the same thread; it is meant for add-ins where profiling shows
+     * otherwise (e.g. large results above the allocator's mmap threshold). While disabled, buffers go straight to
+     * new[] and delete[], with no locks or counters. Buffers are always allocated with new XLOPER12[] and released
+     * with delete[], so that a buffer created by the user in the same way can be released through an Array.
+     */
+    class BufferPool
+    {
+        struct Cache
+        {
+            struct Entry
+            {
+                size_t    size;
+                XLOPER12* buffer;
+            };
+
+            std::vector<Entry> entries {};
+            size_t             bytes = 0;
+            std::mutex         mutex;
+        };
+
+        /**
+         * @brief The cache of the current thread, which is emptied when the thread exits.
+         */
+        struct ThreadCache
+        {
+            Cache cache {};
+
+            ThreadCache() { instance().attach(&cache); }
+
+            ~ThreadCache()
+            {
+                instance().detach(&cache);
+                s_exited = true;
+            }
+        };
+
+        // Set once the cache of the thread has been destroyed. Arrays released after that (by later thread_local
+        // or static destructors, e.g. the MemoryManager at exit) bypass the cache.
+        inline static thread_local bool s_exited = false;
+
+        BufferPool() = default;
+
+        std::vector<Cache*> m_caches {};
+        std::mutex          m_mutex;
+        std::atomic<size_t> m_entries { 0 };
+        std::atomic<size_t> m_bytes { 0 };
+        std::atomic<size_t> m_hits { 0 };
+        std::atomic<size_t> m_misses { 0 };
+        std::atomic<size_t> m_returned { 0 };
+        std::atomic<size_t> m_released { 0 };
+        std::atomic<size_t> m_cached { 0 };
+        std::atomic<size_t> m_peak { 0 };
+
+        static Cache* local()
+        {
+            if (s_exited) return nullptr;
+            thread_local ThreadCache local;
+            return &local.cache;
+        }
+
+        void attach(Cache* cache)
+        {
+            const std::lock_guard lock(m_mutex);
+            m_caches.push_back(cache);
+        }
+
+        void detach(Cache* cache)
+        {
+            const std::lock_guard lock(m_mutex);
+            std::erase(m_caches, cache);
+            empty(*cache);
+        }
+
+        void evict(Cache& cache, size_t index)
+        {
+            const auto entry = cache.entries[index];
+            cache.entries.erase(cache.entries.begin() + static_cast<std::ptrdiff_t>(index));
+            cache.bytes -= entry.size * sizeof(XLOPER12);
+            m_cached.fetch_sub(entry.size * sizeof(XLOPER12), std::memory_order_relaxed);
+            m_released.fetch_add(1, std::memory_order_relaxed);
+            delete[] entry.buffer;
+        }
+
+        void empty(Cache& cache)
+        {
+            const std::lock_guard lock(cache.mutex);
+            while (not cache.entries.empty()) evict(cache, 0);
+        }
+
+    public:
+        BufferPool(const BufferPool&)            = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        /**
+         * @brief The pool is never destroyed, as the caches of threads that exit late (e.g. the workers of static
+         * objects) are released during static destruction.
+         */
+        static BufferPool& instance()
+        {
+            static auto* pool = new BufferPool();
+            return *pool;
+        }
+
+        /**
+         * @brief Returns an uninitialised buffer of size XLOPER12s, from the cache of this thread if possible.
+         */
+        XLOPER12* allocate(size_t size)
+        {
+            if (not enabled()) return new XLOPER12[size];
+
+            if (auto* cache = local()) {
+                const std::lock_guard lock(cache->mutex);
+                for (auto i = cache->entries.size(); i-- > 0;) {
+                    if (cache->entries[i].size != size) continue;
+
+                    auto* buffer = cache->entries[i].buffer;
+                    cache->entries.erase(cache->entries.begin() + static_cast<std::ptrdiff_t>(i));
+                    cache->bytes -= size * sizeof(XLOPER12);
+                    m_cached.fetch_sub(size * sizeof(XLOPER12), std::memory_order_relaxed);
+                    m_hits.fetch_add(1, std::memory_order_relaxed);
+                    return buffer;
+                }
+            }
+
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            return new XLOPER12[size];
+        }
+
+        /**
+         * @brief Puts a buffer created by allocate() in the cache of this thread, evicting the oldest buffers if
+         * the cache is full. Buffers larger than the cache are deallocated.
+         */
+        void deallocate(XLOPER12* buffer, size_t size) noexcept
+        {
+            const auto bytes    = size * sizeof(XLOPER12);
+            const auto maxBytes = m_bytes.load(std::memory_order_relaxed);
+            const auto maxCount = m_entries.load(std::memory_order_relaxed);
+            if (maxCount == 0) {
+                delete[] buffer;
+                return;
+            }
+
+            auto* cache = bytes > maxBytes ? nullptr : local();
+            if (cache == nullptr) {
+                m_released.fetch_add(1, std::memory_order_relaxed);
+                delete[] buffer;
+                return;
+            }
+
+            const std::lock_guard lock(cache->mutex);
+            while (not cache->entries.empty() && (cache->entries.size() >= maxCount || cache->bytes + bytes > maxBytes)) evict(*cache, 0);
+
+            try {
+                cache->entries.push_back({ size, buffer });
+            }
+            catch (...) {
+                m_released.fetch_add(1, std::memory_order_relaxed);
+                delete[] buffer;
+                return;
+            }
+            cache->bytes += bytes;
+            m_returned.fetch_add(1, std::memory_order_relaxed);
+
+            const auto cached = m_cached.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            auto       peak   = m_peak.load(std::memory_order_relaxed);
+            while (cached > peak && not m_peak.compare_exchange_weak(peak, cached, std::memory_order_relaxed)) {}
+        }
+
+        /**
+         * @brief Deallocates the buffers held by all caches, and resets the high-water mark.
+         */
+        void trim()
+        {
+            const std::lock_guard lock(m_mutex);
+            for (const auto& cache : m_caches) empty(*cache);
+            m_peak.store(m_cached.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Enables the pool, setting the number of buffers and the number of bytes that the cache of each
+         * thread may hold (e.g. 8 buffers and 16 MiB). Zero disables the pool again.
+         */
+        void configure(size_t entries, size_t bytes)
+        {
+            m_entries.store(entries, std::memory_order_relaxed);
+            m_bytes.store(bytes, std::memory_order_relaxed);
+            trim();
+        }
+
+        [[nodiscard]] bool enabled() const { return m_entries.load(std::memory_order_relaxed) != 0; }
+
+        [[nodiscard]] BufferPoolStats stats() const
+        {
+            return { m_hits.load(std::memory_order_relaxed),     m_misses.load(std::memory_order_relaxed),
+                     m_returned.load(std::memory_order_relaxed), m_released.load(std::memory_order_relaxed),
+                     m_cached.load(std::memory_order_relaxed),   m_peak.load(std::memory_order_relaxed) };
+        }
+    };
+}    // namespace xll
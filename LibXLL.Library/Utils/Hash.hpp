@@ -0,0 +1,729 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <xlcall.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <immintrin.h>
+#endif
+
+namespace xll
+{
+    /**
+     * @brief A 128-bit hash: two 64-bit halves, each a hash in its own right.
+     */
+    struct Hash128
+    {
+        uint64_t low  = 0;
+        uint64_t high = 0;
+
+        friend bool operator==(const Hash128&, const Hash128&) = default;
+    };
+
+    namespace impl::hash
+    {
+        // The words of the hashed stream are read from memory as little-endian, as on all platforms Excel runs on.
+        static_assert(std::endian::native == std::endian::little);
+
+        inline constexpr size_t Lanes  = 8;     // Words per stripe.
+        inline constexpr size_t Stripe = 64;    // Bytes per stripe.
+        inline constexpr size_t Block  = 16;    // Stripes between scrambles of the accumulators.
+
+        inline constexpr uint64_t Prime32 = 0x9E3779B1ull;
+
+        inline constexpr std::array<uint64_t, Lanes> Init = { 0x00000000C2B2AE3Dull, 0x9E3779B185EBCA87ull, 0xC2B2AE3D27D4EB4Full,
+                                                              0x165667B19E3779F9ull, 0x85EBCA77C2B2AE63ull, 0x0000000085EBCA77ull,
+                                                              0x27D4EB2F165667C5ull, 0x000000009E3779B1ull };
+
+        inline constexpr std::array<uint64_t, Lanes> Secret = { 0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull,
+                                                                0x1F67B3B7A4A44072ull, 0x78E5C0CC4EE679CBull, 0x2172FFCC7DD05A82ull,
+                                                                0x8E2443F7744608B8ull, 0x4C263A81E69035E0ull };
+
+        // Added to the key of a lane after each stripe, so that the position of a stripe within a block counts.
+        inline constexpr std::array<uint64_t, Lanes> Step = { 0xCB00C391BB52283Cull, 0xA32E531B8B65D088ull, 0x4EF90DA297486471ull,
+                                                              0xD8ACDEA946EF1938ull, 0x3F349CE33F76FAA8ull, 0x1D4F0BC7C7BBDCF9ull,
+                                                              0x3159B4CD4BE0518Aull, 0x647378D9C97E9FC8ull };
+
+        inline constexpr std::array<uint64_t, Lanes> MergeLow = { 0xC3EBD33483ACC5EAull, 0xEB6313FAFFA081C5ull, 0x49DAF0B751DD0D17ull,
+                                                                  0x9E68D429265516D3ull, 0xFCA1477D58BE162Bull, 0xCE31D07AD1B8F88Full,
+                                                                  0x280416958F3ACB45ull, 0x7E404BBBCAFBD7AFull };
+
+        inline constexpr std::array<uint64_t, Lanes> MergeHigh = { 0x81DAD8B64D9B9A4Bull, 0x93E2D2E1D4A5FA7Full, 0x0CB3BB5D5B2E3A7Cull,
+                                                                   0xE4C81C0DE8D7C6B5ull, 0x5A46B5D1F3C2A091ull, 0xD7A3E1B24C5F6E08ull,
+                                                                   0x2F8E7D6C5B4A3928ull, 0xB3C4D5E6F708192Aull };
+
+        /**
+         * @brief The state of a hash: eight independent lanes, which a stripe of eight words updates at once.
+         */
+        struct State
+        {
+            std::array<uint64_t, Lanes> acc;
+            std::array<uint64_t, Lanes> key;
+            std::array<uint64_t, Lanes> base;
+            size_t                      stripes = 0;    // Stripes in the current block.
+
+            explicit State(uint64_t seed) : acc(Init)
+            {
+                for (size_t i = 0; i < Lanes; ++i) base[i] = (i % 2 == 0) ? Secret[i] + seed : Secret[i] - seed;
+                key = base;
+            }
+        };
+
+        /**
+         * @brief The reference implementation of accumulate(), which the vectorised ones reproduce exactly.
+         */
+        inline void accumulate_scalar(State& state, const std::byte* data, size_t stripes)
+        {
+            for (; stripes > 0; --stripes, data += Stripe) {
+                for (size_t i = 0; i < Lanes; ++i) {
+                    uint64_t d;
+                    std::memcpy(&d, data + i * sizeof(uint64_t), sizeof(d));
+                    const auto k = d ^ state.key[i];
+                    state.acc[i ^ 1] += d;
+                    state.acc[i] += (k & 0xFFFFFFFFull) * (k >> 32);
+                    state.key[i] += Step[i];
+                }
+                if (++state.stripes == Block) {
+                    for (size_t i = 0; i < Lanes; ++i) {
+                        auto a = state.acc[i];
+                        a ^= a >> 47;
+                        a ^= state.base[i];
+                        state.acc[i] = a * Prime32;
+                    }
+                    state.key     = state.base;
+                    state.stripes = 0;
+                }
+            }
+        }
+
+        /**
+         * @brief The number of leading cells, in groups of four (a stripe of type and value words), that are numbers.
+         */
+        inline size_t numbers(const XLOPER12* cells, size_t count)
+        {
+            constexpr uint32_t FreeBits = xlbitXLFree | xlbitDLLFree;
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const auto other = (cells[i].xltype ^ xltypeNum) | (cells[i + 1].xltype ^ xltypeNum) | (cells[i + 2].xltype ^ xltypeNum) |
+                                   (cells[i + 3].xltype ^ xltypeNum);
+                if ((other & ~FreeBits) != 0) break;
+            }
+            return i;
+        }
+
+#if defined(__AVX2__)
+        // One stripe: four lanes per register, the lanes of a pair swapped within each 128-bit half.
+        inline void round(__m256i& acc, __m256i& key, __m256i step, __m256i d)
+        {
+            const auto k = _mm256_xor_si256(d, key);
+            const auto p = _mm256_mul_epu32(k, _mm256_srli_epi64(k, 32));
+            acc          = _mm256_add_epi64(acc, _mm256_add_epi64(p, _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2))));
+            key          = _mm256_add_epi64(key, step);
+        }
+
+        inline void scramble(__m256i& acc, __m256i base)
+        {
+            const auto prime = _mm256_set1_epi32(static_cast<int>(Prime32));
+            const auto a     = _mm256_xor_si256(_mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47)), base);
+            acc = _mm256_add_epi64(_mm256_mul_epu32(a, prime), _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime), 32));
+        }
+
+        /**
+         * @brief Hashes the given number of stripes, each loaded into two registers by stripe(n, d0, d1).
+         */
+        template<typename TStripe>
+        void accumulate_with(State& state, size_t stripes, TStripe&& stripe)
+        {
+            const auto load  = [](const uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); };
+            const auto step0 = load(&Step[0]), step1 = load(&Step[4]);
+            const auto base0 = load(&state.base[0]), base1 = load(&state.base[4]);
+            auto       acc0 = load(&state.acc[0]), acc1 = load(&state.acc[4]);
+            auto       key0 = load(&state.key[0]), key1 = load(&state.key[4]);
+
+            // A local count: the stripes are read as bytes, which may alias the state.
+            auto count = state.stripes;
+            for (size_t n = 0; n < stripes; ++n) {
+                __m256i d0, d1;
+                stripe(n, d0, d1);
+                round(acc0, key0, step0, d0);
+                round(acc1, key1, step1, d1);
+                if (++count == Block) {
+                    scramble(acc0, base0);
+                    scramble(acc1, base1);
+                    key0  = base0;
+                    key1  = base1;
+                    count = 0;
+                }
+            }
+
+            state.stripes = count;
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&state.acc[0]), acc0);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&state.acc[4]), acc1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&state.key[0]), key0);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&state.key[4]), key1);
+        }
+
+        inline void accumulate(State& state, const std::byte* data, size_t stripes)
+        {
+            accumulate_with(state, stripes, [data](size_t n, __m256i& d0, __m256i& d1) {
+                d0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + n * Stripe));
+                d1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + n * Stripe + 32));
+            });
+        }
+
+        // The type and value words of two numbers.
+        inline __m256i number_pair(const XLOPER12& lhs, const XLOPER12& rhs)
+        {
+            const auto type = _mm_cvtsi32_si128(xltypeNum);
+            const auto lo   = _mm_unpacklo_epi64(type, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&lhs.val.num)));
+            const auto hi   = _mm_unpacklo_epi64(type, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&rhs.val.num)));
+            return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        }
+
+        inline void accumulate_numbers(State& state, const XLOPER12* cells, size_t stripes)
+        {
+            accumulate_with(state, stripes, [cells](size_t n, __m256i& d0, __m256i& d1) {
+                d0 = number_pair(cells[n * 4], cells[n * 4 + 1]);
+                d1 = number_pair(cells[n * 4 + 2], cells[n * 4 + 3]);
+            });
+        }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        // One stripe: two lanes per register, swapped for the sums.
+        inline void round(__m128i& acc, __m128i& key, __m128i step, __m128i d)
+        {
+            const auto k = _mm_xor_si128(d, key);
+            const auto p = _mm_mul_epu32(k, _mm_srli_epi64(k, 32));
+            acc          = _mm_add_epi64(acc, _mm_add_epi64(p, _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2))));
+            key          = _mm_add_epi64(key, step);
+        }
+
+        inline void scramble(__m128i& acc, __m128i base)
+        {
+            const auto prime = _mm_set1_epi32(static_cast<int>(Prime32));
+            const auto a     = _mm_xor_si128(_mm_xor_si128(acc, _mm_srli_epi64(acc, 47)), base);
+            acc              = _mm_add_epi64(_mm_mul_epu32(a, prime), _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), prime), 32));
+        }
+
+        /**
+         * @brief Hashes the given number of stripes, each loaded into four registers by stripe(n, d0, d1, d2, d3).
+         */
+        template<typename TStripe>
+        void accumulate_with(State& state, size_t stripes, TStripe&& stripe)
+        {
+            const auto load  = [](const uint64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+            const auto step0 = load(&Step[0]), step1 = load(&Step[2]), step2 = load(&Step[4]), step3 = load(&Step[6]);
+            const auto base0 = load(&state.base[0]), base1 = load(&state.base[2]), base2 = load(&state.base[4]), base3 = load(&state.base[6]);
+            auto       acc0 = load(&state.acc[0]), acc1 = load(&state.acc[2]), acc2 = load(&state.acc[4]), acc3 = load(&state.acc[6]);
+            auto       key0 = load(&state.key[0]), key1 = load(&state.key[2]), key2 = load(&state.key[4]), key3 = load(&state.key[6]);
+
+            // A local count: the stripes are read as bytes, which may alias the state.
+            auto count = state.stripes;
+            for (size_t n = 0; n < stripes; ++n) {
+                __m128i d0, d1, d2, d3;
+                stripe(n, d0, d1, d2, d3);
+                round(acc0, key0, step0, d0);
+                round(acc1, key1, step1, d1);
+                round(acc2, key2, step2, d2);
+                round(acc3, key3, step3, d3);
+                if (++count == Block) {
+                    scramble(acc0, base0);
+                    scramble(acc1, base1);
+                    scramble(acc2, base2);
+                    scramble(acc3, base3);
+                    key0  = base0;
+                    key1  = base1;
+                    key2  = base2;
+                    key3  = base3;
+                    count = 0;
+                }
+            }
+
+            state.stripes = count;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state.acc[0]), acc0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state.acc[2]), acc1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state.acc[4]), acc2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state.acc[6]), acc3);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state.key[0]), key0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state.key[2]), key1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state.key[4]), key2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state.key[6]), key3);
+        }
+
+        inline void accumulate(State& state, const std::byte* data, size_t stripes)
+        {
+            accumulate_with(state, stripes, [data](size_t n, __m128i& d0, __m128i& d1, __m128i& d2, __m128i& d3) {
+                d0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + n * Stripe));
+                d1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + n * Stripe + 16));
+                d2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + n * Stripe + 32));
+                d3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + n * Stripe + 48));
+            });
+        }
+
+        // The type and value words of a number.
+        inline __m128i number(const XLOPER12& cell)
+        {
+            return _mm_unpacklo_epi64(_mm_cvtsi32_si128(xltypeNum), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&cell.val.num)));
+        }
+
+        inline void accumulate_numbers(State& state, const XLOPER12* cells, size_t stripes)
+        {
+            accumulate_with(state, stripes, [cells](size_t n, __m128i& d0, __m128i& d1, __m128i& d2, __m128i& d3) {
+                d0 = number(cells[n * 4]);
+                d1 = number(cells[n * 4 + 1]);
+                d2 = number(cells[n * 4 + 2]);
+                d3 = number(cells[n * 4 + 3]);
+            });
+        }
+#else
+        inline void accumulate(State& state, const std::byte* data, size_t stripes) { accumulate_scalar(state, data, stripes); }
+
+        inline void accumulate_numbers(State& state, const XLOPER12* cells, size_t stripes)
+        {
+            for (size_t n = 0; n < stripes; ++n, cells += 4) {
+                const auto stripe = std::array<uint64_t, Lanes> { xltypeNum, std::bit_cast<uint64_t>(cells[0].val.num),
+                                                                  xltypeNum, std::bit_cast<uint64_t>(cells[1].val.num),
+                                                                  xltypeNum, std::bit_cast<uint64_t>(cells[2].val.num),
+                                                                  xltypeNum, std::bit_cast<uint64_t>(cells[3].val.num) };
+                accumulate_scalar(state, reinterpret_cast<const std::byte*>(stripe.data()), 1);
+            }
+        }
+#endif
+
+        /**
+         * @brief The 128-bit product of two words, folded to 64 bits.
+         */
+        inline uint64_t mul_fold(uint64_t lhs, uint64_t rhs)
+        {
+#if defined(__SIZEOF_INT128__)
+            const auto product = static_cast<unsigned __int128>(lhs) * rhs;
+            return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+            const auto lo_lo = (lhs & 0xFFFFFFFFull) * (rhs & 0xFFFFFFFFull);
+            const auto hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFFull);
+            const auto lo_hi = (lhs & 0xFFFFFFFFull) * (rhs >> 32);
+            const auto hi_hi = (lhs >> 32) * (rhs >> 32);
+            const auto cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFull) + lo_hi;
+            return ((cross << 32) | (lo_lo & 0xFFFFFFFFull)) ^ (hi_hi + (hi_lo >> 32) + (cross >> 32));
+#endif
+        }
+
+        inline uint64_t avalanche(uint64_t h)
+        {
+            h ^= h >> 37;
+            h *= 0x165667919E3779F9ull;
+            return h ^ (h >> 32);
+        }
+
+        inline uint64_t merge(const State& state, const std::array<uint64_t, Lanes>& secret, uint64_t start)
+        {
+            auto h = start;
+            for (size_t i = 0; i < Lanes; i += 2) h += mul_fold(state.acc[i] ^ secret[i], state.acc[i + 1] ^ secret[i + 1]);
+            return avalanche(h);
+        }
+    }    // namespace impl::hash
+
+    /**
+     * @brief Computes a stable, seedable 64- or 128-bit hash of a stream of 64-bit words, and of the structure of
+     * XLOPER12 values (see value()).
+     *
+     * @details The words are processed in stripes of eight, each word in its own lane, so that a stripe is
+     * hashed with a few vector instructions (AVX2 when the compiler targets it, SSE2 otherwise). Blocks of memory,
+     * such as the characters of a string or the doubles of a NumericArray, are hashed in place, and the numbers of
+     * an array are loaded from the cells into the lanes directly. The result depends only on the words and the
+     * seed, not on the platform or the instruction set, so a hash may be stored or compared across sessions. It is
+     * not a cryptographic hash, and should not be used where the values may be chosen to provoke collisions.
+     */
+    class Hasher
+    {
+        impl::hash::State                       m_state;
+        std::array<uint64_t, impl::hash::Lanes> m_buffer {};
+        size_t                                  m_fill  = 0;    // Words in the buffer.
+        uint64_t                                m_words = 0;    // Words written.
+        uint64_t                                m_seed;
+
+        static constexpr uint32_t FreeBits = xlbitXLFree | xlbitDLLFree;
+
+        // Fills the buffer and hashes it when it is full.
+        void fill(const std::byte*& data, size_t& words)
+        {
+            const auto count = std::min(words, impl::hash::Lanes - m_fill);
+            std::memcpy(m_buffer.data() + m_fill, data, count * sizeof(uint64_t));
+            m_fill += count;
+            data += count * sizeof(uint64_t);
+            words -= count;
+            if (m_fill == impl::hash::Lanes) {
+                impl::hash::accumulate(m_state, reinterpret_cast<const std::byte*>(m_buffer.data()), 1);
+                m_fill = 0;
+            }
+        }
+
+        void raw(const void* data, size_t words)
+        {
+            auto* bytes = static_cast<const std::byte*>(data);
+            m_words += words;
+            if (m_fill > 0) fill(bytes, words);
+            if (words >= impl::hash::Lanes) {
+                const auto stripes = words / impl::hash::Lanes;
+                impl::hash::accumulate(m_state, bytes, stripes);
+                bytes += stripes * impl::hash::Stripe;
+                words -= stripes * impl::hash::Lanes;
+            }
+            if (words > 0) fill(bytes, words);
+        }
+
+        void cells(const XLOPER12* cells, size_t count)
+        {
+            // Numbers, the bulk of most arrays, are hashed directly from the cells, four at a time (a stripe), when
+            // the words written so far fill whole stripes. Other cells are written one by one.
+            constexpr size_t Chunk = 64;
+
+            size_t i = 0;
+            while (i < count) {
+                if (m_fill == 0) {
+                    const auto numbers = impl::hash::numbers(cells + i, std::min(count - i, Chunk));
+                    impl::hash::accumulate_numbers(m_state, cells + i, numbers / 4);
+                    m_words += numbers * 2;
+                    i += numbers;
+                    if (numbers == Chunk) continue;
+                    if (i == count) break;
+                }
+                value(cells[i++]);
+            }
+        }
+
+        // Characters are written as UTF-16 units, as Excel stores them, also where XCHAR holds code points (the
+        // unix SDK), so that a string hashes the same on every platform. Code points above U+FFFF are written as
+        // surrogate pairs, and invalid ones as U+FFFD.
+        void text(const XCHAR* chars, size_t count)
+        {
+            if constexpr (sizeof(XCHAR) == sizeof(char16_t))
+                bytes(chars, count * sizeof(XCHAR));
+            else {
+                const auto is_pair = [](uint32_t c) { return c > 0xFFFF && c <= 0x10FFFF; };
+                const auto pairs   = std::count_if(chars, chars + count, [&](XCHAR c) { return is_pair(static_cast<uint32_t>(c)); });
+                word((count + static_cast<size_t>(pairs)) * sizeof(char16_t));
+
+                uint64_t   w    = 0;
+                size_t     fill = 0;
+                const auto unit = [&](uint32_t u) {
+                    w |= static_cast<uint64_t>(u) << (16 * fill);
+                    if (++fill < 4) return;
+                    word(w);
+                    w    = 0;
+                    fill = 0;
+                };
+                for (size_t i = 0; i < count; ++i) {
+                    const auto c = static_cast<uint32_t>(chars[i]);
+                    if (is_pair(c)) {
+                        unit(0xD800 + ((c - 0x10000) >> 10));
+                        unit(0xDC00 + ((c - 0x10000) & 0x3FF));
+                    }
+                    else
+                        unit(c <= 0xFFFF ? c : 0xFFFD);
+                }
+                if (fill > 0) word(w);
+            }
+        }
+
+    public:
+        explicit Hasher(uint64_t seed = 0) : m_state(seed), m_seed(seed) {}
+
+        /**
+         * @brief Writes a word.
+         */
+        void word(uint64_t w)
+        {
+            m_buffer[m_fill++] = w;
+            ++m_words;
+            if (m_fill == impl::hash::Lanes) {
+                impl::hash::accumulate(m_state, reinterpret_cast<const std::byte*>(m_buffer.data()), 1);
+                m_fill = 0;
+            }
+        }
+
+        /**
+         * @brief Writes a block of memory, preceded by its length so that consecutive blocks can't be confused.
+         */
+        void bytes(const void* data, size_t size)
+        {
+            word(size);
+            raw(data, size / sizeof(uint64_t));
+            if (const auto rest = size % sizeof(uint64_t); rest > 0) {
+                uint64_t w = 0;
+                std::memcpy(&w, static_cast<const std::byte*>(data) + size - rest, rest);
+                word(w);
+            }
+        }
+
+        /**
+         * @brief Writes the structure of an XLOPER12: its type (without the memory flags) and its content,
+         * including the cells of an array and the characters of a string.
+         *
+         * @details Numbers are written as their bits, so that -0.0 and 0.0 differ and a NaN equals itself, and a
+         * missing string equals an empty one. References are written as the sheet and the rectangles they refer
+         * to, not the content of the cells. Of a flow control value or a binary name, only the type and the size
+         * are written. Two values that are equal (see xll::equal) write the same words, always an even number.
+         */
+        void value(const XLOPER12& value)
+        {
+            const auto start = m_words;
+            const auto type  = value.xltype & ~FreeBits;
+            word(type);
+
+            switch (type) {
+                case xltypeNum:
+                    word(std::bit_cast<uint64_t>(value.val.num));
+                    break;
+                case xltypeStr:
+                    if (value.val.str == nullptr)
+                        word(0);
+                    else
+                        text(value.val.str + 1, static_cast<size_t>(value.val.str[0]));
+                    break;
+                case xltypeBool:
+                    word(value.val.xbool != 0);
+                    break;
+                case xltypeErr:
+                    word(static_cast<uint64_t>(value.val.err));
+                    break;
+                case xltypeInt:
+                    word(static_cast<uint64_t>(value.val.w));
+                    break;
+                case xltypeMulti:
+                    word(static_cast<uint64_t>(value.val.array.rows));
+                    word(static_cast<uint64_t>(value.val.array.columns));
+                    word(0);    // Padding, before the cells (see below).
+                    cells(value.val.array.lparray, static_cast<size_t>(value.val.array.rows) * static_cast<size_t>(value.val.array.columns));
+                    break;
+                case xltypeSRef:
+                    word(static_cast<uint64_t>(value.val.sref.ref.rwFirst) << 32 | static_cast<uint32_t>(value.val.sref.ref.rwLast));
+                    word(static_cast<uint64_t>(value.val.sref.ref.colFirst) << 32 | static_cast<uint32_t>(value.val.sref.ref.colLast));
+                    break;
+                case xltypeRef: {
+                    const auto* mref  = value.val.mref.lpmref;
+                    const auto  count = mref == nullptr ? 0 : static_cast<size_t>(mref->count);
+                    word(static_cast<uint64_t>(value.val.mref.idSheet));
+                    word(count);
+                    for (size_t i = 0; i < count; ++i) {
+                        word(static_cast<uint64_t>(mref->reftbl[i].rwFirst) << 32 | static_cast<uint32_t>(mref->reftbl[i].rwLast));
+                        word(static_cast<uint64_t>(mref->reftbl[i].colFirst) << 32 | static_cast<uint32_t>(mref->reftbl[i].colLast));
+                    }
+                    break;
+                }
+                case xltypeFlow:
+                    word(static_cast<uint64_t>(value.val.flow.xlflow));
+                    break;
+                case xltypeBigData:
+                    word(static_cast<uint64_t>(value.val.bigdata.cbData));
+                    break;
+                default:
+                    break;
+            }
+
+            // Each value is padded to an even number of words, so that the numbers in an array line up with the lanes.
+            if ((m_words - start) % 2 != 0) word(0);
+        }
+
+        /**
+         * @brief Writes the structure of a block of doubles (such as a NumericArray): its dimensions and the bits
+         * of the numbers.
+         */
+        void value(const FP12& value)
+        {
+            word(static_cast<uint64_t>(value.rows));
+            word(static_cast<uint64_t>(value.columns));
+            bytes(value.array, static_cast<size_t>(value.rows) * static_cast<size_t>(value.columns) * sizeof(double));
+        }
+
+        /**
+         * @brief The 64-bit hash of the words written so far. The hasher may be written to further afterwards.
+         */
+        [[nodiscard]] uint64_t digest() const
+        {
+            const auto start = m_words * 0x9E3779B185EBCA87ull ^ m_seed;
+            if (m_words < impl::hash::Lanes) return brief(impl::hash::MergeLow, start);
+            return impl::hash::merge(tail(), impl::hash::MergeLow, start);
+        }
+
+        /**
+         * @brief The 128-bit hash of the words written so far, whose low half is digest().
+         */
+        [[nodiscard]] Hash128 digest128() const
+        {
+            const auto low  = m_words * 0x9E3779B185EBCA87ull ^ m_seed;
+            const auto high = ~(m_words * 0xC2B2AE3D27D4EB4Full) ^ m_seed;
+            if (m_words < impl::hash::Lanes) return { brief(impl::hash::MergeLow, low), brief(impl::hash::MergeHigh, high) };
+
+            const auto state = tail();
+            return { impl::hash::merge(state, impl::hash::MergeLow, low), impl::hash::merge(state, impl::hash::MergeHigh, high) };
+        }
+
+    private:
+        // The hash of fewer words than a stripe (a scalar, or the arguments of most calls), which are mixed directly.
+        [[nodiscard]] uint64_t brief(const std::array<uint64_t, impl::hash::Lanes>& secret, uint64_t start) const
+        {
+            auto h = start;
+            for (size_t i = 0; i < m_fill; i += 2) {
+                const auto next = i + 1 < m_fill ? m_buffer[i + 1] : 0;
+                h += impl::hash::mul_fold(m_buffer[i] ^ (m_state.base[i] + secret[i]), next ^ (m_state.base[i + 1] - secret[i + 1]));
+            }
+            return impl::hash::avalanche(h);
+        }
+
+        // The state after the words in the buffer, padded with zeros, have been hashed.
+        [[nodiscard]] impl::hash::State tail() const
+        {
+            auto state = m_state;
+            if (m_fill > 0) {
+                auto stripe = std::array<uint64_t, impl::hash::Lanes> {};
+                std::memcpy(stripe.data(), m_buffer.data(), m_fill * sizeof(uint64_t));
+                impl::hash::accumulate(state, reinterpret_cast<const std::byte*>(stripe.data()), 1);
+            }
+            return state;
+        }
+    };
+
+    /**
+     * @brief The 64-bit structural hash of an XLOPER12, e.g. a Variant or an Array (see Hasher::value).
+     */
+    inline uint64_t hash(const XLOPER12& value, uint64_t seed = 0)
+    {
+        auto hasher = Hasher(seed);
+        hasher.value(value);
+        return hasher.digest();
+    }
+
+    /**
+     * @brief The 64-bit structural hash of a block of doubles, e.g. a NumericArray.
+     */
+    inline uint64_t hash(const FP12& value, uint64_t seed = 0)
+    {
+        auto hasher = Hasher(seed);
+        hasher.value(value);
+        return hasher.digest();
+    }
+
+    inline Hash128 hash128(const XLOPER12& value, uint64_t seed = 0)
+    {
+        auto hasher = Hasher(seed);
+        hasher.value(value);
+        return hasher.digest128();
+    }
+
+    inline Hash128 hash128(const FP12& value, uint64_t seed = 0)
+    {
+        auto hasher = Hasher(seed);
+        hasher.value(value);
+        return hasher.digest128();
+    }
+
+    /**
+     * @brief Compares the structure of two XLOPER12s: the counterpart of hash(), comparing the same content.
+     *
+     * @details Unlike the comparison operators of the value types, this compares numbers by their bits, and
+     * compares arrays cell by cell, strings character by character and references by the cells they refer to.
+     */
+    inline bool equal(const XLOPER12& lhs, const XLOPER12& rhs)
+    {
+        constexpr uint32_t FreeBits = xlbitXLFree | xlbitDLLFree;
+
+        const auto type = lhs.xltype & ~FreeBits;
+        if (type != (rhs.xltype & ~FreeBits)) return false;
+
+        switch (type) {
+            case xltypeNum:
+                return std::bit_cast<uint64_t>(lhs.val.num) == std::bit_cast<uint64_t>(rhs.val.num);
+            case xltypeStr: {
+                const auto size = lhs.val.str == nullptr ? 0 : static_cast<size_t>(lhs.val.str[0]);
+                if (size != (rhs.val.str == nullptr ? 0 : static_cast<size_t>(rhs.val.str[0]))) return false;
+                return size == 0 || std::memcmp(lhs.val.str + 1, rhs.val.str + 1, size * sizeof(XCHAR)) == 0;
+            }
+            case xltypeBool:
+                return (lhs.val.xbool != 0) == (rhs.val.xbool != 0);
+            case xltypeErr:
+                return lhs.val.err == rhs.val.err;
+            case xltypeInt:
+                return lhs.val.w == rhs.val.w;
+            case xltypeMulti: {
+                if (lhs.val.array.rows != rhs.val.array.rows || lhs.val.array.columns != rhs.val.array.columns) return false;
+                const auto  count = static_cast<size_t>(lhs.val.array.rows) * static_cast<size_t>(lhs.val.array.columns);
+                const auto* a     = lhs.val.array.lparray;
+                const auto* b     = rhs.val.array.lparray;
+                if (a == b) return true;
+                for (size_t i = 0; i < count; ++i) {
+                    if (((a[i].xltype ^ b[i].xltype) & ~FreeBits) != 0) return false;
+                    if ((a[i].xltype & ~FreeBits) == xltypeNum) {
+                        if (std::bit_cast<uint64_t>(a[i].val.num) != std::bit_cast<uint64_t>(b[i].val.num)) return false;
+                    }
+                    else if (not equal(a[i], b[i]))
+                        return false;
+                }
+                return true;
+            }
+            case xltypeSRef:
+                return lhs.val.sref.ref.rwFirst == rhs.val.sref.ref.rwFirst && lhs.val.sref.ref.rwLast == rhs.val.sref.ref.rwLast &&
+                       lhs.val.sref.ref.colFirst == rhs.val.sref.ref.colFirst && lhs.val.sref.ref.colLast == rhs.val.sref.ref.colLast;
+            case xltypeRef: {
+                if (lhs.val.mref.idSheet != rhs.val.mref.idSheet) return false;
+                const auto* a     = lhs.val.mref.lpmref;
+                const auto* b     = rhs.val.mref.lpmref;
+                const auto  count = a == nullptr ? 0 : static_cast<size_t>(a->count);
+                if (count != (b == nullptr ? 0 : static_cast<size_t>(b->count))) return false;
+                for (size_t i = 0; i < count; ++i) {
+                    if (a->reftbl[i].rwFirst != b->reftbl[i].rwFirst || a->reftbl[i].rwLast != b->reftbl[i].rwLast ||
+                        a->reftbl[i].colFirst != b->reftbl[i].colFirst || a->reftbl[i].colLast != b->reftbl[i].colLast)
+                        return false;
+                }
+                return true;
+            }
+            case xltypeFlow:
+                return lhs.val.flow.xlflow == rhs.val.flow.xlflow && lhs.val.flow.rw == rhs.val.flow.rw && lhs.val.flow.col == rhs.val.flow.col;
+            case xltypeBigData:
+                return lhs.val.bigdata.cbData == rhs.val.bigdata.cbData && lhs.val.bigdata.h.lpbData == rhs.val.bigdata.h.lpbData;
+            default:
+                return true;
+        }
+    }
+
+    inline bool equal(const FP12& lhs, const FP12& rhs)
+    {
+        if (lhs.rows != rhs.rows || lhs.columns != rhs.columns) return false;
+        const auto size = static_cast<size_t>(lhs.rows) * static_cast<size_t>(lhs.columns) * sizeof(double);
+        return size == 0 || std::memcmp(lhs.array, rhs.array, size) == 0;
+    }
+
+    /**
+     * @brief Hashes XLOPER12-based values (and NumericArrays) by their structure, for unordered containers, e.g.
+     *
+     *     using key_t = xll::Variant<xll::Nil, xll::String, xll::Number>;
+     *     auto cache  = std::unordered_map<key_t, double, xll::StructuralHash, xll::StructuralEqual>();
+     *
+     * Both are transparent, so a container keyed by a Variant can be searched with Excel's XLOPER12 directly.
+     */
+    struct StructuralHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(const XLOPER12& value) const { return static_cast<size_t>(hash(value)); }
+        size_t operator()(const FP12& value) const { return static_cast<size_t>(hash(value)); }
+    };
+
+    struct StructuralEqual
+    {
+        using is_transparent = void;
+
+        bool operator()(const XLOPER12& lhs, const XLOPER12& rhs) const { return equal(lhs, rhs); }
+        bool operator()(const FP12& lhs, const FP12& rhs) const { return equal(lhs, rhs); }
+    };
+}    // namespace xll
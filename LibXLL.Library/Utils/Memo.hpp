@@ -0,0 +1,393 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <xlcall.hpp>
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace xll
+{
+    namespace impl
+    {
+        /**
+         * @brief The arguments of a call are written to a key sink as a sequence of 64-bit words: a Hasher hashes
+         * them, the KeyWriter keeps them (for a new cache entry), and the KeyMatcher compares them with those of an
+         * entry. Lookups therefore hash and compare the arguments where they are, without copying them.
+         *
+         * A block of memory (see Hasher::bytes) is written as its length, followed by its content in words, the
+         * last one padded with zeros.
+         */
+        struct KeyWriter
+        {
+            std::vector<uint64_t> words {};
+
+            void word(uint64_t w) { words.push_back(w); }
+
+            void bytes(const void* data, size_t size)
+            {
+                const auto offset = words.size() + 1;
+                words.resize(offset + (size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+                words[offset - 1] = size;
+                if (size > 0) std::memcpy(words.data() + offset, data, size);
+            }
+        };
+
+        class KeyMatcher
+        {
+            std::span<const uint64_t> m_key;
+            size_t                    m_pos   = 0;
+            bool                      m_equal = true;
+
+        public:
+            explicit KeyMatcher(std::span<const uint64_t> key) : m_key(key) {}
+
+            void word(uint64_t w)
+            {
+                m_equal = m_equal && m_pos < m_key.size() && m_key[m_pos] == w;
+                ++m_pos;
+            }
+
+            void bytes(const void* data, size_t size)
+            {
+                word(size);
+                const auto count = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+                m_equal          = m_equal && m_pos + count <= m_key.size();
+                if (m_equal && size > 0) {
+                    const auto whole = size / sizeof(uint64_t) * sizeof(uint64_t);
+                    m_equal          = std::memcmp(m_key.data() + m_pos, data, whole) == 0;
+                    if (m_equal && whole < size) {
+                        uint64_t w = 0;
+                        std::memcpy(&w, static_cast<const std::byte*>(data) + whole, size - whole);
+                        m_equal = m_key[m_pos + count - 1] == w;
+                    }
+                }
+                m_pos += count;
+            }
+
+            [[nodiscard]] bool matched() const { return m_equal && m_pos == m_key.size(); }
+        };
+
+        /**
+         * @brief Writes the value of an XLOPER12: its type and content, including the cells of an array and the
+         * characters of strings.
+         *
+         * @return false for references, whose content is not part of the XLOPER12 (and other types that can't be
+         * compared by value), so the call can't be cached.
+         */
+        template<typename TSink>
+        bool key_value(TSink& sink, const XLOPER12& value)
+        {
+            const auto type = value.xltype & ~(xlbitXLFree | xlbitDLLFree);
+            sink.word(type);
+
+            switch (type) {
+                case xltypeNum:
+                    sink.word(std::bit_cast<uint64_t>(value.val.num));
+                    return true;
+                case xltypeStr:
+                    if (value.val.str == nullptr)
+                        sink.word(0);
+                    else
+                        sink.bytes(value.val.str + 1, static_cast<size_t>(value.val.str[0]) * sizeof(XCHAR));
+                    return true;
+                case xltypeBool:
+                    sink.word(value.val.xbool != 0);
+                    return true;
+                case xltypeErr:
+                    sink.word(static_cast<uint64_t>(value.val.err));
+                    return true;
+                case xltypeInt:
+                    sink.word(static_cast<uint64_t>(value.val.w));
+                    return true;
+                case xltypeMissing:
+                case xltypeNil:
+                    return true;
+                case xltypeMulti: {
+                    const auto count = static_cast<size_t>(value.val.array.rows) * static_cast<size_t>(value.val.array.columns);
+                    sink.word(static_cast<uint64_t>(value.val.array.rows));
+                    sink.word(static_cast<uint64_t>(value.val.array.columns));
+                    for (size_t i = 0; i < count; ++i)
+                        if (not key_value(sink, value.val.array.lparray[i])) return false;
+                    return true;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        /**
+         * @brief The memory held by an XLOPER12 outside of itself: string characters and array cells.
+         */
+        inline size_t footprint(const XLOPER12& value)
+        {
+            switch (value.xltype & ~(xlbitXLFree | xlbitDLLFree)) {
+                case xltypeStr:
+                    return value.val.str == nullptr ? 0 : (static_cast<size_t>(value.val.str[0]) + 1) * sizeof(XCHAR);
+                case xltypeMulti: {
+                    const auto count = static_cast<size_t>(value.val.array.rows) * static_cast<size_t>(value.val.array.columns);
+                    auto       bytes = count * sizeof(XLOPER12);
+                    for (size_t i = 0; i < count; ++i) bytes += footprint(value.val.array.lparray[i]);
+                    return bytes;
+                }
+                default:
+                    return 0;
+            }
+        }
+
+        template<typename T>
+        size_t footprint(const T& value)
+        {
+            if constexpr (std::derived_from<T, XLOPER12>)
+                return sizeof(T) + footprint(static_cast<const XLOPER12&>(value));
+            else if constexpr (std::same_as<T, std::string>)
+                return sizeof(T) + value.capacity();
+            else
+                return sizeof(T);
+        }
+    }    // namespace impl
+
+    /**
+     * @brief Counters of a MemoCache since it was configured.
+     */
+    struct MemoStats
+    {
+        size_t hits      = 0;    // Calls answered from the cache.
+        size_t misses    = 0;    // Calls that ran the function.
+        size_t evictions = 0;    // Entries removed to stay within the capacity or the memory cap.
+        size_t entries   = 0;    // Entries currently held.
+        size_t bytes     = 0;    // Memory currently held by the entries (keys and results).
+    };
+
+    /**
+     * @brief A least-recently-used cache of the results of one pure function, keyed by the values of its
+     * arguments (see xll::Memoize).
+     *
+     * @details The arguments are hashed and compared by value, including the cells of arrays and the characters of
+     * strings, directly in Excel's memory; they are only copied (as the key of a new entry) when the function is
+     * run. A hit returns the cached result, which is shared with the caller, so that an entry evicted by another
+     * thread stays valid until the result has been handed to Excel. Calls with reference arguments are never
+     * cached, and neither are calls that fail.
+     *
+     * A cache of more than 128 entries is split into up to 16 shards, each with its own lock and an equal share of
+     * the capacity and memory cap, so that the threads of a multithreaded recalculation rarely wait for each other.
+     * Eviction is then least-recently-used within a shard.
+     */
+    class MemoCache
+    {
+        struct Entry
+        {
+            uint64_t                    hash;
+            std::vector<uint64_t>       key;
+            std::shared_ptr<const void> value;
+            size_t                      bytes;
+        };
+
+        struct alignas(64) Shard
+        {
+            std::list<Entry>                                         lru {};    // Most recently used first.
+            std::unordered_map<uint64_t, std::list<Entry>::iterator> index {};
+            size_t                                                   capacity = 0;
+            size_t                                                   maxBytes = 0;
+            size_t                                                   bytes    = 0;
+            std::mutex                                               mutex;
+        };
+
+        static constexpr size_t MaxShards = 16;
+
+        // The memory of an entry besides its key and result: the list and index nodes.
+        static constexpr size_t Overhead = sizeof(Entry) + 4 * sizeof(void*) + sizeof(uint64_t);
+
+        std::array<Shard, MaxShards> m_shards {};
+        std::atomic<size_t>          m_shardCount { 1 };
+        std::atomic<bool>            m_enabled { false };
+        std::atomic<size_t>          m_hits { 0 };
+        std::atomic<size_t>          m_misses { 0 };
+        std::atomic<size_t>          m_evictions { 0 };
+
+        Shard& shard(uint64_t hash) { return m_shards[hash % m_shardCount.load(std::memory_order_relaxed)]; }
+
+        void erase(Shard& s, std::list<Entry>::iterator it)
+        {
+            s.bytes -= it->bytes;
+            s.index.erase(it->hash);
+            s.lru.erase(it);
+        }
+
+        void insert(Shard& s, uint64_t hash, std::vector<uint64_t> key, std::shared_ptr<const void> value, size_t bytes)
+        {
+            const std::lock_guard lock(s.mutex);
+            if (s.capacity == 0 || bytes > s.maxBytes) return;
+
+            // Another thread may have added the same call in the meantime; an entry with a colliding hash is replaced.
+            if (const auto it = s.index.find(hash); it != s.index.end()) erase(s, it->second);
+
+            while (not s.lru.empty() && (s.lru.size() >= s.capacity || s.bytes + bytes > s.maxBytes)) {
+                erase(s, std::prev(s.lru.end()));
+                m_evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            s.lru.push_front({ hash, std::move(key), std::move(value), bytes });
+            s.index.emplace(hash, s.lru.begin());
+            s.bytes += bytes;
+        }
+
+        struct Registry
+        {
+            std::mutex                                       mutex;
+            std::map<void (*)(), std::unique_ptr<MemoCache>> caches;
+        };
+
+        static Registry& registry()
+        {
+            static Registry instance;
+            return instance;
+        }
+
+        MemoCache() = default;
+
+    public:
+        MemoCache(const MemoCache&)            = delete;
+        MemoCache& operator=(const MemoCache&) = delete;
+
+        /**
+         * @brief The cache of the exported procedure (the function defined with XLL_UDF), which exists, disabled,
+         * until it is configured.
+         */
+        template<typename TProcedure>
+            requires std::is_function_v<TProcedure>
+        static MemoCache& of(TProcedure* procedure)
+        {
+            auto&                 r = registry();
+            const std::lock_guard lock(r.mutex);
+            auto&                 cache = r.caches[reinterpret_cast<void (*)()>(procedure)];
+            if (not cache) cache.reset(new MemoCache());
+            return *cache;
+        }
+
+        /**
+         * @brief Empties the caches of all procedures (when the add-in is closed).
+         */
+        static void clear_all()
+        {
+            auto&                 r = registry();
+            const std::lock_guard lock(r.mutex);
+            for (const auto& [procedure, cache] : r.caches) cache->clear();
+        }
+
+        /**
+         * @brief Sets the number of entries and the number of bytes the cache may hold, and empties it. Zero
+         * disables the cache.
+         */
+        void configure(size_t capacity, size_t bytes)
+        {
+            const auto shards = std::bit_floor(std::clamp<size_t>(capacity / 64, 1, MaxShards));
+
+            m_enabled.store(false, std::memory_order_relaxed);
+            for (size_t i = 0; i < MaxShards; ++i) {
+                auto&                 s = m_shards[i];
+                const std::lock_guard lock(s.mutex);
+                s.lru.clear();
+                s.index.clear();
+                s.bytes    = 0;
+                s.capacity = i < shards ? (capacity + shards - 1) / shards : 0;
+                s.maxBytes = i < shards ? bytes / shards : 0;
+            }
+
+            m_shardCount.store(shards, std::memory_order_relaxed);
+            m_hits.store(0, std::memory_order_relaxed);
+            m_misses.store(0, std::memory_order_relaxed);
+            m_evictions.store(0, std::memory_order_relaxed);
+            m_enabled.store(capacity > 0 && bytes > 0, std::memory_order_release);
+        }
+
+        [[nodiscard]] bool enabled() const { return m_enabled.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Removes all entries, keeping the configuration.
+         */
+        void clear()
+        {
+            for (auto& s : m_shards) {
+                const std::lock_guard lock(s.mutex);
+                s.lru.clear();
+                s.index.clear();
+                s.bytes = 0;
+            }
+        }
+
+        /**
+         * @brief Returns the cached result of the call with the given arguments, or runs compute() and caches its
+         * result.
+         *
+         * @param key Writes the arguments to a key sink (see Hasher), returning false if they can't be
+         * compared by value.
+         * @param compute Runs the function. If it throws, nothing is cached.
+         */
+        template<typename TValue, typename TKey, typename TCompute>
+        std::shared_ptr<const TValue> get(TKey&& key, TCompute&& compute)
+        {
+            auto hasher = Hasher();
+            if (not key(hasher)) {
+                m_misses.fetch_add(1, std::memory_order_relaxed);
+                return std::make_shared<const TValue>(compute());
+            }
+
+            const auto hash = hasher.digest();
+            auto&      s    = shard(hash);
+            {
+                const std::lock_guard lock(s.mutex);
+                if (const auto it = s.index.find(hash); it != s.index.end()) {
+                    auto matcher = impl::KeyMatcher(it->second->key);
+                    if (key(matcher) && matcher.matched()) {
+                        s.lru.splice(s.lru.begin(), s.lru, it->second);
+                        m_hits.fetch_add(1, std::memory_order_relaxed);
+                        return std::static_pointer_cast<const TValue>(it->second->value);
+                    }
+                }
+            }
+
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            auto value  = std::make_shared<const TValue>(compute());
+            auto writer = impl::KeyWriter();
+            key(writer);
+
+            const auto bytes = Overhead + writer.words.size() * sizeof(uint64_t) + impl::footprint(*value);
+            insert(s, hash, std::move(writer.words), value, bytes);
+            return value;
+        }
+
+        [[nodiscard]] MemoStats stats()
+        {
+            auto result      = MemoStats {};
+            result.hits      = m_hits.load(std::memory_order_relaxed);
+            result.misses    = m_misses.load(std::memory_order_relaxed);
+            result.evictions = m_evictions.load(std::memory_order_relaxed);
+            for (auto& s : m_shards) {
+                const std::lock_guard lock(s.mutex);
+                result.entries += s.lru.size();
+                result.bytes += s.bytes;
+            }
+            return result;
+        }
+    };
+}    // namespace xll
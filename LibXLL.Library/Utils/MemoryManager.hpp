@@ -4,59 +4,241 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <xlcall.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
-#include <thread>
-
-namespace xll {
+#include <utility>
+#include <vector>
+
+namespace xll
+{
+
+    /**
+     * @brief Keeps ownership of XLOPER12s handed to Excel, until Excel hands them back for release.
+     *
+     * @details Every XLOPER12 is recorded together with the routine that releases it, which is instantiated for
+     * the type the value was created as. xlAutoFree12 therefore runs the destructor of the actual type (e.g.
+     * Array<Expected<Number>> rather than some other Array), and the release of a value that owns no memory
+     * besides its own buffer (e.g. Array<Number>) takes constant time.
+     *
+     * The registry is split into shards, each with its own lock, and a pointer always maps to the same
+     * shard. Threads of a multithreaded recalculation therefore rarely wait for each other: two threads only
+     * contend when their pointers happen to fall into the same shard. Each shard is a flat open-addressing
+     * table, so recording and releasing a pointer allocate nothing once the table has grown to size, and the
+     * XLOPER12s themselves are allocated and deallocated outside the locks.
+     */
+    class MemoryManager
+    {
+        using Release = void (*)(LPXLOPER12);
+
+        /**
+         * @brief The hash of a pointer. The low bits of a heap pointer are mostly alignment, so the bits are mixed
+         * (Fibonacci hashing); the top bits of the product select the shard, and the ones below the slot.
+         */
+        static uint64_t hash(const XLOPER12* ptr)
+        {
+            return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr)) * 0x9E3779B97F4A7C15ull;
+        }
 
-    class MemoryManager{
+        /**
+         * @brief A hash table with linear probing, at most half full. Entries are removed by shifting the following
+         * entries of the same probe sequence back, so no tombstones are left behind.
+         */
+        class Table
+        {
+            struct Entry
+            {
+                LPXLOPER12 key     = nullptr;
+                Release    release = nullptr;
+            };
+
+            std::vector<Entry> m_slots {};
+            std::size_t        m_size = 0;
+
+            [[nodiscard]] std::size_t home(const XLOPER12* ptr) const
+            {
+                return static_cast<std::size_t>((hash(ptr) << 6) >> (64 - std::countr_zero(m_slots.size())));
+            }
+
+            [[nodiscard]] std::size_t find(const XLOPER12* ptr) const
+            {
+                const auto mask = m_slots.size() - 1;
+                auto       i    = home(ptr);
+                while (m_slots[i].key != nullptr && m_slots[i].key != ptr) i = (i + 1) & mask;
+                return i;
+            }
+
+            void grow()
+            {
+                auto old = std::exchange(m_slots, std::vector<Entry>(std::max<std::size_t>(16, 2 * m_slots.size())));
+                for (const auto& entry : old)
+                    if (entry.key != nullptr) m_slots[find(entry.key)] = entry;
+            }
+
+        public:
+            void insert(LPXLOPER12 ptr, Release release)
+            {
+                if (2 * (m_size + 1) > m_slots.size()) grow();
+                auto& entry = m_slots[find(ptr)];
+                if (entry.key == nullptr) ++m_size;
+                entry = { ptr, release };
+            }
+
+            /**
+             * @brief Removes the pointer, and returns its release routine (nullptr if it was not present).
+             */
+            Release extract(const XLOPER12* ptr)
+            {
+                if (m_size == 0) return nullptr;
+
+                const auto mask = m_slots.size() - 1;
+                auto       i    = find(ptr);
+                if (m_slots[i].key == nullptr) return nullptr;
+
+                const auto release = m_slots[i].release;
+                for (auto j = (i + 1) & mask; m_slots[j].key != nullptr; j = (j + 1) & mask) {
+                    // The entry at j stays, unless the gap at i lies between its home slot and j.
+                    const auto k = home(m_slots[j].key);
+                    if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+                    m_slots[i] = m_slots[j];
+                    i          = j;
+                }
+                m_slots[i] = {};
+                --m_size;
+                return release;
+            }
+
+            [[nodiscard]] bool contains(const XLOPER12* ptr) const { return m_size != 0 && m_slots[find(ptr)].key != nullptr; }
+
+            [[nodiscard]] std::size_t size() const { return m_size; }
+
+            void release_all()
+            {
+                for (auto& entry : m_slots)
+                    if (entry.key != nullptr) entry.release(std::exchange(entry, {}).key);
+                m_size = 0;
+            }
+        };
+
+        static constexpr std::size_t Shards = 64;
+
+        struct alignas(64) Shard
+        {
+            Table      xlopers {};
+            std::mutex mutex;
+        };
 
         MemoryManager() = default;
-        ~MemoryManager() = default;
 
-        //gtl::parallel_node_hash_map<LPXLOPER12, std::unique_ptr<XLOPER12>> m_xlopers {};
-        std::unordered_map<LPXLOPER12, std::unique_ptr<XLOPER12>> m_xlopers {};
-        std::mutex mutex;
+        ~MemoryManager()
+        {
+            for (auto& s : m_shards) s.xlopers.release_all();
+        }
 
+        std::array<Shard, Shards> m_shards {};
 
-    public:
+        Shard& shard(const XLOPER12* ptr)
+        {
+            static_assert(Shards == 64, "The shard is taken from the top 6 bits of the hash");
+            return m_shards[hash(ptr) >> 58];
+        }
 
-        MemoryManager(const MemoryManager&) = delete;
-        MemoryManager& operator = (const MemoryManager&) = delete;
+        /**
+         * @brief Deletes a T, which may still carry the xlbitDLLFree flag it was returned to Excel with.
+         */
+        template<typename T>
+        static void destroy(LPXLOPER12 ptr)
+        {
+            ptr->xltype &= ~xlbitDLLFree;
+            delete static_cast<T*>(ptr);
+        }
 
-        LPXLOPER12 add(const XLOPER12& obj)
+    public:
+        MemoryManager(const MemoryManager&)            = delete;
+        MemoryManager& operator=(const MemoryManager&) = delete;
+
+        /**
+         * @brief Takes ownership of value, which will be deleted as a T when it is passed to erase().
+         *
+         * @return The owned pointer, which stays valid until it is passed to erase().
+         */
+        template<typename T>
+            requires std::derived_from<T, XLOPER12>
+        T* adopt(std::unique_ptr<T> value)
         {
-            auto val = std::make_unique<XLOPER12>(obj);
-            auto key = val.get();
+            const auto key = value.get();
 
-            const std::lock_guard<std::mutex> lock(mutex);
+            {
+                auto&                             s = shard(key);
+                const std::lock_guard<std::mutex> lock(s.mutex);
+                s.xlopers.insert(key, &destroy<T>);
+            }
 
-            m_xlopers[key] = std::move(val);
-            return m_xlopers[key].get();
-            // return key;
+            return value.release();
         }
 
-        void erase(LPXLOPER12 ptr)
+        /**
+         * @brief Copies obj into a new XLOPER12 owned by the registry.
+         *
+         * @return A pointer to the copy, which stays valid until it is passed to erase().
+         */
+        LPXLOPER12 add(const XLOPER12& obj) { return adopt(std::make_unique<XLOPER12>(obj)); }
+
+        /**
+         * @brief Releases an XLOPER12 created by add() or adopt(), as the type it was created as.
+         *
+         * @return true if the pointer was owned by the registry (and has been released), false otherwise.
+         */
+        bool erase(LPXLOPER12 ptr)
         {
-            using namespace std::literals;
+            auto& s = shard(ptr);
 
-            // if (!m_xlopers.contains(ptr))
-                // std::this_thread::sleep_for(100ms);
-            // if (!m_xlopers.contains(ptr))
-                // return;
+            Release release = nullptr;
+            {
+                const std::lock_guard<std::mutex> lock(s.mutex);
+                release = s.xlopers.extract(ptr);
+            }
 
-            const std::lock_guard<std::mutex> lock(mutex);
+            if (release == nullptr) return false;
+            release(ptr);
+            return true;
+        }
 
-            auto sz = m_xlopers.size();
-            m_xlopers.erase(ptr);
-            sz = m_xlopers.size();
+        /**
+         * @brief Returns true if the pointer was created by add() or adopt(), and has not been released yet.
+         */
+        bool contains(const XLOPER12* ptr)
+        {
+            auto&                             s = shard(ptr);
+            const std::lock_guard<std::mutex> lock(s.mutex);
+            return s.xlopers.contains(ptr);
         }
 
-        static MemoryManager& Instance(){
-            static MemoryManager instance;        // (1)
+        /**
+         * @brief Returns the number of XLOPER12s that have been added, but not yet released.
+         */
+        std::size_t size()
+        {
+            std::size_t count = 0;
+            for (auto& s : m_shards) {
+                const std::lock_guard<std::mutex> lock(s.mutex);
+                count += s.xlopers.size();
+            }
+            return count;
+        }
+
+        static MemoryManager& Instance()
+        {
+            static MemoryManager instance;
             return instance;
         }
     };
 
-}
\ No newline at end of file
+}    // namespace xll
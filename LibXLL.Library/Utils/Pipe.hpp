@@ -85,11 +85,31 @@ namespace xll
     // }
 
     template<typename T, typename TFunc>
-        // requires(not std::ranges::range<T> and std::invocable<Function, T>)
-        requires std::same_as<TFunc, decltype(AutoFree())>
-    constexpr auto operator|(const Array<T>& t, TFunc&& f) -> std::invoke_result_t<TFunc, Array<T>>
+        requires std::same_as<std::remove_cvref_t<TFunc>, decltype(ArenaFree())>
+    constexpr LPXLOPER12 operator|(const Array<T>& t, TFunc&& f)
     {
         return std::invoke(std::forward<TFunc>(f), t);
     }
 
+    template<typename TFunc>
+        requires std::same_as<std::remove_cvref_t<TFunc>, decltype(ArenaFree())>
+    constexpr LPXLOPER12 operator|(ArenaArray&& t, TFunc&& f)
+    {
+        return std::invoke(std::forward<TFunc>(f), std::move(t));
+    }
+
+    /**
+     * @brief Hands a result to Excel with AutoFree() or ThreadLocal(), keeping its value category: a temporary (or
+     * a result passed with std::move) is moved, which takes over its buffers in constant time, while an lvalue is
+     * copied.
+     */
+    template<typename T, typename TFunc>
+        requires std::derived_from<std::remove_cvref_t<T>, XLOPER12> &&
+                 (std::same_as<std::remove_cvref_t<TFunc>, decltype(AutoFree())> ||
+                  std::same_as<std::remove_cvref_t<TFunc>, decltype(ThreadLocal())>)
+    constexpr auto operator|(T&& t, TFunc&& f) -> std::invoke_result_t<TFunc, T>
+    {
+        return std::invoke(std::forward<TFunc>(f), std::forward<T>(t));
+    }
+
 }    // namespace xll
\ No newline at end of file
@@ -0,0 +1,259 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace xll
+{
+    namespace impl
+    {
+        /**
+         * @brief The number of calls to operator new so far. Only counted in add-ins that define
+         * XLL_PROFILE_ALLOCATIONS in one translation unit before including this header.
+         */
+        inline std::atomic<size_t> profiler_allocations { 0 };
+        inline bool                profiler_counts_allocations = false;
+    }    // namespace impl
+
+    /**
+     * @brief A step recorded by the Profiler.
+     */
+    struct ProfileStep
+    {
+        using duration = std::chrono::steady_clock::duration;
+
+        std::string name {};
+        size_t      depth = 0;          // The number of enclosing steps.
+        duration    elapsed {};
+        size_t      allocations = 0;    // Calls to operator new during the step, if counted.
+        bool        failed      = false;
+        std::string error {};
+    };
+
+    /**
+     * @brief Records the wall time, allocation count and outcome of the steps of loading the add-in.
+     *
+     * @details The profiler is off by default. It is switched on with enable(), or by setting the environment
+     * variable XLL_PROFILE before Excel loads the add-in, in which case a non-empty value is the path of a file
+     * that the report is written to after each xlAuto* event. In add-ins that define XLL_PROFILE_FUNCTION in one
+     * translation unit before including the library, the report can also be read from a worksheet with the hidden
+     * function =<PREFIX>.XLL.PROFILE(), where <PREFIX> is the name of the add-in (see get_module_prefix()).
+     *
+     * Measured are Registry::register_all, the Before and After hooks of each event, the event itself, and each
+     * xlfRegister call in xlAutoOpen. When the profiler is off, measure() costs a single relaxed atomic load, and
+     * the name of the step is not even formatted. Times are taken from std::chrono::steady_clock.
+     */
+    class Profiler
+    {
+        Profiler()
+        {
+            if (const char* path = std::getenv("XLL_PROFILE")) enable(path);
+        }
+
+        std::atomic<bool>        m_enabled { false };
+        std::string              m_path {};
+        std::vector<ProfileStep> m_steps {};
+        size_t                   m_depth = 0;
+        mutable std::mutex       m_mutex;
+
+        class Scope
+        {
+            Profiler&                             m_profiler;
+            size_t                                m_index;
+            size_t                                m_allocations;
+            std::chrono::steady_clock::time_point m_start;
+
+        public:
+            Scope(Profiler& profiler, std::string name)
+                : m_profiler(profiler),
+                  m_index(profiler.begin(std::move(name))),
+                  m_allocations(impl::profiler_allocations.load(std::memory_order_relaxed)),
+                  m_start(std::chrono::steady_clock::now())
+            {}
+
+            Scope(const Scope&)            = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            ~Scope()
+            {
+                const auto elapsed     = std::chrono::steady_clock::now() - m_start;
+                const auto allocations = impl::profiler_allocations.load(std::memory_order_relaxed) - m_allocations;
+                m_profiler.end(m_index, elapsed, allocations);
+            }
+
+            void fail(std::string error) { m_profiler.fail(m_index, std::move(error)); }
+        };
+
+        size_t begin(std::string name)
+        {
+            std::lock_guard lock(m_mutex);
+            m_steps.push_back({ .name = std::move(name), .depth = m_depth++ });
+            return m_steps.size() - 1;
+        }
+
+        void end(size_t index, ProfileStep::duration elapsed, size_t allocations)
+        {
+            std::lock_guard lock(m_mutex);
+            --m_depth;
+            if (index >= m_steps.size()) return;    // Cleared while the step was running.
+            m_steps[index].elapsed     = elapsed;
+            m_steps[index].allocations = allocations;
+        }
+
+        void fail(size_t index, std::string error)
+        {
+            std::lock_guard lock(m_mutex);
+            if (index >= m_steps.size()) return;
+            m_steps[index].failed = true;
+            m_steps[index].error  = std::move(error);
+        }
+
+        template<typename TName>
+        static std::string label(TName&& name)
+        {
+            if constexpr (std::is_invocable_v<TName>)
+                return std::string(std::invoke(std::forward<TName>(name)));
+            else
+                return std::string(std::string_view(name));
+        }
+
+    public:
+        Profiler(const Profiler&)            = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        static Profiler& instance()
+        {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        /**
+         * @brief Switches the profiler on.
+         *
+         * @param path The file to write the report to after each xlAuto* event; none if empty.
+         */
+        void enable(std::string path = {})
+        {
+            std::lock_guard lock(m_mutex);
+            m_path = std::move(path);
+            m_enabled.store(true, std::memory_order_relaxed);
+        }
+
+        void disable() { m_enabled.store(false, std::memory_order_relaxed); }
+
+        [[nodiscard]] bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        void clear()
+        {
+            std::lock_guard lock(m_mutex);
+            m_steps.clear();
+        }
+
+        [[nodiscard]] std::vector<ProfileStep> steps() const
+        {
+            std::lock_guard lock(m_mutex);
+            return m_steps;
+        }
+
+        /**
+         * @brief Runs func as a named step, if the profiler is on, and returns its result.
+         *
+         * @details The name is either a string or a callable returning one, which is only called when the
+         * profiler is on. A step that throws is recorded as failed, with the message of the exception, and
+         * the exception is rethrown.
+         */
+        template<typename TName, typename TFunc>
+        decltype(auto) measure(TName&& name, TFunc&& func)
+        {
+            if (not enabled()) return std::invoke(std::forward<TFunc>(func));
+
+            Scope scope(*this, label(std::forward<TName>(name)));
+            try {
+                return std::invoke(std::forward<TFunc>(func));
+            }
+            catch (const std::exception& ex) {
+                scope.fail(ex.what());
+                throw;
+            }
+            catch (...) {
+                scope.fail("Unknown error");
+                throw;
+            }
+        }
+
+        /**
+         * @brief The recorded steps as text; one line per step, indented by depth.
+         */
+        [[nodiscard]] std::string to_string() const
+        {
+            using ms = std::chrono::duration<double, std::milli>;
+
+            std::string result = "Step,Milliseconds,Allocations,Status\n";
+            for (const auto& step : steps())
+                result += std::format("{}{},{:.3f},{},{}\n",
+                                      std::string(2 * step.depth, ' '),
+                                      step.name,
+                                      ms(step.elapsed).count(),
+                                      impl::profiler_counts_allocations ? std::to_string(step.allocations) : "n/a",
+                                      step.failed ? "Failed: " + step.error : "OK");
+            return result;
+        }
+
+        /**
+         * @brief Writes the report to the file given to enable() or in XLL_PROFILE, if any.
+         *
+         * @return True if the report was written.
+         */
+        bool write() const
+        {
+            if (not enabled()) return false;
+
+            std::string path;
+            {
+                std::lock_guard lock(m_mutex);
+                path = m_path;
+            }
+
+            if (path.empty()) return false;
+            std::ofstream file(path, std::ios::trunc);
+            file << to_string();
+            return static_cast<bool>(file);
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const Profiler& profiler) { return os << profiler.to_string(); }
+    };
+
+}    // namespace xll
+
+#ifdef XLL_PROFILE_ALLOCATIONS
+// The remaining forms of operator new and delete forward to these two.
+namespace
+{
+    [[maybe_unused]] const bool xll_profiler_counts_allocations = (xll::impl::profiler_counts_allocations = true);
+}
+
+void* operator new(size_t size)
+{
+    xll::impl::profiler_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+#endif
@@ -4,7 +4,15 @@
 
 #pragma once
 
+#include "../Async/AsyncHandle.hpp"
 #include "../Types/Array.hpp"
+#include "../Types/NumericArray.hpp"
+#include "../Types/StringRef.hpp"
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <string_view>
 
 namespace xll
 {
@@ -28,6 +36,18 @@ namespace xll::traits
         static constexpr std::string_view excel_type = "B";
     };
 
+    template<>
+    struct arg_traits<short>
+    {
+        static constexpr std::string_view excel_type = "A";
+    };
+
+    template<>
+    struct arg_traits<int32_t>
+    {
+        static constexpr std::string_view excel_type = "J";
+    };
+
     template<>
     struct arg_traits<std::string>
     {
@@ -40,12 +60,36 @@ namespace xll::traits
         static constexpr std::string_view excel_type = "C";
     };
 
+    template<>
+    struct arg_traits<const char*>
+    {
+        static constexpr std::string_view excel_type = "C";
+    };
+
+    template<>
+    struct arg_traits<std::basic_string_view<XCHAR>>
+    {
+        static constexpr std::string_view excel_type = "D%";
+    };
+
+    template<>
+    struct arg_traits<const XCHAR*>
+    {
+        static constexpr std::string_view excel_type = "D%";
+    };
+
     template<>
     struct arg_traits<String>
     {
         static constexpr std::string_view excel_type = "Q";
     };
 
+    template<>
+    struct arg_traits<StringRef>
+    {
+        static constexpr std::string_view excel_type = "Q";
+    };
+
     template<>
     struct arg_traits<Number>
     {
@@ -58,8 +102,53 @@ namespace xll::traits
         static constexpr std::string_view excel_type = "Q";
     };
 
+    template<>
+    struct arg_traits<NumericArray>
+    {
+        static constexpr std::string_view excel_type = "K%";
+    };
+
+    template<>
+    struct arg_traits<std::span<const double>>
+    {
+        static constexpr std::string_view excel_type = "K%";
+    };
+
+    // Pointers, as they appear in the signature of an exported function: XLOPER12-based types are passed as
+    // "Q", and FP12-based ones (NumericArray) as "K%".
+    template<typename T>
+        requires std::derived_from<std::remove_cv_t<T>, XLOPER12>
+    struct arg_traits<T*>
+    {
+        static constexpr std::string_view excel_type = "Q";
+    };
+
     template<typename T>
-    struct arg_traits<Variant<T>>
+        requires std::derived_from<std::remove_cv_t<T>, FP12>
+    struct arg_traits<T*>
+    {
+        static constexpr std::string_view excel_type = "K%";
+    };
+
+    // The handle of an asynchronous function.
+    template<>
+    struct arg_traits<const AsyncHandle*>
+    {
+        static constexpr std::string_view excel_type = "X";
+    };
+
+    template<>
+    struct arg_traits<AsyncHandle*> : arg_traits<const AsyncHandle*>
+    {};
+
+    template<unsigned N>
+    struct arg_traits<InPlace<N>>
+    {
+        static constexpr std::string_view excel_type = std::string_view("123456789").substr(N - 1, 1);
+    };
+
+    template<typename T, typename... Ts>
+    struct arg_traits<Variant<T, Ts...>>
     {
         static constexpr std::string_view excel_type = "Q";
     };
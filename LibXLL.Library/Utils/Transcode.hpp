@@ -0,0 +1,382 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <compare>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define XLL_TRANSCODE_SSE2 1
+#endif
+
+/**
+ * @file Transcode.hpp
+ * @brief One-pass conversion between UTF-8 and the wide encoding used by XCHAR (UTF-16 on Windows, UTF-32 elsewhere).
+ *
+ * @details Both directions write straight into a caller-provided buffer of worst-case size, so a conversion is a
+ * single pass over the input with no intermediate strings. Runs of ASCII characters, which dominate identifiers,
+ * tickers and keys, are converted 16 (SSE2) or 32 (AVX2) characters at a time; everything else goes through a
+ * validating scalar path. UTF-8 to wide conversion is also available at compile time (used by the _xs literal).
+ */
+namespace xll::impl::utf
+{
+    template<typename TChar>
+    concept wide_char = (sizeof(TChar) == 2 || sizeof(TChar) == 4) && std::is_integral_v<TChar>;
+
+    namespace detail
+    {
+        [[noreturn]] inline void invalid() { throw std::runtime_error("String conversion failed"); }
+
+        constexpr bool is_continuation(unsigned char c) { return (c & 0xC0) == 0x80; }
+
+        /**
+         * @brief Widens a block of ASCII characters, returning the number of characters converted.
+         */
+        template<wide_char TChar>
+        constexpr std::size_t widen_ascii(const char* input, std::size_t size, TChar* output)
+        {
+            std::size_t i = 0;
+            if (not std::is_constant_evaluated()) {
+#if defined(__AVX2__)
+                for (; i + 32 <= size; i += 32) {
+                    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+                    if (_mm256_movemask_epi8(chunk) != 0) break;
+
+                    const auto lo = _mm256_castsi256_si128(chunk);
+                    const auto hi = _mm256_extracti128_si256(chunk, 1);
+                    auto*      out = reinterpret_cast<__m256i*>(output + i);
+                    if constexpr (sizeof(TChar) == 2) {
+                        _mm256_storeu_si256(out + 0, _mm256_cvtepu8_epi16(lo));
+                        _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi16(hi));
+                    }
+                    else {
+                        _mm256_storeu_si256(out + 0, _mm256_cvtepu8_epi32(lo));
+                        _mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+                        _mm256_storeu_si256(out + 2, _mm256_cvtepu8_epi32(hi));
+                        _mm256_storeu_si256(out + 3, _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+                    }
+                }
+#endif
+#if defined(XLL_TRANSCODE_SSE2)
+                const auto zero = _mm_setzero_si128();
+                for (; i + 16 <= size; i += 16) {
+                    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+                    if (_mm_movemask_epi8(chunk) != 0) break;
+
+                    const auto lo  = _mm_unpacklo_epi8(chunk, zero);
+                    const auto hi  = _mm_unpackhi_epi8(chunk, zero);
+                    auto*      out = reinterpret_cast<__m128i*>(output + i);
+                    if constexpr (sizeof(TChar) == 2) {
+                        _mm_storeu_si128(out + 0, lo);
+                        _mm_storeu_si128(out + 1, hi);
+                    }
+                    else {
+                        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(lo, zero));
+                        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+                        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+                        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+                    }
+                }
+#endif
+            }
+            for (; i < size && static_cast<unsigned char>(input[i]) < 0x80; ++i) output[i] = static_cast<TChar>(input[i]);
+            return i;
+        }
+
+        /**
+         * @brief Narrows a block of ASCII code units, returning the number of code units converted.
+         */
+        template<wide_char TChar>
+        inline std::size_t narrow_ascii(const TChar* input, std::size_t size, char* output)
+        {
+            std::size_t i = 0;
+#if defined(XLL_TRANSCODE_SSE2)
+            const auto zero = _mm_setzero_si128();
+            for (; i + 16 <= size; i += 16) {
+                const auto* in = reinterpret_cast<const __m128i*>(input + i);
+                __m128i     packed;
+                if constexpr (sizeof(TChar) == 2) {
+                    const auto a = _mm_loadu_si128(in + 0);
+                    const auto b = _mm_loadu_si128(in + 1);
+                    const auto high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)));
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) break;
+                    packed = _mm_packus_epi16(a, b);
+                }
+                else {
+                    const auto a = _mm_loadu_si128(in + 0);
+                    const auto b = _mm_loadu_si128(in + 1);
+                    const auto c = _mm_loadu_si128(in + 2);
+                    const auto d = _mm_loadu_si128(in + 3);
+                    const auto high = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), _mm_set1_epi32(~0x7F));
+                    if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, zero)) != 0xFFFF) break;
+                    packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+            }
+#endif
+            for (; i < size && static_cast<std::uint32_t>(input[i]) < 0x80; ++i) output[i] = static_cast<char>(input[i]);
+            return i;
+        }
+    }    // namespace detail
+
+    /**
+     * @brief Converts UTF-8 to UTF-16 or UTF-32 (depending on the size of TChar).
+     *
+     * @param input The UTF-8 input.
+     * @param output The output buffer; must hold at least input.size() code units.
+     * @return The number of code units written.
+     * @throws std::runtime_error if the input is not valid UTF-8 (including overlong forms and surrogates).
+     */
+    template<wide_char TChar>
+    constexpr std::size_t from_utf8(std::string_view input, TChar* output)
+    {
+        const auto* data = input.data();
+        const auto  size = input.size();
+
+        std::size_t in  = 0;
+        std::size_t out = 0;
+        while (in < size) {
+            if (static_cast<unsigned char>(data[in]) < 0x80) {
+                const auto count = detail::widen_ascii(data + in, size - in, output + out);
+                in += count;
+                out += count;
+                continue;
+            }
+
+            const auto    lead    = static_cast<unsigned char>(data[in]);
+            std::uint32_t code    = 0;
+            std::size_t   length  = 0;
+            std::uint32_t minimum = 0;
+            if ((lead & 0xE0) == 0xC0) {
+                code    = lead & 0x1F;
+                length  = 2;
+                minimum = 0x80;
+            }
+            else if ((lead & 0xF0) == 0xE0) {
+                code    = lead & 0x0F;
+                length  = 3;
+                minimum = 0x800;
+            }
+            else if ((lead & 0xF8) == 0xF0) {
+                code    = lead & 0x07;
+                length  = 4;
+                minimum = 0x10000;
+            }
+            else
+                detail::invalid();
+
+            if (in + length > size) detail::invalid();
+            for (std::size_t k = 1; k < length; ++k) {
+                const auto c = static_cast<unsigned char>(data[in + k]);
+                if (not detail::is_continuation(c)) detail::invalid();
+                code = (code << 6) | (c & 0x3F);
+            }
+            if (code < minimum || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) detail::invalid();
+            in += length;
+
+            if constexpr (sizeof(TChar) == 2) {
+                if (code >= 0x10000) {
+                    code -= 0x10000;
+                    output[out++] = static_cast<TChar>(0xD800 + (code >> 10));
+                    output[out++] = static_cast<TChar>(0xDC00 + (code & 0x3FF));
+                    continue;
+                }
+            }
+            output[out++] = static_cast<TChar>(code);
+        }
+
+        return out;
+    }
+
+    /**
+     * @brief The number of UTF-8 bytes that to_utf8 may produce per input code unit, in the worst case.
+     */
+    template<wide_char TChar>
+    constexpr std::size_t max_utf8_per_unit = sizeof(TChar) == 2 ? 3 : 4;
+
+    /**
+     * @brief Converts UTF-16 or UTF-32 (depending on the size of TChar) to UTF-8.
+     *
+     * @details Invalid code units (unpaired surrogates, values beyond U+10FFFF) are replaced by U+FFFD, so
+     * that strings received from Excel can always be converted.
+     *
+     * @param input The input code units.
+     * @param size The number of input code units.
+     * @param output The output buffer; must hold at least size * max_utf8_per_unit<TChar> bytes.
+     * @return The number of bytes written.
+     */
+    template<wide_char TChar>
+    std::size_t to_utf8(const TChar* input, std::size_t size, char* output)
+    {
+        std::size_t in  = 0;
+        std::size_t out = 0;
+        while (in < size) {
+            auto code = static_cast<std::uint32_t>(input[in]);
+            if (code < 0x80) {
+                const auto count = detail::narrow_ascii(input + in, size - in, output + out);
+                in += count;
+                out += count;
+                continue;
+            }
+            ++in;
+
+            if (code >= 0xD800 && code <= 0xDFFF) {
+                if constexpr (sizeof(TChar) == 2) {
+                    const auto low = in < size ? static_cast<std::uint32_t>(input[in]) : 0u;
+                    if (code <= 0xDBFF && low >= 0xDC00 && low <= 0xDFFF) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        ++in;
+                    }
+                    else
+                        code = 0xFFFD;
+                }
+                else
+                    code = 0xFFFD;
+            }
+            else if (code > 0x10FFFF)
+                code = 0xFFFD;
+
+            if (code < 0x800) {
+                output[out++] = static_cast<char>(0xC0 | (code >> 6));
+                output[out++] = static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000) {
+                output[out++] = static_cast<char>(0xE0 | (code >> 12));
+                output[out++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                output[out++] = static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else {
+                output[out++] = static_cast<char>(0xF0 | (code >> 18));
+                output[out++] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                output[out++] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                output[out++] = static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        return out;
+    }
+
+    /**
+     * @brief Converts UTF-16 or UTF-32 (depending on the size of TChar) to a UTF-8 std::string.
+     */
+    template<wide_char TChar>
+    std::string to_utf8(std::basic_string_view<TChar> input)
+    {
+        std::string result;
+        result.resize_and_overwrite(input.size() * max_utf8_per_unit<TChar>,
+                                    [&](char* buffer, std::size_t) { return to_utf8(input.data(), input.size(), buffer); });
+        return result;
+    }
+
+    /**
+     * @brief Compares UTF-16 or UTF-32 text with UTF-8 text by code point, without allocating.
+     *
+     * @details The wide text is encoded one code point at a time and compared byte-wise with the UTF-8 text;
+     * since UTF-8 preserves code point order, the result is the code point ordering of the two strings.
+     */
+    template<wide_char TChar>
+    std::strong_ordering compare_utf8(std::basic_string_view<TChar> lhs, std::string_view rhs)
+    {
+        char        buffer[4];
+        std::size_t pos = 0;
+
+        for (std::size_t in = 0; in < lhs.size();) {
+            const auto code = static_cast<std::uint32_t>(lhs[in]);
+            if (code < 0x80) {
+                if (pos == rhs.size()) return std::strong_ordering::greater;
+                if (const auto cmp = code <=> static_cast<std::uint32_t>(static_cast<unsigned char>(rhs[pos])); cmp != 0) return cmp;
+                ++in;
+                ++pos;
+                continue;
+            }
+
+            // Only a high surrogate followed by a low surrogate is taken as a pair; anything else is a lone
+            // unit, which to_utf8 encodes as U+FFFD, so that a single code point never exceeds the buffer.
+            auto units = std::size_t { 1 };
+            if constexpr (sizeof(TChar) == 2)
+                if (code >= 0xD800 && code <= 0xDBFF && in + 1 < lhs.size()) {
+                    const auto low = static_cast<std::uint32_t>(lhs[in + 1]);
+                    if (low >= 0xDC00 && low <= 0xDFFF) units = 2;
+                }
+
+            const auto bytes = to_utf8(lhs.data() + in, units, buffer);
+            in += units;
+            for (std::size_t k = 0; k < bytes; ++k, ++pos) {
+                if (pos == rhs.size()) return std::strong_ordering::greater;
+                const auto cmp = static_cast<unsigned char>(buffer[k]) <=> static_cast<unsigned char>(rhs[pos]);
+                if (cmp != 0) return cmp;
+            }
+        }
+
+        return pos == rhs.size() ? std::strong_ordering::equal : std::strong_ordering::less;
+    }
+
+    namespace detail
+    {
+        // The code point that starts at text[pos], and the number of units it takes. Invalid units count as
+        // U+FFFD, as in to_utf8.
+        template<wide_char TChar>
+        constexpr std::pair<std::uint32_t, std::size_t> code_point(std::basic_string_view<TChar> text, std::size_t pos)
+        {
+            const auto code = static_cast<std::uint32_t>(text[pos]);
+            if (code < 0xD800 || (code > 0xDFFF && code <= 0x10FFFF)) return { code, 1 };
+
+            if constexpr (sizeof(TChar) == 2)
+                if (code <= 0xDBFF && pos + 1 < text.size()) {
+                    const auto low = static_cast<std::uint32_t>(text[pos + 1]);
+                    if (low >= 0xDC00 && low <= 0xDFFF) return { 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00), 2 };
+                }
+
+            return { 0xFFFD, 1 };
+        }
+    }    // namespace detail
+
+    /**
+     * @brief Compares two UTF-16 or UTF-32 texts by code point, as compare_utf8 does.
+     *
+     * @details Comparing UTF-16 by code unit would put U+10000 and above (surrogate pairs) before U+E000-U+FFFF.
+     * The texts are therefore compared by unit only up to the first difference, from where the code points are
+     * compared. Texts that differ only in invalid units, which both count as U+FFFD, are ordered by unit, so that
+     * only equal texts compare equal.
+     */
+    template<wide_char TChar>
+    constexpr std::strong_ordering compare_wide(std::basic_string_view<TChar> lhs, std::basic_string_view<TChar> rhs)
+    {
+        std::size_t pos = 0;
+        while (pos < lhs.size() && pos < rhs.size() && lhs[pos] == rhs[pos]) ++pos;
+
+        // A difference in the low surrogate of a pair is compared from the high surrogate:
+        if constexpr (sizeof(TChar) == 2)
+            if (pos > 0 && static_cast<std::uint32_t>(lhs[pos - 1]) >= 0xD800 && static_cast<std::uint32_t>(lhs[pos - 1]) <= 0xDBFF)
+                --pos;
+
+        auto l = pos;
+        auto r = pos;
+        while (l < lhs.size() && r < rhs.size()) {
+            const auto [lcode, lunits] = detail::code_point(lhs, l);
+            const auto [rcode, runits] = detail::code_point(rhs, r);
+            if (lcode != rcode) return lcode <=> rcode;
+            l += lunits;
+            r += runits;
+        }
+        if (l < lhs.size()) return std::strong_ordering::greater;
+        if (r < rhs.size()) return std::strong_ordering::less;
+
+        return lhs <=> rhs;
+    }
+
+}    // namespace xll::impl::utf
@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include "../Types/Int.hpp"
 #include <xlcall.hpp>
 
+#include <stdexcept>
+
 namespace xll
 {
 
@@ -21,12 +24,16 @@ namespace xll
     template<typename TResult>
     TResult coerce(LPXLOPER12 src)
     {
-        TResult value {};
+        // The result is written into a plain XLOPER12, as any memory it points to is owned
+        // by Excel and must be handed back through xlFree rather than a TResult destructor.
+        XLOPER12 value {};
         // auto destType = (TResult{} | ...);
         xll::Int destType {};
-        destType.val.w = value.xltype;
-        Excel12(xlCoerce, &value, 2, src, &destType);
-        TResult result = value;
+        destType.val.w = static_cast<int>(TResult::excel_type);
+        if (Excel12(xlCoerce, &value, 2, src, &destType) != xlretSuccess)
+            throw std::runtime_error("xlCoerce failed");
+
+        TResult result = TResult(value);
         Excel12(xlFree, nullptr, 1, &value);
         return result;
 
@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <cctype>
+#include <string>
+
 namespace xll
 {
 
@@ -16,4 +19,27 @@ namespace xll
         return result;
     }
 
+    /**
+     * @brief Returns a prefix for the names the library registers on behalf of the add-in, so that two add-ins
+     * built on the library don't register the same names.
+     *
+     * @details The prefix is the file name of the add-in without its extension, in upper case, with every
+     * character that isn't a letter or a digit replaced by an underscore (e.g. "C:\AddIns\My-AddIn.xll" gives
+     * "MY_ADDIN"). A leading underscore is added if the name would start with a digit.
+     */
+    inline std::string get_module_prefix()
+    {
+        auto name = get_name().to_string();
+        name      = name.substr(name.find_last_of("\\/") + 1);
+        name      = name.substr(0, name.find_last_of('.'));
+
+        for (auto& c : name) {
+            const auto u = static_cast<unsigned char>(c);
+            c            = std::isalnum(u) ? static_cast<char>(std::toupper(u)) : '_';
+        }
+        if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front()))) name.insert(0, "_");
+
+        return name;
+    }
+
 }    // namespace xll
\ No newline at end of file
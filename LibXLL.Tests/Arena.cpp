@@ -0,0 +1,111 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Types/StringRef.hpp"
+#include "../Utils/Arena.hpp"
+#include "../Utils/Pipe.hpp"
+
+#include <stdexcept>
+#include <string>
+
+TEST_CASE( "Arena Packing", "[xll::Arena]" )
+{
+    auto& arena  = xll::Arena::instance();
+    const auto blocks = arena.size();
+
+    using variant_t = xll::Variant<xll::Nil, xll::String, xll::Int, xll::Number>;
+    auto arr = xll::Array<variant_t>(2, 3);
+    arr[0] = xll::String("alpha");
+    arr[1] = xll::Number(1.5);
+    arr[2] = xll::String("");
+    arr[3] = xll::Int(7);
+    arr[5] = xll::String("omega");
+
+    auto* packed = arr | xll::ArenaFree();
+    REQUIRE(arena.size() == blocks + 1);
+    REQUIRE(packed->xltype == (xltypeMulti | xlbitDLLFree));
+    REQUIRE(packed->val.array.rows == 2);
+    REQUIRE(packed->val.array.columns == 3);
+
+    // Cells and string payloads are located inside the block, right after the header:
+    const auto* cells = packed->val.array.lparray;
+    REQUIRE(cells == packed + 1);
+    REQUIRE(reinterpret_cast<const void*>(cells[0].val.str) >= cells + 6);
+    REQUIRE(cells[0].val.str != arr[0].val.str);
+
+    // Contents are preserved:
+    packed->xltype &= ~xlbitDLLFree;
+    const auto& copy = *reinterpret_cast<xll::Array<variant_t>*>(packed);
+    REQUIRE(xll::get<xll::String>(copy[0]) == "alpha");
+    REQUIRE(xll::get<xll::Number>(copy[1]) == 1.5);
+    REQUIRE(xll::get<xll::String>(copy[2]).empty());
+    REQUIRE(xll::get<xll::Int>(copy[3]) == 7);
+    REQUIRE(copy[4].xltype == xltypeNil);
+    REQUIRE(xll::get<xll::String>(copy[5]) == "omega");
+    packed->xltype |= xlbitDLLFree;
+
+    // Released as a single block by xlAutoFree12:
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.release(packed);
+    REQUIRE(arena.size() == blocks);
+    host.uninstall();
+
+    // Pointers not created by the Arena are left alone:
+    auto number = xll::Number(1.0);
+    REQUIRE(not arena.release(&number));
+
+    // Scalars and strings can be packed as well:
+    auto* str = xll::ArenaFree()(xll::String("single"));
+    REQUIRE(str->xltype == (xltypeStr | xlbitDLLFree));
+    REQUIRE(str->val.str[0] == 6);
+    REQUIRE(reinterpret_cast<const void*>(str->val.str) == str + 1);
+    REQUIRE(arena.release(str));
+}
+
+TEST_CASE( "Arena Building", "[xll::Arena]" )
+{
+    auto&      arena  = xll::Arena::instance();
+    const auto blocks = arena.size();
+
+    // Cells are written straight into the block; unset cells are Nil:
+    auto arr = xll::ArenaArray(3, 2);
+    arr.set(0, 0, "alpha");
+    arr.set(0, 1, 1.5);
+    arr.set(1, 0, xll::String("Straße 😊"));
+    arr.set(1, 1, xll::Bool(true));
+    REQUIRE(arr.at(2, 1).xltype == xltypeNil);
+    REQUIRE_THROWS_AS(arr.set(3, 0, 1.0), std::out_of_range);
+    REQUIRE_THROWS_AS(arr.set(0, 0, xll::Array<xll::Number>(1, 1)), std::invalid_argument);
+
+    // Growing the block keeps earlier strings intact:
+    for (int i = 0; i < 20; ++i) arr.set(2, 0, std::string(100, 'x'));
+    REQUIRE(arr.at(2, 0).val.str[0] == 100);
+
+    auto* built = std::move(arr) | xll::ArenaFree();
+    REQUIRE(arena.size() == blocks + 1);
+    REQUIRE(built->xltype == (xltypeMulti | xlbitDLLFree));
+    REQUIRE(built->val.array.rows == 3);
+    REQUIRE(built->val.array.columns == 2);
+    REQUIRE(built->val.array.lparray == built + 1);
+
+    const auto* cells = built->val.array.lparray;
+    REQUIRE(reinterpret_cast<const void*>(cells[0].val.str) >= cells + 6);
+    REQUIRE(xll::StringRef(cells[0]) == "alpha");
+    REQUIRE(cells[1].val.num == 1.5);
+    REQUIRE(xll::StringRef(cells[2]) == "Straße 😊");
+    REQUIRE(cells[3].xltype == xltypeBool);
+    REQUIRE(cells[4].val.str[0] == 100);
+    REQUIRE(cells[5].xltype == xltypeNil);
+
+    // Released as a single block by xlAutoFree12:
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.release(built);
+    REQUIRE(arena.size() == blocks);
+    host.uninstall();
+}
@@ -5,6 +5,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <xlcall.hpp>
 #include "../Types/Array.hpp"
+#include "../Types/Expected.hpp"
+#include "../Types/Variant.hpp"
+
+#include <utility>
+#include <vector>
 
 TEST_CASE( "Array Construction", "[xll::Array]" ) {
 
@@ -41,4 +46,131 @@ TEST_CASE( "Array Construction", "[xll::Array]" ) {
     // REQUIRE(xll::get<xll::String>(arr3[3]) == "ITEM 3");
 
 
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Array Plain Data", "[xll::Array]" )
+{
+    static_assert(xll::impl::plain_data<xll::Number>);
+    static_assert(xll::impl::plain_data<xll::Expected<xll::Number>>);
+    static_assert(xll::impl::plain_data<xll::Variant<xll::Nil, xll::Number, xll::Int, xll::Bool>>);
+    static_assert(not xll::impl::plain_data<xll::String>);
+    static_assert(not xll::impl::plain_data<xll::Variant<xll::Nil, xll::String>>);
+    static_assert(not xll::impl::plain_data<xll::Expected<xll::String>>);
+
+    // Fill construction.
+    auto arr1 = xll::Array<xll::Number>(3, 2, xll::Number(1.5));
+    REQUIRE(arr1.rows() == 3);
+    REQUIRE(arr1.cols() == 2);
+    for (const auto& item : arr1) REQUIRE(item == 1.5);
+
+    // Copy construction yields an independent buffer.
+    for (int index = 0; auto& item : arr1) item = index++;
+    auto arr2 = arr1;
+    REQUIRE(arr2.val.array.lparray != arr1.val.array.lparray);
+    for (int index = 0; const auto& item : arr2) REQUIRE(item == index++);
+    arr1[0] = 42.0;
+    REQUIRE(arr2[0] == 0.0);
+
+    // Copy assignment.
+    auto arr3 = xll::Array<xll::Number>(1, 1);
+    arr3 = arr1;
+    REQUIRE(arr3.size() == 6);
+    REQUIRE(arr3[0] == 42.0);
+    REQUIRE(arr3[5] == 5.0);
+
+    // Default construction of a plain Variant array.
+    using plain_t = xll::Variant<xll::Nil, xll::Number, xll::Int, xll::Bool>;
+    auto arr4 = xll::Array<plain_t>(2, 2);
+    for (const auto& item : arr4) REQUIRE(item.xltype == xltypeNil);
+    arr4[1] = xll::Bool(true);
+    auto arr5 = arr4;
+    REQUIRE(arr5[1].xltype == xltypeBool);
+    REQUIRE(arr5[2].xltype == xltypeNil);
+
+    // make_array stores values and errors.
+    auto input = std::vector<fxt::expected<double, std::string>> { 1.0, fxt::unexpected(std::string("bad")), 3.0 };
+    auto arr6 = xll::make_array(input);
+    REQUIRE(arr6.size() == 3);
+    REQUIRE(arr6[0].value() == 1.0);
+    REQUIRE(not arr6[1].has_value());
+    REQUIRE(arr6[1].error() == xll::ErrNull);
+    REQUIRE(arr6[2].value() == 3.0);
+
+    // A range from Excel holding cells of other types is not copied bitwise into plain elements.
+    auto cells = std::vector<XLOPER12>(2);
+    cells[0].xltype  = xltypeNum;
+    cells[0].val.num = 1.0;
+    cells[1].xltype  = xltypeStr;
+    cells[1].val.str = nullptr;
+    auto range = XLOPER12();
+    range.xltype = xltypeMulti;
+    range.val.array.lparray = cells.data();
+    range.val.array.rows    = 2;
+    range.val.array.columns = 1;
+    REQUIRE_THROWS(xll::Array<xll::Number>(reinterpret_cast<const xll::Array<xll::Number>&>(range)));
+    REQUIRE_THROWS(xll::Array<plain_t>(reinterpret_cast<const xll::Array<plain_t>&>(range)));
+
+    cells[1].xltype  = xltypeErr;
+    cells[1].val.err = xlerrNA;
+    REQUIRE_THROWS(xll::Array<xll::Number>(reinterpret_cast<const xll::Array<xll::Number>&>(range)));
+    auto arr7 = xll::Array<xll::Expected<xll::Number>>(reinterpret_cast<const xll::Array<xll::Expected<xll::Number>>&>(range));
+    REQUIRE(arr7[0].value() == 1.0);
+    REQUIRE(not arr7[1].has_value());
+}
+
+TEST_CASE( "Array Views", "[xll::Array]" )
+{
+    auto arr = xll::Array<xll::Number>(3, 4);
+    for (int index = 0; auto& item : arr) item = index++;
+
+    // Two-dimensional indexing returns references:
+    REQUIRE(arr[1, 2] == 6.0);
+    arr[1, 2] = 60.0;
+    REQUIRE(arr[6] == 60.0);
+    REQUIRE(&std::as_const(arr)[2, 3] == &arr[11]);
+    REQUIRE_THROWS(arr[3, 0]);
+    REQUIRE_THROWS(arr[0, 4]);
+
+    // Full view:
+    auto view = arr.view();
+    REQUIRE(view.extent(0) == 3);
+    REQUIRE(view.extent(1) == 4);
+    REQUIRE(&view[0, 0] == &arr[0]);
+    view[2, 0] = -1.0;
+    REQUIRE(arr[8] == -1.0);
+
+    // Row view:
+    auto row = arr.row(1);
+    REQUIRE(row.extent(0) == 4);
+    REQUIRE(row[0] == 4.0);
+    REQUIRE(row[2] == 60.0);
+    row[3] = 70.0;
+    REQUIRE(arr[1, 3] == 70.0);
+    REQUIRE_THROWS(arr.row(3));
+
+    // Column view:
+    auto col = std::as_const(arr).col(1);
+    REQUIRE(col.extent(0) == 3);
+    REQUIRE(col[0] == 1.0);
+    REQUIRE(col[1] == 5.0);
+    REQUIRE(col[2] == 9.0);
+    REQUIRE_THROWS(arr.col(4));
+
+    // Block view:
+    auto block = arr.block(1, 1, 3, 3);
+    REQUIRE(block.extent(0) == 2);
+    REQUIRE(block.extent(1) == 2);
+    REQUIRE(block[0, 0] == 5.0);
+    REQUIRE(block[1, 1] == 10.0);
+    block[1, 0] = 90.0;
+    REQUIRE(arr[2, 1] == 90.0);
+    REQUIRE(arr.block(0, 0, 0, 0).size() == 0);
+    REQUIRE_THROWS(arr.block(2, 0, 1, 1));
+    REQUIRE_THROWS(arr.block(0, 0, 4, 1));
+
+    // Views over string arrays give access without copying the elements:
+    auto strings = xll::Array<xll::String>(2, 2);
+    strings[1, 0] = xll::String("Hello");
+    REQUIRE(strings.col(0)[1] == "Hello");
+    REQUIRE(strings.view()[1, 0].val.str == strings[2].val.str);
+}
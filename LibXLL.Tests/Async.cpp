@@ -0,0 +1,200 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Async.hpp"
+#include "../Types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    double async_scale_sum(double factor, std::span<const double> values)
+    {
+        return factor * std::accumulate(values.begin(), values.end(), 0.0);
+    }
+
+    std::string async_greet(std::string_view name)
+    {
+        if (name.empty()) throw std::domain_error("no name");
+        return "Hello, " + std::string(name);
+    }
+
+    xll::Number async_twice(const xll::Number& value) { return value * 2.0; }
+
+    double async_block()
+    {
+        while (not xll::async_cancelled()) std::this_thread::sleep_for(1ms);
+        return 0.0;
+    }
+
+    bool wait_for(auto&& condition)
+    {
+        for (int i = 0; i < 5000 && not condition(); ++i) std::this_thread::sleep_for(1ms);
+        return condition();
+    }
+}    // namespace
+
+XLL_ASYNC_UDF(AsyncScaleSum, async_scale_sum, factor, values)
+XLL_ASYNC_UDF(AsyncGreet, async_greet, name)
+XLL_ASYNC_UDF(AsyncTwice, async_twice, value)
+XLL_ASYNC_UDF(AsyncBlock, async_block)
+
+TEST_CASE( "Async Registration", "[xll::Async]" )
+{
+    // Asynchronous functions return nothing, and take the handle as their last parameter:
+    STATIC_REQUIRE(xll::impl::TypeText<AsyncScaleSum>::view() == ">BK%X");
+    STATIC_REQUIRE(xll::impl::TypeText<AsyncGreet, "$">::view() == ">CX$");
+    STATIC_REQUIRE(xll::impl::TypeText<AsyncTwice>::view() == ">QX");
+    STATIC_REQUIRE(xll::impl::TypeText<AsyncBlock>::view() == ">X");
+
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    xll::Function("ASYNC.SCALE.SUM")
+        | xll::Procedure("AsyncScaleSum")
+        | xll::Signature<AsyncScaleSum, "$">()
+        | xll::Argument("factor", "The scale factor")
+        | xll::Argument("values", "The values to sum")
+        | xll::Register();
+
+    REQUIRE(host.open() == XLL_SUCCESS);
+
+    auto registrations = host.registrations();
+    auto reg = std::ranges::find(registrations, std::string("AsyncScaleSum"), &xll::mock::ExcelHost::Registration::procedure);
+    REQUIRE(reg != registrations.end());
+    REQUIRE(reg->typeText == ">BK%X$");
+
+    // The command handling cancelled calculations is registered, and then registered for the event:
+    reg = std::ranges::find(registrations, std::string("xllAsyncCalculationCanceled"), &xll::mock::ExcelHost::Registration::procedure);
+    REQUIRE(reg != registrations.end());
+    REQUIRE(reg->macroType == 2);
+    REQUIRE(reg->typeText == "J");
+    REQUIRE(reg->functionText == "MOCK.XLL.ASYNC.CANCELED");
+
+    const auto events = host.events();
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].procedure == "MOCK.XLL.ASYNC.CANCELED");
+    REQUIRE(events[0].event == xleventCalculationCanceled);
+
+    REQUIRE(host.close() == XLL_SUCCESS);
+    host.uninstall();
+}
+
+TEST_CASE( "Async Calls", "[xll::Async]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+    xll::configure_async(4);
+
+    auto values = xll::NumericArray::make(3, 1);
+    std::ranges::copy(std::array { 1.0, 2.0, 3.0 }, values->begin());
+
+    // The calls return at once; the results follow through xlAsyncReturn:
+    constexpr size_t Calls   = 200;
+    auto             handles = std::vector<XLOPER12>();
+    for (size_t i = 0; i < Calls; ++i) {
+        handles.push_back(host.async_handle());
+        AsyncScaleSum(static_cast<double>(i), values.get(), static_cast<const xll::AsyncHandle*>(&handles.back()));
+    }
+    REQUIRE(host.wait_async(Calls, 5s));
+    for (size_t i = 0; i < Calls; ++i) {
+        const auto result = host.async_result(handles[i]);
+        REQUIRE(result.has_value());
+        REQUIRE(result->xltype == xltypeNum);
+        REQUIRE(result->number == 6.0 * static_cast<double>(i));
+    }
+
+    // The arguments are copied, as Excel's memory is only valid during the call:
+    auto handle = host.async_handle();
+    {
+        auto name = std::string("world");
+        AsyncGreet(name.c_str(), static_cast<const xll::AsyncHandle*>(&handle));
+        name = "XXXXX";
+    }
+    REQUIRE(host.wait_async(Calls + 1, 5s));
+    REQUIRE(host.async_result(handle)->text == "Hello, world");
+
+    // Exceptions are returned as errors:
+    handle = host.async_handle();
+    AsyncGreet("", static_cast<const xll::AsyncHandle*>(&handle));
+    REQUIRE(host.wait_async(Calls + 2, 5s));
+    REQUIRE(host.async_result(handle)->error == xlerrNum);
+
+    // ... and arguments of the wrong type are rejected at once, on the calling thread:
+    handle    = host.async_handle();
+    auto text = xll::String("not a number");
+    AsyncTwice(reinterpret_cast<const xll::Number*>(&text), static_cast<const xll::AsyncHandle*>(&handle));
+    REQUIRE(host.async_result(handle)->error == xlerrValue);
+
+    handle   = host.async_handle();
+    auto num = xll::Number(21.0);
+    AsyncTwice(&num, static_cast<const xll::AsyncHandle*>(&handle));
+    REQUIRE(host.wait_async(Calls + 4, 5s));
+    REQUIRE(host.async_result(handle)->number == 42.0);
+
+    REQUIRE(host.close() == XLL_SUCCESS);
+    host.uninstall();
+}
+
+TEST_CASE( "Async Cancellation", "[xll::Async]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+    REQUIRE(host.open() == XLL_SUCCESS);
+
+    // One worker, and room for two waiting calls:
+    xll::configure_async(1, 2);
+    const auto before = xll::async_stats();
+
+    auto handles = std::array { host.async_handle(), host.async_handle(), host.async_handle(), host.async_handle() };
+    AsyncBlock(static_cast<const xll::AsyncHandle*>(&handles[0]));
+    REQUIRE(wait_for([&] { return xll::impl::AsyncRuntime::instance().pool().queued() == 0; }));
+
+    auto num = xll::Number(1.0);
+    AsyncTwice(&num, static_cast<const xll::AsyncHandle*>(&handles[1]));
+    AsyncTwice(&num, static_cast<const xll::AsyncHandle*>(&handles[2]));
+
+    // The queue is full, so the next call runs on the calling thread:
+    AsyncTwice(&num, static_cast<const xll::AsyncHandle*>(&handles[3]));
+    REQUIRE(host.async_result(handles[3])->number == 2.0);
+    REQUIRE(xll::async_stats().inlined == before.inlined + 1);
+
+    // Excel abandons the pending handles, and calls the command registered for the event:
+    const auto procedures = host.cancel_calculation();
+    REQUIRE(procedures == std::vector<std::string> { "xllAsyncCalculationCanceled" });
+    REQUIRE(xllAsyncCalculationCanceled() == XLL_SUCCESS);
+
+    // The running call sees the cancellation and stops, and the queued ones never start:
+    REQUIRE(wait_for([&] { return xll::async_stats().canceled == before.canceled + 3; }));
+    REQUIRE(xll::async_stats().completed == before.completed + 1);
+    REQUIRE(host.async_returned() == 1);
+    REQUIRE(not host.async_result(handles[0]).has_value());
+    REQUIRE(not host.async_result(handles[1]).has_value());
+
+    // Later calls are not affected:
+    auto handle = host.async_handle();
+    AsyncTwice(&num, static_cast<const xll::AsyncHandle*>(&handle));
+    REQUIRE(host.wait_async(2, 5s));
+    REQUIRE(host.async_result(handle)->number == 2.0);
+
+    xll::configure_async(xll::ThreadPool::default_threads());
+    REQUIRE(host.close() == XLL_SUCCESS);
+    host.uninstall();
+}
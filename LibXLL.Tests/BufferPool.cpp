@@ -0,0 +1,127 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Types.hpp"
+#include "../Utils/BufferPool.hpp"
+#include "../Utils/Pipe.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <thread>
+
+TEST_CASE( "BufferPool Reuse", "[xll::BufferPool]" )
+{
+    auto& pool = xll::BufferPool::instance();
+    pool.configure(8, 16 << 20);
+    const auto before = pool.stats();
+
+    // A released buffer is reused by the next Array of the same size:
+    const XLOPER12* cells = nullptr;
+    {
+        auto first = xll::Array<xll::Number>(10, 10, xll::Number(1.0));
+        cells      = first.val.array.lparray;
+    }
+    REQUIRE(pool.stats().returned == before.returned + 1);
+    REQUIRE(pool.stats().bytes == 100 * sizeof(XLOPER12));
+
+    auto second = xll::Array<xll::Number>(20, 5, xll::Number(2.0));
+    REQUIRE(second.val.array.lparray == cells);
+    REQUIRE(pool.stats().hits == before.hits + 1);
+    REQUIRE(std::ranges::all_of(second, [](const xll::Number& n) { return n == 2.0; }));
+
+    // ... but not by one of another size:
+    auto third = xll::Array<xll::Number>(10, 11);
+    REQUIRE(pool.stats().misses == before.misses + 2);
+
+    // Recycled buffers are initialised for element types owning memory:
+    second = xll::Array<xll::Number>();
+    auto strings = xll::Array<xll::String>(10, 10);
+    REQUIRE(strings.val.array.lparray == cells);
+    REQUIRE(std::ranges::all_of(strings, [](const xll::String& s) { return s.empty(); }));
+    strings[3] = xll::String("recycled");
+    REQUIRE(strings[3] == "recycled");
+    pool.configure(0, 0);
+}
+
+TEST_CASE( "BufferPool Threads and Bounds", "[xll::BufferPool]" )
+{
+    auto& pool = xll::BufferPool::instance();
+    pool.configure(8, 16 << 20);
+
+    // Each thread has its own cache, which is released when the thread exits:
+    auto before = pool.stats();
+    std::thread([] { auto array = xll::Array<xll::Number>(7, 7); }).join();
+    REQUIRE(pool.stats().returned == before.returned + 1);
+    REQUIRE(pool.stats().released == before.released + 1);
+    REQUIRE(pool.stats().bytes == 0);
+
+    auto array = xll::Array<xll::Number>(7, 7);
+    REQUIRE(pool.stats().misses == before.misses + 2);
+
+    // Arrays released after the cache of their thread has been destroyed are deallocated directly:
+    before = pool.stats();
+    std::thread([] {
+        thread_local std::optional<xll::Array<xll::Number>> late;
+        late.emplace(3, 3);
+    }).join();
+    REQUIRE(pool.stats().returned == before.returned);
+    REQUIRE(pool.stats().released == before.released + 1);
+
+    // A full cache evicts its oldest buffer, and buffers larger than the cache are not kept:
+    pool.configure(2, 1000 * sizeof(XLOPER12));
+    before = pool.stats();
+    for (size_t size : { 1, 2, 3 }) auto evicted = xll::Array<xll::Number>(size, 1);
+    REQUIRE(pool.stats().released == before.released + 1);
+    REQUIRE(pool.stats().bytes == 5 * sizeof(XLOPER12));
+    { auto large = xll::Array<xll::Number>(1001, 1); }
+    REQUIRE(pool.stats().released == before.released + 2);
+    REQUIRE(pool.stats().peak == 5 * sizeof(XLOPER12));
+
+    // Zero disables the pool:
+    pool.configure(0, 0);
+    before = pool.stats();
+    { auto disabled = xll::Array<xll::Number>(3, 1); }
+    REQUIRE(pool.stats().returned == before.returned);
+    REQUIRE(pool.stats().bytes == 0);
+
+    REQUIRE(not pool.enabled());
+
+    // Buffers allocated by the user with new[] may be released through an Array:
+    auto* cells = new XLOPER12[4] {};
+    for (size_t i = 0; i < 4; ++i) cells[i].xltype = xltypeNum;
+    auto user = xll::Array<xll::Number>();
+    user.val.array.lparray = cells;
+    user.val.array.rows    = 2;
+    user.val.array.columns = 2;
+}
+
+TEST_CASE( "BufferPool Results", "[xll::BufferPool]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+    REQUIRE(host.open() == XLL_SUCCESS);
+
+    auto& pool = xll::BufferPool::instance();
+    pool.configure(8, 16 << 20);
+    const auto before = pool.stats();
+
+    // Results released by xlAutoFree12 supply the buffer of the next calculation:
+    for (int i = 0; i < 10; ++i) {
+        auto* result = xll::AutoFree()(xll::Array<xll::Number>(100, 10, xll::Number(static_cast<double>(i))));
+        host.release(result);
+    }
+    REQUIRE(pool.stats().misses == before.misses + 1);
+    REQUIRE(pool.stats().hits == before.hits + 9);
+
+    // The caches are emptied when the add-in is closed:
+    REQUIRE(pool.stats().bytes > 0);
+    REQUIRE(host.close() == XLL_SUCCESS);
+    REQUIRE(pool.stats().bytes == 0);
+    pool.configure(0, 0);
+    host.uninstall();
+}
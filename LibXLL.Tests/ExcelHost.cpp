@@ -0,0 +1,148 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Commands.hpp"
+#include "../Functions.hpp"
+#include "../Register.hpp"
+
+#include <algorithm>
+#include <format>
+#include <string>
+#include <vector>
+
+TEST_CASE( "ExcelHost Callbacks", "[xll::mock::ExcelHost]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+    const auto allocations = host.live_allocations();
+
+    // Coercion between scalar types:
+    auto num = xll::Number(2.6);
+    REQUIRE(xll::coerce<xll::Int>(&num) == 3);
+    REQUIRE(xll::coerce<xll::Bool>(&num) == true);
+    REQUIRE(xll::coerce<xll::String>(&num) == "2.6");
+
+    auto str = xll::String("42.5");
+    REQUIRE(xll::coerce<xll::Number>(&str) == 42.5);
+
+    auto txt = xll::String("not a number");
+    REQUIRE_THROWS(xll::coerce<xll::Number>(&txt));
+    REQUIRE(host.calls(xlCoerce) == 5);
+
+    // Module name:
+    host.set_name("host.xll");
+    REQUIRE(xll::get_name() == "host.xll");
+    REQUIRE(xll::get_module_prefix() == "HOST");
+    host.set_name(R"(C:\AddIns\My-AddIn.v2.xll)");
+    REQUIRE(xll::get_module_prefix() == "MY_ADDIN_V2");
+    host.set_name("/opt/addins/3d");
+    REQUIRE(xll::get_module_prefix() == "_3D");
+
+    // Workspace information:
+    auto locale = xll::workspace<xll::Workspace::LocaleData>();
+    REQUIRE(locale.size() == 45);
+    REQUIRE(xll::get<xll::String>(locale[0]) == ".");
+
+    // Alerts:
+    xll::alert("Hello", xll::Alert::Information);
+    REQUIRE(host.alerts().size() == 1);
+    REQUIRE(host.alerts().front().message == "Hello");
+    REQUIRE(host.alerts().front().type == xll::Alert::Information);
+
+    // Every buffer handed out by the host has been given back through xlFree:
+    REQUIRE(host.live_allocations() == allocations);
+    REQUIRE(host.stray_frees() == 0);
+
+    host.uninstall();
+    REQUIRE(Excel12(xlGetName, nullptr, 0) == xlretFailed);
+}
+
+TEST_CASE( "ExcelHost Add-In Lifecycle", "[xll::mock::ExcelHost]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    xll::Function("HOST.TEST")
+        | xll::Result<xll::Number>()
+        | xll::Procedure("HostTest")
+        | xll::Parameter<xll::Number>("x", "The argument")
+        | xll::ThreadSafe()
+        | xll::Register();
+
+    REQUIRE(host.open() == XLL_SUCCESS);
+
+    auto registrations = host.registrations();
+    auto reg = std::ranges::find(registrations, std::string("HostTest"), &xll::mock::ExcelHost::Registration::procedure);
+    REQUIRE(reg != registrations.end());
+    REQUIRE(reg->moduleText == "mock.xll");
+    REQUIRE(reg->typeText == "QQ$");
+    REQUIRE(reg->functionText == "HOST.TEST");
+    REQUIRE(reg->argumentText == "x");
+    REQUIRE(reg->argumentHelp.size() == 1);
+
+    // Results flagged with xlbitDLLFree are handed back to the add-in:
+    auto result = xll::AutoFree()(xll::Number(42.0));
+    REQUIRE(result->xltype == (xltypeNum | xlbitDLLFree));
+    host.release(result);
+
+    REQUIRE(host.close() == XLL_SUCCESS);
+    host.uninstall();
+}
+
+TEST_CASE( "ExcelHost Registration Payload", "[xll::mock::ExcelHost]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    for (int i = 0; i < 100; ++i)
+        xll::Function(xll::String(std::format("HOST.PAYLOAD.{}", i)))
+            | xll::Result<xll::Number>()
+            | xll::Procedure(xll::String(std::format("HostPayload{}", i)))
+            | xll::Parameter<xll::Number>("x", "The argument")
+            | xll::Parameter<double>("y", "The other argument")
+            | xll::ThreadSafe()
+            | xll::Register();
+
+    const auto count = xll::Function::functionArgs.size();
+    REQUIRE(host.open() == XLL_SUCCESS);
+
+    // The module name is fetched once, and every function is registered:
+    REQUIRE(host.calls(xlGetName) == 1);
+    REQUIRE(host.calls(xlfRegister) == count);
+
+    const auto& report = xll::startup_report();
+    REQUIRE(report.functions == count);
+    REQUIRE(report.total >= report.registration);
+    REQUIRE(report.to_string().starts_with(std::format("Registered {} functions", count)));
+
+    auto registrations = host.registrations();
+    auto reg = std::ranges::find(registrations, std::string("HostPayload42"), &xll::mock::ExcelHost::Registration::procedure);
+    REQUIRE(reg != registrations.end());
+    REQUIRE(reg->moduleText == "mock.xll");
+    REQUIRE(reg->typeText == "QQB$");
+    REQUIRE(reg->functionText == "HOST.PAYLOAD.42");
+    REQUIRE(reg->argumentText == "x,y");
+    REQUIRE(reg->argumentHelp == std::vector<std::string> { "The argument", "The other argument  " });
+
+    // The payload is rebuilt by the next xlAutoOpen, also where the functions were changed in place, which frees
+    // the strings that the previous payload referred to:
+    for (auto& fn : xll::Function::functionArgs) fn.functionName = xll::String(fn.functionName.to_string() + ".NEW");
+    REQUIRE(host.open() == XLL_SUCCESS);
+    REQUIRE(host.calls(xlGetName) == 2);
+    REQUIRE(host.calls(xlfRegister) == 2 * count);
+
+    registrations = host.registrations();
+    reg = std::ranges::find(registrations, std::string("HOST.PAYLOAD.42.NEW"), &xll::mock::ExcelHost::Registration::functionText);
+    REQUIRE(reg != registrations.end());
+    REQUIRE(reg->procedure == "HostPayload42");
+
+    REQUIRE(host.close() == XLL_SUCCESS);
+    host.uninstall();
+}
@@ -0,0 +1,168 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Types.hpp"
+#include "../Utils/Hash.hpp"
+
+#include <numeric>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using cell_t = xll::Variant<xll::Nil, xll::Bool, xll::Int, xll::String, xll::Number>;
+
+    xll::Array<cell_t> mixed(size_t rows, size_t cols)
+    {
+        auto cells = xll::Array<cell_t>(rows, cols);
+        for (size_t i = 0; auto& cell : cells) {
+            if (i % 37 == 5)
+                cell = xll::String("cell " + std::to_string(i));
+            else if (i % 53 == 7)
+                cell = xll::Int(static_cast<int>(i));
+            else if (i % 61 == 11)
+                cell = xll::Nil();
+            else
+                cell = xll::Number(0.5 * static_cast<double>(i));
+            ++i;
+        }
+        return cells;
+    }
+}    // namespace
+
+TEST_CASE( "Structural Hash", "[xll::Hasher]" )
+{
+    // Equal values have equal hashes, whichever type holds them:
+    auto cells = mixed(40, 25);
+    auto copy  = cells;
+    REQUIRE(xll::equal(cells, copy));
+    REQUIRE(xll::hash(cells) == xll::hash(copy));
+    REQUIRE(xll::hash128(cells) == xll::hash128(copy));
+    REQUIRE(xll::hash128(cells).low == xll::hash(cells));
+    REQUIRE(xll::hash(cell_t(xll::Number(2.5))) == xll::hash(xll::Number(2.5)));
+    REQUIRE(xll::hash(cell_t(xll::String("abc"))) == xll::hash(xll::String("abc")));
+
+    // ... regardless of the memory flags:
+    auto flagged = XLOPER12(copy);
+    flagged.xltype |= xlbitDLLFree;
+    REQUIRE(xll::equal(cells, flagged));
+    REQUIRE(xll::hash(flagged) == xll::hash(cells));
+
+    // A change of any cell, or of the shape, changes the hash:
+    copy[999] = xll::Number(1.0);
+    REQUIRE_FALSE(xll::equal(cells, copy));
+    REQUIRE(xll::hash(cells) != xll::hash(copy));
+    copy      = cells;
+    copy[5]   = xll::String("cell 6");
+    REQUIRE_FALSE(xll::equal(cells, copy));
+    REQUIRE(xll::hash(cells) != xll::hash(copy));
+    REQUIRE(xll::hash(xll::Array<xll::Number>(2, 3, xll::Number(1.0))) != xll::hash(xll::Array<xll::Number>(3, 2, xll::Number(1.0))));
+
+    // Numbers are compared by their bits, and types are distinguished:
+    REQUIRE_FALSE(xll::equal(xll::Number(0.0), xll::Number(-0.0)));
+    REQUIRE(xll::hash(xll::Number(0.0)) != xll::hash(xll::Number(-0.0)));
+    REQUIRE(xll::hash(xll::Number(1.0)) != xll::hash(xll::Int(1)));
+    REQUIRE(xll::hash(xll::String("")) == xll::hash(xll::String("")));
+    REQUIRE(xll::hash(xll::String("")) != xll::hash(xll::Nil()));
+
+    // The seed selects a different hash function:
+    copy = cells;
+    REQUIRE(xll::hash(cells, 1) != xll::hash(cells));
+    REQUIRE(xll::hash(cells, 1) == xll::hash(copy, 1));
+
+    // Blocks of doubles:
+    auto numbers = xll::NumericArray::make(300, 7);
+    std::iota(numbers->begin(), numbers->end(), 0.0);
+    auto other = xll::NumericArray::make(300, 7);
+    std::iota(other->begin(), other->end(), 0.0);
+    REQUIRE(xll::equal(*numbers, *other));
+    REQUIRE(xll::hash128(*numbers) == xll::hash128(*other));
+    (*other)[2099] = -1.0;
+    REQUIRE_FALSE(xll::equal(*numbers, *other));
+    REQUIRE(xll::hash(*numbers) != xll::hash(*other));
+}
+
+TEST_CASE( "Structural Hash Stability", "[xll::Hasher]" )
+{
+    // The hash is part of the interface: it must not change between versions, platforms or instruction sets.
+    REQUIRE(xll::hash(xll::Number(1.0)) == 0x843D6AFAA2359025ull);
+    REQUIRE(xll::hash(xll::String("MSFT US Equity"), 42) == 0xC6B04C5D5806E76Bull);
+    REQUIRE(xll::hash(mixed(100, 10)) == 0x95E20F2FCE0672A9ull);
+    REQUIRE(xll::hash128(mixed(100, 10)).high == 0xDD9391EB02A4A0C2ull);
+
+    // Strings are written as the UTF-16 units that Excel stores, with surrogate pairs above U+FFFF, also where
+    // XCHAR holds code points:
+    const auto units = std::u16string_view(u"Smile \U0001F60A!");
+    auto       utf16 = xll::Hasher();
+    utf16.word(xltypeStr);
+    utf16.bytes(units.data(), units.size() * sizeof(char16_t));
+    utf16.word(0);    // Padding to an even number of words.
+    auto smile = xll::Hasher();
+    smile.value(xll::String("Smile \U0001F60A!"));
+    REQUIRE(smile.digest128() == utf16.digest128());
+
+    // Streams of zeros differ by their length, below and above the size of a stripe:
+    auto hashes = std::vector<xll::Hash128>();
+    for (size_t n = 0; n < 40; ++n) {
+        auto hasher = xll::Hasher();
+        for (size_t i = 0; i < n; ++i) hasher.word(0);
+        hashes.push_back(hasher.digest128());
+    }
+    for (size_t i = 0; i < hashes.size(); ++i)
+        for (size_t j = i + 1; j < hashes.size(); ++j) REQUIRE(hashes[i] != hashes[j]);
+
+    // The vectorised accumulation matches the reference implementation, across the scrambling of the lanes:
+    auto random = std::mt19937_64(20250324);
+    auto words  = std::vector<uint64_t>(8 * 40);
+    for (auto& w : words) w = random();
+
+    auto vector    = xll::impl::hash::State(7);
+    auto reference = xll::impl::hash::State(7);
+    xll::impl::hash::accumulate(vector, reinterpret_cast<const std::byte*>(words.data()), 40);
+    xll::impl::hash::accumulate_scalar(reference, reinterpret_cast<const std::byte*>(words.data()), 40);
+    REQUIRE(vector.acc == reference.acc);
+    REQUIRE(vector.key == reference.key);
+    REQUIRE(vector.stripes == reference.stripes);
+
+    // Blocks of memory hash the same as the words they consist of, however they are split:
+    auto whole = xll::Hasher(3);
+    whole.bytes(words.data(), 300 * sizeof(uint64_t) + 5);
+    auto pieces = xll::Hasher(3);
+    pieces.word(300 * sizeof(uint64_t) + 5);
+    for (size_t i = 0; i < 300; ++i) pieces.word(words[i]);
+    pieces.word(words[300] & 0xFFFFFFFFFFull);
+    REQUIRE(whole.digest128() == pieces.digest128());
+
+    // ... and the cells of an array are written one after the other:
+    const auto cells = mixed(30, 30);
+    auto       array = xll::Hasher();
+    array.value(cells);
+    auto each = xll::Hasher();
+    each.word(xltypeMulti);
+    each.word(30);
+    each.word(30);
+    each.word(0);
+    for (const auto& cell : cells) each.value(cell);
+    REQUIRE(array.digest() == each.digest());
+}
+
+TEST_CASE( "Structural Hash Containers", "[xll::Hasher]" )
+{
+    // A container keyed by Variants can be searched with Excel's XLOPER12s:
+    auto counts = std::unordered_map<cell_t, int, xll::StructuralHash, xll::StructuralEqual>();
+    counts.emplace(xll::String("apple"), 1);
+    counts.emplace(xll::Number(2.0), 2);
+    counts.emplace(xll::Bool(true), 3);
+
+    auto text = xll::String("apple");
+    REQUIRE(counts.find(static_cast<const XLOPER12&>(text))->second == 1);
+    REQUIRE(counts.find(static_cast<const XLOPER12&>(xll::Number(2.0)))->second == 2);
+    REQUIRE(counts.find(static_cast<const XLOPER12&>(xll::Bool(true)))->second == 3);
+    REQUIRE(counts.find(static_cast<const XLOPER12&>(xll::Number(3.0))) == counts.end());
+    REQUIRE(counts.find(static_cast<const XLOPER12&>(xll::String("Apple"))) == counts.end());
+}
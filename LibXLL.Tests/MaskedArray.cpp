@@ -0,0 +1,175 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Types/MaskedArray.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    xll::Array<xll::Expected<xll::Number>> make_source(size_t rows, size_t cols)
+    {
+        auto source = xll::Array<xll::Expected<xll::Number>>(rows, cols);
+        for (size_t i = 0; i < source.size(); ++i) {
+            if (i % 7 == 3)
+                source[i] = xll::Unexpected(i % 2 == 0 ? xll::ErrNA : xll::ErrDiv0);
+            else
+                source[i] = xll::Number(static_cast<double>(i));
+        }
+        return source;
+    }
+
+    bool same(const xll::Expected<xll::Number>& lhs, const xll::Expected<xll::Number>& rhs)
+    {
+        if (lhs.has_value() != rhs.has_value()) return false;
+        return lhs.has_value() ? lhs.value() == rhs.value() : lhs.error() == rhs.error();
+    }
+}    // namespace
+
+TEST_CASE( "MaskedArray Conversion", "[xll::MaskedArray]" )
+{
+    const auto source = make_source(13, 11);    // 143 cells, so the last bitmap word is partial
+    const auto masked = xll::MaskedArray(source);
+
+    REQUIRE(masked.rows() == 13);
+    REQUIRE(masked.cols() == 11);
+    REQUIRE(masked.mask().size() == 3);
+    REQUIRE(masked.errors().size() == 20);
+    REQUIRE(masked.count() == 123);
+    REQUIRE((masked.mask()[2] >> 15) == 0);    // bits beyond the last cell are clear
+
+    for (size_t i = 0; i < masked.size(); ++i) {
+        REQUIRE(masked.has_value(i) == source[i].has_value());
+        if (source[i].has_value())
+            REQUIRE(masked.values()[i] == static_cast<double>(i));
+        else
+            REQUIRE(masked.error(i) == source[i].error());
+    }
+
+    REQUIRE(same(masked[3], source[3]));
+    REQUIRE(same(masked[1, 2], source[1, 2]));
+    REQUIRE_THROWS_AS(masked[143], std::out_of_range);
+    REQUIRE_THROWS_AS((masked[13, 0]), std::out_of_range);
+    REQUIRE_THROWS(masked.error(0));
+
+    // Round trip back to the Excel layout:
+    const auto result = masked.to_array();
+    REQUIRE(result.rows() == 13);
+    REQUIRE(result.cols() == 11);
+    for (size_t i = 0; i < result.size(); ++i) REQUIRE(same(result[i], source[i]));
+
+    // Anything but numbers and errors is #VALUE!, as for Expected<Number> arguments:
+    auto mixed = xll::Array<xll::Variant<xll::Nil, xll::Number, xll::String>>(1, 3);
+    mixed[0]   = xll::Number(1.0);
+    mixed[1]   = xll::String("abc");
+    auto other = xll::MaskedArray(static_cast<const XLOPER12&>(mixed));
+    REQUIRE(other.count() == 1);
+    REQUIRE(other.error(1) == xll::ErrValue);
+    REQUIRE(other.error(2) == xll::ErrValue);
+
+    // A single cell is a 1x1 array:
+    auto cell = xll::MaskedArray(static_cast<const XLOPER12&>(xll::Number(2.5)));
+    REQUIRE(cell.size() == 1);
+    REQUIRE(cell.values()[0] == 2.5);
+
+    REQUIRE(xll::MaskedArray(xll::Array<xll::Expected<xll::Number>>()).empty());
+    REQUIRE(xll::MaskedArray().to_array().empty());
+}
+
+TEST_CASE( "MaskedArray Modification", "[xll::MaskedArray]" )
+{
+    auto masked = xll::MaskedArray(2, 40);
+    REQUIRE(masked.count() == 80);
+    REQUIRE(masked.errors().empty());
+
+    masked.set(70, xll::ErrNum);
+    masked.set(5, xll::ErrNA);
+    masked.set(30, xll::ErrRef);
+    REQUIRE(masked.count() == 77);
+    REQUIRE(masked.errors().size() == 3);
+    REQUIRE(masked.errors()[0] == xll::MaskedArray::ErrorEntry { 5, xll::ErrNA.error_id() });
+    REQUIRE(masked.errors()[1] == xll::MaskedArray::ErrorEntry { 30, xll::ErrRef.error_id() });
+    REQUIRE(masked.errors()[2] == xll::MaskedArray::ErrorEntry { 70, xll::ErrNum.error_id() });
+
+    masked.set(30, xll::ErrValue);
+    REQUIRE(masked.error(30) == xll::ErrValue);
+    REQUIRE(masked.errors().size() == 3);
+
+    masked.set(30, 1.5);
+    REQUIRE(masked.has_value(30));
+    REQUIRE(same(masked[30], xll::Number(1.5)));
+    REQUIRE(masked.errors().size() == 2);
+    REQUIRE(masked.count() == 78);
+}
+
+TEST_CASE( "MaskedArray Kernels", "[xll::MaskedArray]" )
+{
+    const auto source = make_source(10, 30);
+    const auto masked = xll::MaskedArray(source);
+
+    // The reference results, computed on the Excel layout:
+    auto   expected_sum   = 0.0;
+    size_t expected_count = 0;
+    for (const auto& elem : source)
+        if (elem.has_value()) {
+            expected_sum += elem.value().val.num;
+            ++expected_count;
+        }
+
+    SECTION("Reductions skip cells holding an error")
+    {
+        REQUIRE(masked.sum() == expected_sum);
+        REQUIRE(masked.reduce(0.0, [](double acc, double v) { return acc + v; }) == expected_sum);
+        REQUIRE(masked.reduce(size_t { 0 }, [](size_t acc, double) { return acc + 1; }) == expected_count);
+        REQUIRE(masked.reduce(-1.0, [](double acc, double v) { return std::max(acc, v); }) == 299.0);
+
+        // The values of cells holding an error never contribute, even if they are NaN:
+        auto copy                 = masked;
+        copy.values()[3]          = std::nan("");
+        copy.values()[3 + 7 * 40] = std::numeric_limits<double>::infinity();
+        REQUIRE(copy.sum() == expected_sum);
+        REQUIRE(copy.reduce(0.0, [](double acc, double v) { return acc + v; }) == expected_sum);
+
+        REQUIRE(xll::MaskedArray().sum() == 0.0);
+        REQUIRE(xll::MaskedArray(1, 64).transform([](double) { return 1.0; }).sum() == 64.0);
+    }
+
+    SECTION("Transform keeps errors")
+    {
+        const auto result = masked.transform([](double v) { return v + 2.0; }).to_array();
+        for (size_t i = 0; i < source.size(); ++i) {
+            if (source[i].has_value())
+                REQUIRE(same(result[i], xll::Number(source[i].value().val.num + 2.0)));
+            else
+                REQUIRE(same(result[i], source[i]));
+        }
+
+        auto copy = masked;
+        copy.apply([](double v) { return std::sqrt(v); });
+        REQUIRE(copy.values()[4] == 2.0);
+        REQUIRE(copy.errors().size() == masked.errors().size());
+    }
+
+    SECTION("Binary transform combines masks and errors")
+    {
+        auto other = xll::MaskedArray(10, 30);
+        other.set(0, xll::ErrNum);     // only invalid in other
+        other.set(3, xll::ErrNull);    // invalid in both; the error of the left operand wins
+        other.set(299, xll::ErrRef);
+
+        const auto result = masked.transform(other, [](double a, double b) { return a * 2.0 + b; });
+        REQUIRE(result.count() == expected_count - 2);
+        REQUIRE(result.error(0) == xll::ErrNum);
+        REQUIRE(result.error(3) == masked.error(3));
+        REQUIRE(result.error(10) == masked.error(10));
+        REQUIRE(result.error(299) == xll::ErrRef);
+        REQUIRE(result.values()[1] == 2.0);
+        REQUIRE(std::ranges::is_sorted(result.errors(), {}, &xll::MaskedArray::ErrorEntry::index));
+
+        REQUIRE_THROWS(masked.transform(xll::MaskedArray(30, 10), [](double a, double b) { return a + b; }));
+    }
+}
@@ -0,0 +1,194 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Register.hpp"
+#include "../Types.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using cell_t = xll::Variant<xll::Nil, xll::String, xll::Number>;
+
+    std::atomic<size_t> calls = 0;
+
+    double slow_add(double lhs, double rhs)
+    {
+        ++calls;
+        return lhs + rhs;
+    }
+
+    double weigh(const xll::Array<cell_t>& cells)
+    {
+        ++calls;
+        auto weight = 0.0;
+        for (const auto& cell : cells) {
+            if (cell.xltype == xltypeNum) weight += cell.val.num;
+            if (cell.xltype == xltypeStr) weight += cell.val.str[0];
+        }
+        return weight;
+    }
+
+    xll::Array<xll::Number> fill(double value, int32_t count)
+    {
+        ++calls;
+        if (count < 0) throw std::invalid_argument("negative count");
+        return xll::Array<xll::Number>(static_cast<size_t>(count), 1, xll::Number(value));
+    }
+
+    std::string_view label(bool upper)
+    {
+        ++calls;
+        return upper ? "UPPER" : "lower";
+    }
+}    // namespace
+
+XLL_UDF(MemoAdd, slow_add, lhs, rhs)
+XLL_UDF(MemoWeigh, weigh, cells)
+XLL_UDF(MemoFill, fill, value, count)
+XLL_UDF(MemoLabel, label, upper)
+
+TEST_CASE( "Memoize Calls", "[xll::MemoCache]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    xll::Function("MEMO.ADD") | xll::Procedure("MemoAdd") | xll::Signature<MemoAdd, "$">() | xll::Argument("lhs", "") | xll::Argument("rhs", "") | xll::Memoize(16, 1 << 20) | xll::Register();
+    xll::Function("MEMO.WEIGH") | xll::Procedure("MemoWeigh") | xll::Memoize(16, 1 << 20) | xll::Signature<MemoWeigh, "$">() | xll::Argument("cells", "") | xll::Register();
+    xll::Function("MEMO.FILL") | xll::Procedure("MemoFill") | xll::Signature<MemoFill, "$">() | xll::Argument("value", "") | xll::Argument("count", "") | xll::Memoize(16, 1 << 20) | xll::Register();
+    xll::Function("MEMO.LABEL") | xll::Procedure("MemoLabel") | xll::Signature<MemoLabel, "$">() | xll::Argument("upper", "") | xll::Memoize(16, 1 << 20) | xll::Register();
+
+    // A call with the same arguments is answered from the cache:
+    calls = 0;
+    REQUIRE(MemoAdd(1.0, 2.0)->val.num == 3.0);
+    REQUIRE(MemoAdd(1.0, 2.0)->val.num == 3.0);
+    REQUIRE(calls == 1);
+    REQUIRE(MemoAdd(2.0, 1.0)->val.num == 3.0);
+    REQUIRE(calls == 2);
+
+    const auto stats = xll::MemoCache::of(MemoAdd).stats();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 2);
+    REQUIRE(stats.entries == 2);
+    REQUIRE(stats.bytes > 0);
+
+    // Arrays are compared by the content of their cells, including the characters of strings:
+    auto cells = xll::Array<cell_t>(2, 2);
+    cells[0]   = xll::Number(1.5);
+    cells[1]   = xll::String("abc");
+    auto copy  = cells;
+    calls      = 0;
+    REQUIRE(MemoWeigh(&cells)->val.num == 4.5);
+    REQUIRE(MemoWeigh(&copy)->val.num == 4.5);
+    REQUIRE(calls == 1);
+    copy[1] = xll::String("abd");
+    REQUIRE(MemoWeigh(&copy)->val.num == 4.5);
+    REQUIRE(calls == 2);
+    copy[3] = xll::Number(0.0);
+    REQUIRE(MemoWeigh(&copy)->val.num == 4.5);
+    REQUIRE(calls == 3);
+
+    // Owning results are copied from the cache, and failed calls are not cached:
+    calls         = 0;
+    auto* first   = MemoFill(2.0, 3);
+    REQUIRE(first->val.array.rows == 3);
+    auto* second  = MemoFill(2.0, 3);
+    REQUIRE(second->val.array.rows == 3);
+    REQUIRE(second->val.array.lparray[2].val.num == 2.0);
+    REQUIRE(calls == 1);
+    REQUIRE(MemoFill(2.0, -1)->val.err == xlerrValue);
+    REQUIRE(MemoFill(2.0, -1)->val.err == xlerrValue);
+    REQUIRE(calls == 3);
+
+    calls = 0;
+    REQUIRE(xll::String(*MemoLabel(1)) == "UPPER");
+    REQUIRE(xll::String(*MemoLabel(1)) == "UPPER");
+    REQUIRE(xll::String(*MemoLabel(0)) == "lower");
+    REQUIRE(calls == 2);
+
+    // The caches are emptied when the add-in is closed:
+    REQUIRE(host.open() == XLL_SUCCESS);
+    REQUIRE(host.close() == XLL_SUCCESS);
+    REQUIRE(xll::MemoCache::of(MemoAdd).stats().entries == 0);
+    REQUIRE(xll::MemoCache::of(MemoAdd).enabled());
+    host.uninstall();
+}
+
+TEST_CASE( "Memoize Bounds", "[xll::MemoCache]" )
+{
+    // The least recently used result is evicted when the cache is full:
+    xll::Function("MEMO.ADD") | xll::Procedure("MemoAdd") | xll::Signature<MemoAdd, "$">() | xll::Argument("lhs", "") | xll::Argument("rhs", "") | xll::Memoize(2, 1 << 20) | xll::Register();
+    calls = 0;
+    MemoAdd(1.0, 1.0);
+    MemoAdd(2.0, 2.0);
+    MemoAdd(1.0, 1.0);
+    MemoAdd(3.0, 3.0);
+    REQUIRE(calls == 3);
+    REQUIRE(xll::MemoCache::of(MemoAdd).stats().evictions == 1);
+    MemoAdd(1.0, 1.0);
+    REQUIRE(calls == 3);
+    MemoAdd(2.0, 2.0);
+    REQUIRE(calls == 4);
+
+    // ... and results larger than the memory cap are not kept:
+    xll::Function("MEMO.FILL") | xll::Procedure("MemoFill") | xll::Signature<MemoFill, "$">() | xll::Argument("value", "") | xll::Argument("count", "") | xll::Memoize(8, 4096) | xll::Register();
+    calls = 0;
+    REQUIRE(MemoFill(1.0, 1000)->val.array.rows == 1000);
+    REQUIRE(MemoFill(1.0, 1000)->val.array.rows == 1000);
+    REQUIRE(calls == 2);
+    REQUIRE(xll::MemoCache::of(MemoFill).stats().entries == 0);
+    REQUIRE(MemoFill(1.0, 10)->val.array.rows == 10);
+    REQUIRE(xll::MemoCache::of(MemoFill).stats().entries == 1);
+
+    // Zero disables the cache, and the procedure must be known:
+    xll::Function("MEMO.ADD") | xll::Procedure("MemoAdd") | xll::Signature<MemoAdd, "$">() | xll::Argument("lhs", "") | xll::Argument("rhs", "") | xll::Memoize(0, 0) | xll::Register();
+    REQUIRE(not xll::MemoCache::of(MemoAdd).enabled());
+    calls = 0;
+    MemoAdd(1.0, 1.0);
+    MemoAdd(1.0, 1.0);
+    REQUIRE(calls == 2);
+
+    REQUIRE_THROWS_AS(xll::Function("MEMO.ADD") | xll::Procedure("MemoAdd") | xll::Memoize(2, 1 << 20) | xll::Register(), std::runtime_error);
+}
+
+TEST_CASE( "Memoize Threads", "[xll::MemoCache]" )
+{
+    xll::Function("MEMO.ADD") | xll::Procedure("MemoAdd") | xll::Signature<MemoAdd, "$">() | xll::Argument("lhs", "") | xll::Argument("rhs", "") | xll::Memoize(1024, 1 << 20) | xll::Register();
+
+    // Excel's calculation threads share the cache of a thread-safe function:
+    constexpr size_t Threads = 8;
+    constexpr size_t Calls   = 2000;
+    constexpr size_t Keys    = 50;
+    auto             wrong   = std::atomic<size_t>(0);
+    calls                    = 0;
+    {
+        auto threads = std::vector<std::jthread>();
+        for (size_t t = 0; t < Threads; ++t) {
+            threads.emplace_back([&, t] {
+                for (size_t i = 0; i < Calls; ++i) {
+                    const auto key = static_cast<double>((t + i) % Keys);
+                    if (MemoAdd(key, 1.0)->val.num != key + 1.0) ++wrong;
+                }
+            });
+        }
+    }
+
+    const auto stats = xll::MemoCache::of(MemoAdd).stats();
+    REQUIRE(wrong == 0);
+    REQUIRE(stats.entries == Keys);
+    REQUIRE(stats.hits + stats.misses == Threads * Calls);
+    REQUIRE(calls == stats.misses);
+    REQUIRE(calls >= Keys);
+    REQUIRE(calls < Threads * Keys);
+
+    xll::Function("MEMO.ADD") | xll::Procedure("MemoAdd") | xll::Signature<MemoAdd, "$">() | xll::Argument("lhs", "") | xll::Argument("rhs", "") | xll::Memoize(0, 0) | xll::Register();
+}
@@ -0,0 +1,148 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Utils/MemoryManager.hpp"
+#include "../Utils/Pipe.hpp"
+
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    size_t destroyed = 0;
+
+    struct Tracked : XLOPER12
+    {
+        Tracked() : XLOPER12() { xltype = xltypeNum; }
+        ~Tracked() { ++destroyed; }
+    };
+}    // namespace
+
+TEST_CASE( "MemoryManager Ownership", "[xll::MemoryManager]" )
+{
+    auto&      manager = xll::MemoryManager::Instance();
+    const auto before  = manager.size();
+
+    auto value    = XLOPER12 {};
+    value.xltype  = xltypeNum;
+    value.val.num = 42.0;
+
+    auto* ptr = manager.add(value);
+    REQUIRE(ptr != &value);
+    REQUIRE(ptr->xltype == xltypeNum);
+    REQUIRE(ptr->val.num == 42.0);
+    REQUIRE(manager.contains(ptr));
+    REQUIRE(manager.size() == before + 1);
+
+    // Pointers that are not owned are left alone:
+    REQUIRE(not manager.contains(&value));
+    REQUIRE(not manager.erase(&value));
+
+    REQUIRE(manager.erase(ptr));
+    REQUIRE(manager.size() == before);
+}
+
+TEST_CASE( "MemoryManager Threads", "[xll::MemoryManager]" )
+{
+    auto&      manager = xll::MemoryManager::Instance();
+    const auto before  = manager.size();
+
+    // Each thread adds values, and releases them again, as Excel does during a multithreaded recalculation:
+    constexpr size_t Threads = 8;
+    constexpr size_t Values  = 2000;
+    auto             owned   = std::vector<std::vector<LPXLOPER12>>(Threads);
+    {
+        auto threads = std::vector<std::jthread>();
+        for (size_t t = 0; t < Threads; ++t) {
+            threads.emplace_back([&, t] {
+                auto value   = XLOPER12 {};
+                value.xltype = xltypeNum;
+                for (size_t i = 0; i < Values; ++i) {
+                    value.val.num = static_cast<double>(t * Values + i);
+                    owned[t].push_back(manager.add(value));
+                    if (i % 2 == 1) {
+                        manager.erase(owned[t].back());
+                        owned[t].pop_back();
+                    }
+                }
+            });
+        }
+    }
+
+    REQUIRE(manager.size() == before + Threads * Values / 2);
+    for (size_t t = 0; t < Threads; ++t)
+        for (size_t i = 0; i < owned[t].size(); ++i) {
+            REQUIRE(owned[t][i]->val.num == static_cast<double>(t * Values + 2 * i));
+            REQUIRE(manager.erase(owned[t][i]));
+        }
+    REQUIRE(manager.size() == before);
+}
+
+TEST_CASE( "MemoryManager Release", "[xll::MemoryManager]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    auto&      manager = xll::MemoryManager::Instance();
+    const auto before  = manager.size();
+
+    // Results are released by xlAutoFree12 as the type they were returned as:
+    auto* tracked = xll::AutoFree()(std::make_unique<Tracked>());
+    REQUIRE(tracked->xltype == (xltypeNum | xlbitDLLFree));
+    REQUIRE(manager.contains(tracked));
+    destroyed = 0;
+    xlAutoFree12(tracked);
+    REQUIRE(destroyed == 1);
+    REQUIRE(manager.size() == before);
+
+    auto expected = xll::Array<xll::Expected<xll::Number>>(2, 2, xll::Number(1.0));
+    expected[1]   = xll::ErrNA;
+    auto* cells   = expected | xll::AutoFree();
+    REQUIRE(cells->xltype == (xltypeMulti | xlbitDLLFree));
+    REQUIRE(manager.contains(cells));
+    host.release(cells);
+
+    auto* numbers = xll::Array<xll::Number>(1000, 10, xll::Number(1.5)) | xll::AutoFree();
+    host.release(numbers);
+    REQUIRE(manager.size() == before);
+
+    host.uninstall();
+}
+
+TEST_CASE( "MemoryManager Handoff", "[xll::MemoryManager]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    // A result passed with std::move is handed over with its buffer, instead of being copied:
+    auto  numbers = xll::Array<xll::Number>(1000, 1000, xll::Number(1.0));
+    auto* cells   = numbers.val.array.lparray;
+    auto* moved   = std::move(numbers) | xll::AutoFree();
+    REQUIRE(moved->val.array.lparray == cells);
+    REQUIRE(moved->val.array.rows == 1000);
+    REQUIRE(numbers.val.array.lparray == nullptr);
+    host.release(moved);
+
+    auto  strings = xll::Array<xll::String>(2, 2, xll::String("moved"));
+    auto* text    = strings[0].val.str;
+    auto* result  = std::move(strings) | xll::AutoFree();
+    REQUIRE(result->val.array.lparray[0].val.str == text);
+    host.release(result);
+
+    // ... while an lvalue is copied, and left as it was:
+    auto  source = xll::Array<xll::Number>(2, 2, xll::Number(2.0));
+    auto* copied = source | xll::AutoFree();
+    REQUIRE(copied->val.array.lparray != source.val.array.lparray);
+    REQUIRE(source[3] == 2.0);
+    host.release(copied);
+
+    host.uninstall();
+}
@@ -0,0 +1,95 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Types/NumericArray.hpp"
+#include "../Register/Function.hpp"
+#include "../Utils/Pipe.hpp"
+
+#include <numeric>
+
+TEST_CASE( "NumericArray Construction", "[xll::NumericArray]" )
+{
+    // Layout matches FP12:
+    static_assert(sizeof(xll::NumericArray) == sizeof(FP12));
+
+    auto arr = xll::NumericArray::make(3, 4);
+    REQUIRE(arr->rows() == 3);
+    REQUIRE(arr->cols() == 4);
+    REQUIRE(arr->size() == 12);
+    REQUIRE(arr->FP12::rows == 3);
+    REQUIRE(arr->FP12::columns == 4);
+
+    REQUIRE_THROWS(xll::NumericArray::make(1'048'577, 1));
+    REQUIRE_THROWS(xll::NumericArray::make(1, 16'385));
+
+    auto empty = xll::NumericArray::make(0, 0);
+    REQUIRE(empty->empty());
+    REQUIRE(empty->span().empty());
+}
+
+TEST_CASE( "NumericArray Views", "[xll::NumericArray]" )
+{
+    auto arr = xll::NumericArray::make(3, 4);
+    std::iota(arr->begin(), arr->end(), 0.0);
+
+    // The span is a view of the FP12 data:
+    auto span = arr->span();
+    REQUIRE(span.data() == arr->array);
+    REQUIRE(span.size() == 12);
+    REQUIRE(span[5] == 5.0);
+
+    // The mdspan is row-major:
+    auto md = arr->mdspan();
+    REQUIRE(md.extent(0) == 3);
+    REQUIRE(md.extent(1) == 4);
+    REQUIRE(md[1, 2] == 6.0);
+    md[2, 3] = 42.0;
+    REQUIRE(arr->array[11] == 42.0);
+
+    // Indexing:
+    REQUIRE((*arr)[7] == 7.0);
+    REQUIRE((*arr)[1, 3] == 7.0);
+    (*arr)[0, 1] = -1.0;
+    REQUIRE(span[1] == -1.0);
+    REQUIRE_THROWS((*arr)[12]);
+    REQUIRE_THROWS((*arr)[3, 0]);
+
+    // In-place shrinking:
+    arr->resize(2, 2);
+    REQUIRE(arr->size() == 4);
+    REQUIRE((*arr)[1, 1] == 3.0);
+    REQUIRE_THROWS(arr->resize(3, 3));
+}
+
+TEST_CASE( "NumericArray Return Buffer", "[xll::NumericArray]" )
+{
+    auto* first = xll::NumericArray::result(10, 10);
+    REQUIRE(first->size() == 100);
+    for (auto& value : *first) value = 1.0;
+
+    // Smaller results reuse the same thread-local buffer:
+    auto* second = xll::NumericArray::result(2, 3);
+    REQUIRE(second == first);
+    REQUIRE(second->rows() == 2);
+    REQUIRE(second->cols() == 3);
+}
+
+TEST_CASE( "NumericArray Registration", "[xll::NumericArray]" )
+{
+    auto fn = xll::Function("SCALE")
+                  | xll::Result<xll::NumericArray>()
+                  | xll::Procedure("Scale")
+                  | xll::Parameter<xll::NumericArray>("values", "The values")
+                  | xll::Parameter<double>("factor", "The factor");
+    REQUIRE(xll::impl::FunctionSignature(fn.args) == "K%K%B");
+
+    auto inplace = xll::Function("SCALE.INPLACE")
+                       | xll::Result<xll::InPlace<1>>()
+                       | xll::Procedure("ScaleInPlace")
+                       | xll::Parameter<xll::NumericArray>("values", "The values")
+                       | xll::ThreadSafe();
+    REQUIRE(xll::impl::FunctionSignature(inplace.args) == "1K%$");
+}
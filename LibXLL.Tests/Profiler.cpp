@@ -0,0 +1,135 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+// Registers the hidden diagnostic function, which is opt-in:
+#define XLL_PROFILE_FUNCTION
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Auto.hpp"
+#include "../Register.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+TEST_CASE( "Profiler Steps", "[xll::Profiler]" )
+{
+    auto& profiler = xll::Profiler::instance();
+    profiler.clear();
+
+    // When off, nothing is recorded, and the name is not even formatted:
+    bool named = false;
+    REQUIRE(profiler.measure([&] { named = true; return std::string("off"); }, [] { return 42; }) == 42);
+    REQUIRE(not named);
+    REQUIRE(profiler.steps().empty());
+
+    profiler.enable();
+    profiler.measure("outer", [&] {
+        profiler.measure("inner", [] {});
+    });
+    REQUIRE_THROWS_AS(profiler.measure("failing", [] { throw std::runtime_error("broken"); }), std::runtime_error);
+
+    const auto steps = profiler.steps();
+    REQUIRE(steps.size() == 3);
+    REQUIRE(steps[0].name == "outer");
+    REQUIRE(steps[0].depth == 0);
+    REQUIRE(steps[1].name == "inner");
+    REQUIRE(steps[1].depth == 1);
+    REQUIRE(steps[0].elapsed >= steps[1].elapsed);
+    REQUIRE(not steps[0].failed);
+    REQUIRE(steps[2].failed);
+    REQUIRE(steps[2].error == "broken");
+
+    REQUIRE(profiler.to_string().starts_with("Step,Milliseconds,Allocations,Status\nouter,"));
+    REQUIRE(profiler.to_string().find("\n  inner,") != std::string::npos);
+    REQUIRE(profiler.to_string().ends_with(",Failed: broken\n"));
+
+    profiler.disable();
+    profiler.clear();
+}
+
+TEST_CASE( "Profiler Startup", "[xll::Profiler]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    xll::Function("PROFILED.FUNCTION")
+        | xll::Result<xll::Number>()
+        | xll::Procedure("ProfiledFunction")
+        | xll::Parameter<xll::Number>("x", "The argument")
+        | xll::Register();
+
+    const auto path     = (std::filesystem::temp_directory_path() / "xll_profile.csv").string();
+    auto&      profiler = xll::Profiler::instance();
+    profiler.clear();
+    profiler.enable(path);
+
+    REQUIRE(host.open() == XLL_SUCCESS);
+
+    // The event, its hooks, and each registration are recorded, with the registrations nested in the event:
+    const auto steps = profiler.steps();
+    const auto find  = [&](const std::string& name) { return std::ranges::find(steps, name, &xll::ProfileStep::name); };
+    REQUIRE(find("Registry::register_all") != steps.end());
+    REQUIRE(find("xlAutoOpen Before") != steps.end());
+    REQUIRE(find("xlAutoOpen After") != steps.end());
+    REQUIRE(find("xlAutoOpen") != steps.end());
+    REQUIRE(find("xlAutoOpen")->depth == 0);
+    REQUIRE(find("xlfRegister PROFILED.FUNCTION") != steps.end());
+    REQUIRE(find("xlfRegister PROFILED.FUNCTION")->depth == 1);
+    REQUIRE(std::ranges::count_if(steps, [](const auto& step) { return step.name.starts_with("xlfRegister "); }) ==
+            static_cast<long>(xll::Function::functionArgs.size()));
+
+    // The report is written to the file:
+    std::stringstream contents;
+    contents << std::ifstream(path).rdbuf();
+    REQUIRE(contents.str() == profiler.to_string());
+    REQUIRE(contents.str().find("xlfRegister PROFILED.FUNCTION") != std::string::npos);
+
+    // ... and can be read from the hidden diagnostic function:
+    auto registrations = host.registrations();
+    auto reg = std::ranges::find(registrations, std::string("xllProfile"), &xll::mock::ExcelHost::Registration::procedure);
+    REQUIRE(reg != registrations.end());
+    REQUIRE(reg->functionText == "MOCK.XLL.PROFILE");
+    REQUIRE(reg->typeText == "Q!");
+    REQUIRE(reg->macroType == 0);
+
+    auto* table = xllProfile();
+    REQUIRE(table->xltype == xltypeMulti);
+    REQUIRE(table->val.array.columns == 4);
+    REQUIRE(static_cast<size_t>(table->val.array.rows) == steps.size() + 1);
+    REQUIRE(xll::String(table->val.array.lparray[0]) == "Step");
+    REQUIRE(xll::String(table->val.array.lparray[7]) == "OK");
+
+    // A failed registration is reported as such:
+    xll::Function("PROFILED.BROKEN") | xll::Result<xll::Number>() | xll::Register();
+    profiler.clear();
+    REQUIRE(host.open() == XLL_FAILURE);
+
+    const auto failed = profiler.steps();
+    auto       broken = std::ranges::find(failed, std::string("xlfRegister PROFILED.BROKEN"), &xll::ProfileStep::name);
+    REQUIRE(broken != failed.end());
+    REQUIRE(broken->failed);
+    REQUIRE(broken->error == "[xlAutoOpen]: Failed to register function PROFILED.BROKEN");
+    REQUIRE(std::ranges::find(failed, std::string("xlAutoOpen"), &xll::ProfileStep::name)->failed);
+
+    xll::Function::functionArgs.pop_back();
+    profiler.disable();
+    profiler.clear();
+    std::filesystem::remove(path);
+
+    // When off, the diagnostic function says so:
+    table = xllProfile();
+    REQUIRE(table->xltype == xltypeMulti);
+    REQUIRE(table->val.array.rows == 1);
+    REQUIRE(xll::String(table->val.array.lparray[0]).to_string().starts_with("Profiling is off"));
+
+    REQUIRE(host.close() == XLL_SUCCESS);
+    host.uninstall();
+}
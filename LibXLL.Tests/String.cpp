@@ -6,6 +6,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <xlcall.hpp>
 #include "../Types/String.hpp"
+#include "../Types/StringRef.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
 
 TEST_CASE( "String Construction", "[xll::String]" ) {
 
@@ -74,4 +79,168 @@ TEST_CASE( "String Assignment", "[xll::String]" )
     REQUIRE(str2.val.str == nullptr);
     REQUIRE(str1.val.str != str2.val.str);
     REQUIRE(std::wstring(&str1.val.str[1]) == std::wstring(L"str2"));
-}
\ No newline at end of file
+}
+
+TEST_CASE( "String Transcoding", "[xll::String]" )
+{
+    // ASCII, long enough to exercise the vectorised paths:
+    const auto ascii = std::string("The quick brown fox jumps over the lazy dog, 0123456789 times!");
+    const auto str1  = xll::String(ascii);
+    REQUIRE(static_cast<size_t>(str1.val.str[0]) == ascii.size());
+    REQUIRE(str1.val.str[ascii.size() + 1] == 0);
+    REQUIRE(str1.to_string() == ascii);
+
+    // Mixed ASCII and multi-byte sequences (2, 3 and 4 bytes):
+    const auto mixed = std::string("prefix-abcdefghijklmnop-æøå-€-\U0001F60A-suffix-abcdefghijklmnop");
+    const auto str2  = xll::String(mixed);
+    REQUIRE(str2.to_string() == mixed);
+
+    // The length prefix is used, not the terminator:
+    auto str3 = xll::String("abcdef");
+    str3.val.str[0] = 3;
+    REQUIRE(str3.to_string() == "abc");
+
+    // Invalid UTF-8 is rejected:
+    REQUIRE_THROWS(xll::String(std::string_view("\xC3")));              // Truncated sequence
+    REQUIRE_THROWS(xll::String(std::string_view("\xC0\xAF")));          // Overlong encoding
+    REQUIRE_THROWS(xll::String(std::string_view("\xED\xA0\x80")));      // Surrogate
+    REQUIRE_THROWS(xll::String(std::string_view("\xF4\x90\x80\x80")));  // Beyond U+10FFFF
+    REQUIRE_THROWS(xll::String(std::string_view("abc\x80")));           // Stray continuation byte
+
+    // UTF-16 (as used on Windows), including surrogate pairs:
+    char16_t utf16[64] {};
+    const auto units = xll::impl::utf::from_utf8(mixed, utf16);
+    REQUIRE(std::u16string_view(utf16, units) == u"prefix-abcdefghijklmnop-æøå-€-\U0001F60A-suffix-abcdefghijklmnop");
+    REQUIRE(xll::impl::utf::to_utf8(std::u16string_view(utf16, units)) == mixed);
+
+    // Unpaired surrogates are replaced when converting back to UTF-8:
+    REQUIRE(xll::impl::utf::to_utf8(std::u16string_view(u"a\xD800" "b")) == "a\xEF\xBF\xBD" "b");
+}
+
+TEST_CASE( "String Comparison", "[xll::String]" )
+{
+    auto abc = xll::String("abc");
+    auto abd = xll::String("abd");
+    auto uni = xll::String("Straße 😊");
+
+    // With other strings:
+    REQUIRE(abc == xll::String("abc"));
+    REQUIRE(abc != abd);
+    REQUIRE(abc < abd);
+    REQUIRE(abd > abc);
+    REQUIRE(xll::String("") < abc);
+    REQUIRE(uni < abc);    // Ordered by code point, so upper case sorts first
+
+    // With UTF-8 strings:
+    REQUIRE(abc == "abc");
+    REQUIRE(abc == std::string("abc"));
+    REQUIRE(abc != "abcd");
+    REQUIRE(abc < "abd");
+    REQUIRE(abc > std::string_view("ab"));
+    REQUIRE(uni == "Straße 😊");
+    REQUIRE(uni < "Straße 😋");
+
+    // With XCHAR views and references:
+    REQUIRE(abc == std::wstring_view(L"abc"));
+    REQUIRE(abc < std::wstring_view(L"abd"));
+    REQUIRE(abc == xll::StringRef(abc));
+    REQUIRE(xll::StringRef(abd) > abc);
+
+    // Ordered by code point on every side, also where XCHAR is UTF-16 and U+1F60A (a surrogate pair) would sort
+    // below U+FF21 by unit:
+    auto fullwidth = xll::String("\uFF21");
+    auto smile     = xll::String("\U0001F60A");
+    REQUIRE(fullwidth < smile);
+    REQUIRE(fullwidth < "\U0001F60A");
+    REQUIRE(fullwidth < smile.view());
+    REQUIRE(xll::StringRef(fullwidth) < smile);
+
+    // Moved-from strings compare as empty:
+    auto moved = xll::String("moved");
+    auto target = std::move(moved);
+    REQUIRE(moved == std::wstring_view());
+
+    // Hashing is consistent across String, StringRef and views:
+    REQUIRE(std::hash<xll::String>()(abc) == std::hash<xll::StringRef>()(xll::StringRef(abc)));
+    REQUIRE(std::hash<xll::String>()(abc) == xll::StringHash()(std::wstring_view(L"abc")));
+
+    // Heterogeneous lookup:
+    auto set = std::unordered_set<xll::String, xll::StringHash, std::equal_to<>> { abc, uni };
+    REQUIRE(set.contains(std::wstring_view(L"abc")));
+    REQUIRE(set.contains(xll::StringRef(uni)));
+    REQUIRE(set.find(std::wstring_view(L"abd")) == set.end());
+
+    // Sorting and deduplication:
+    auto values = std::vector<xll::String> { abd, uni, abc, abd, abc };
+    std::ranges::sort(values);
+    values.erase(std::ranges::unique(values).begin(), values.end());
+    REQUIRE(values.size() == 3);
+    REQUIRE(values[0] == "Straße 😊");
+    REQUIRE(values[1] == "abc");
+    REQUIRE(values[2] == "abd");
+}
+
+TEST_CASE( "String Literals", "[xll::String]" )
+{
+    using namespace xll::literals;
+
+    // Literals borrow a buffer built at compile time:
+    auto str1 = "AAPL US Equity"_xs;
+    REQUIRE(str1.is_borrowed());
+    REQUIRE(str1 == "AAPL US Equity");
+    REQUIRE(str1.val.str[0] == 14);
+    REQUIRE(str1.val.str[15] == 0);
+
+    // Every evaluation refers to the same static buffer:
+    REQUIRE("AAPL US Equity"_xs.val.str == str1.val.str);
+
+    // Non-ASCII literals are transcoded at compile time as well:
+    auto str2 = "召唤😊"_xs;
+    REQUIRE(str2.is_borrowed());
+    REQUIRE(str2.to_string() == "召唤😊");
+    REQUIRE(str2 == xll::String("召唤😊"));
+
+    // Copies share the buffer; destroying them leaves it alone:
+    {
+        auto copy = str1;
+        REQUIRE(copy.is_borrowed());
+        REQUIRE(copy.val.str == str1.val.str);
+    }
+    REQUIRE(str1 == "AAPL US Equity");
+
+    // Assigning between borrowed and owned strings:
+    auto str3 = xll::String("owned");
+    REQUIRE(not str3.is_borrowed());
+    str3 = str1;
+    REQUIRE(str3.is_borrowed());
+    str3 = xll::String("owned again");
+    REQUIRE(not str3.is_borrowed());
+    REQUIRE(str3 == "owned again");
+    str3 = std::move(str1);
+    REQUIRE(str3.is_borrowed());
+    REQUIRE(str3 == "AAPL US Equity");
+    REQUIRE(not str1.is_borrowed());
+
+    // Concatenation produces an owned string:
+    auto str4 = str3 + "!"_xs;
+    REQUIRE(not str4.is_borrowed());
+    REQUIRE(str4 == "AAPL US Equity!");
+
+    // Default construction borrows the static empty string:
+    xll::String str5;
+    REQUIRE(str5.is_borrowed());
+    REQUIRE(str5.empty());
+    REQUIRE(str5 == ""_xs);
+
+    // A string from Excel is never taken for a borrowed one, whatever the rest of the XLOPER12 holds:
+    auto     owner = xll::String("from Excel");
+    XLOPER12 oper {};
+    oper.xltype           = xltypeStr;
+    oper.val.mref.idSheet = 0x58535452;
+    oper.val.str          = owner.val.str;
+    const auto& excel     = reinterpret_cast<const xll::String&>(oper);
+    REQUIRE(not excel.is_borrowed());
+    auto copy = excel;
+    REQUIRE(copy.val.str != oper.val.str);
+    REQUIRE(copy == "from Excel");
+}
@@ -0,0 +1,118 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Types/StringRef.hpp"
+#include "../Types/Number.hpp"
+#include "../Utils/Traits.hpp"
+#include "../Utils/Transcode.hpp"
+
+#include <unordered_set>
+
+TEST_CASE( "StringRef Construction", "[xll::StringRef]" )
+{
+    static_assert(sizeof(xll::StringRef) == sizeof(XLOPER12));
+
+    // Default construction refers to an empty string:
+    xll::StringRef ref1;
+    REQUIRE(ref1.xltype == xltypeStr);
+    REQUIRE(ref1.empty());
+    REQUIRE(ref1.to_string().empty());
+
+    // Construction from a String refers to the same buffer:
+    auto str = xll::String("AAPL US Equity");
+    xll::StringRef ref2 = str;
+    REQUIRE(ref2.val.str == str.val.str);
+    REQUIRE(ref2.size() == 14);
+    REQUIRE(ref2.view() == L"AAPL US Equity");
+
+    // Construction from an XLOPER12 (e.g. an argument passed by Excel):
+    const XLOPER12& oper = str;
+    auto ref3 = xll::StringRef(oper);
+    REQUIRE(ref3.val.str == str.val.str);
+    REQUIRE_THROWS(xll::StringRef(xll::Number(1.0)));
+
+    // Copies are shallow, and destruction leaves the buffer alone:
+    {
+        auto ref4 = ref3;
+        REQUIRE(ref4.val.str == str.val.str);
+    }
+    REQUIRE(str == "AAPL US Equity");
+
+    // Owning copy and UTF-8 conversion:
+    auto owned = ref2.to_owned();
+    REQUIRE(owned.val.str != str.val.str);
+    REQUIRE(owned == str);
+    REQUIRE(ref2.to_string() == "AAPL US Equity");
+
+    REQUIRE(xll::traits::arg_traits<xll::StringRef>::excel_type == "Q");
+}
+
+TEST_CASE( "StringRef Comparison", "[xll::StringRef]" )
+{
+    auto abc = xll::String("abc");
+    auto abd = xll::String("abd");
+    auto uni = xll::String("Straße 😊");
+
+    const auto ref1 = xll::StringRef(abc);
+    const auto ref2 = xll::StringRef(abd);
+    const auto ref3 = xll::StringRef(uni);
+
+    // With other references:
+    REQUIRE(ref1 == xll::StringRef(abc));
+    REQUIRE(ref1 != ref2);
+    REQUIRE(ref1 < ref2);
+    REQUIRE(ref1 == abc);
+
+    // With wide strings:
+    REQUIRE(ref1 == std::wstring_view(L"abc"));
+    REQUIRE(ref1 < std::wstring_view(L"abcd"));
+
+    // With UTF-8 strings, without allocating:
+    REQUIRE(ref1 == "abc");
+    REQUIRE(ref1 != "ab");
+    REQUIRE(ref1 != "abcd");
+    REQUIRE(ref1 < "abd");
+    REQUIRE(ref1 > "abb");
+    REQUIRE(ref3 == "Straße 😊");
+    REQUIRE(ref3 != "Straße 😋");
+    REQUIRE(ref3 < "Straße 😋");
+    REQUIRE(ref3 > "Straße");
+
+    // Hashing:
+    auto set = std::unordered_set<xll::StringRef> { ref1, ref2 };
+    REQUIRE(set.contains(xll::StringRef(abc)));
+    REQUIRE(not set.contains(ref3));
+    REQUIRE(std::hash<xll::StringRef>()(ref1) == std::hash<std::wstring_view>()(L"abc"));
+}
+
+TEST_CASE( "StringRef Unpaired Surrogates", "[xll::StringRef]" )
+{
+    using xll::impl::utf::compare_utf8;
+
+    // An unpaired high surrogate compares as U+FFFD, and the following unit is compared on its own:
+    REQUIRE(compare_utf8(std::u16string_view(u"\xD83D" u"A"), "\xEF\xBF\xBD" "A") == 0);
+    REQUIRE(compare_utf8(std::u16string_view(u"\xD83D" u"A"), "\xEF\xBF\xBD" "B") < 0);
+    REQUIRE(compare_utf8(std::u16string_view(u"x\xD83D\x00E9"), "x\xEF\xBF\xBD\xC3\xA9") == 0);
+    REQUIRE(compare_utf8(std::u16string_view(u"\xD83D\xD83D"), "\xEF\xBF\xBD\xEF\xBF\xBD") == 0);
+
+    // A trailing high surrogate and a lone low surrogate:
+    REQUIRE(compare_utf8(std::u16string_view(u"A\xD83D"), "A\xEF\xBF\xBD") == 0);
+    REQUIRE(compare_utf8(std::u16string_view(u"\xDE0A" "A"), "\xEF\xBF\xBD" "A") == 0);
+
+    // UTF-16 is ordered by code point as well, also where the texts differ in the low surrogate of a pair:
+    using xll::impl::utf::compare_wide;
+    using view = std::u16string_view;
+    REQUIRE(compare_wide(view(u"\xFF21"), view(u"\xD83D\xDE0A")) < 0);
+    REQUIRE(compare_wide(view(u"a\xD83D\xDE0A"), view(u"a\xD83D\xDE0B")) < 0);
+    REQUIRE(compare_wide(view(u"a\xD83D\xDE0A"), view(u"a\xE000")) > 0);
+    REQUIRE(compare_wide(view(u"\xD83D\xDE0A"), view(u"\xD83D\xDE0A")) == 0);
+    REQUIRE(compare_wide(view(u"\xD83D\xDE0A"), view(u"\xD83D")) > 0);
+
+    // An unpaired surrogate counts as U+FFFD, but only equal texts compare equal:
+    REQUIRE(compare_wide(view(u"\xD83D" u"A"), view(u"\xFFFD" u"B")) < 0);
+    REQUIRE(compare_wide(view(u"\xD83D"), view(u"\xFFFD")) < 0);
+    REQUIRE(compare_wide(view(u"\xFFFD"), view(u"\xD83D")) > 0);
+}
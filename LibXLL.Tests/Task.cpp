@@ -0,0 +1,159 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Async.hpp"
+#include "../Types.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    std::atomic<size_t> unwound { 0 };
+
+    xll::Task<double> task_square(double value)
+    {
+        co_await xll::schedule();
+        co_return value * value;
+    }
+
+    xll::Task<xll::Number> task_compute(double value)
+    {
+        const auto square = co_await task_square(value);
+        co_await xll::sleep_for(1ms);
+        const auto offset = co_await xll::offload([] { return 1.0; });
+        co_return xll::Number(square + offset);
+    }
+
+    xll::Task<std::string> task_greet(std::string_view name)
+    {
+        co_await xll::sleep_for(1ms);
+        if (name.empty()) throw std::domain_error("no name");
+        co_return "Hello, " + std::string(name);
+    }
+
+    xll::Task<double> task_wait(double milliseconds)
+    {
+        co_await xll::sleep_for(std::chrono::duration<double, std::milli>(milliseconds));
+        co_return milliseconds;
+    }
+
+    xll::Task<double> task_cancelled()
+    {
+        try {
+            co_await xll::sleep_for(100ms);
+        }
+        catch (const xll::Canceled&) {
+            ++unwound;
+            throw;
+        }
+        co_return 0.0;
+    }
+
+    bool wait_for(auto&& condition)
+    {
+        for (int i = 0; i < 5000 && not condition(); ++i) std::this_thread::sleep_for(1ms);
+        return condition();
+    }
+}    // namespace
+
+XLL_ASYNC_UDF(TaskCompute, task_compute, value)
+XLL_ASYNC_UDF(TaskGreet, task_greet, name)
+XLL_ASYNC_UDF(TaskWait, task_wait, milliseconds)
+XLL_ASYNC_UDF(TaskCancelled, task_cancelled)
+
+TEST_CASE( "Task Registration", "[xll::Task]" )
+{
+    // Coroutines are registered as any other asynchronous function:
+    STATIC_REQUIRE(xll::impl::TypeText<TaskCompute>::view() == ">BX");
+    STATIC_REQUIRE(xll::impl::TypeText<TaskGreet, "$">::view() == ">CX$");
+    STATIC_REQUIRE(xll::impl::TypeText<TaskCancelled>::view() == ">X");
+}
+
+TEST_CASE( "Task Calls", "[xll::Task]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+    xll::configure_async(2);
+
+    // Sub-tasks, timers and offloaded work are awaited in turn:
+    auto handle = host.async_handle();
+    TaskCompute(3.0, static_cast<const xll::AsyncHandle*>(&handle));
+    REQUIRE(host.wait_async(1, 5s));
+    REQUIRE(host.async_result(handle)->xltype == xltypeNum);
+    REQUIRE(host.async_result(handle)->number == 10.0);
+
+    // The arguments are owned by the coroutine:
+    handle = host.async_handle();
+    {
+        auto name = std::string("world");
+        TaskGreet(name.c_str(), static_cast<const xll::AsyncHandle*>(&handle));
+        name = "XXXXX";
+    }
+    REQUIRE(host.wait_async(2, 5s));
+    REQUIRE(host.async_result(handle)->text == "Hello, world");
+
+    // Exceptions are returned as errors:
+    handle = host.async_handle();
+    TaskGreet("", static_cast<const xll::AsyncHandle*>(&handle));
+    REQUIRE(host.wait_async(3, 5s));
+    REQUIRE(host.async_result(handle)->error == xlerrNum);
+
+    // Waiting coroutines hold no thread: 300 calls waiting 50 ms each finish long before two blocked workers would:
+    constexpr size_t Calls   = 300;
+    auto             handles = std::vector<XLOPER12>(Calls);
+    const auto       start   = std::chrono::steady_clock::now();
+    for (auto& h : handles) {
+        h = host.async_handle();
+        TaskWait(50.0, static_cast<const xll::AsyncHandle*>(&h));
+    }
+    REQUIRE(host.wait_async(Calls + 3, 10s));
+    REQUIRE(std::chrono::steady_clock::now() - start < 2500ms);
+    for (const auto& h : handles) REQUIRE(host.async_result(h)->number == 50.0);
+
+    xll::configure_async(xll::ThreadPool::default_threads());
+    REQUIRE(host.close() == XLL_SUCCESS);
+    host.uninstall();
+}
+
+TEST_CASE( "Task Cancellation", "[xll::Task]" )
+{
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+    REQUIRE(host.open() == XLL_SUCCESS);
+
+    const auto before  = xll::async_stats();
+    const auto unwinds = unwound.load();
+
+    auto handles = std::vector { host.async_handle(), host.async_handle() };
+    for (auto& h : handles) TaskCancelled(static_cast<const xll::AsyncHandle*>(&h));
+    REQUIRE(wait_for([&] { return xll::impl::AsyncRuntime::instance().timers().pending() == 2; }));
+
+    // The sleeping coroutines wake up to xll::Canceled, and return nothing:
+    host.cancel_calculation();
+    REQUIRE(xllAsyncCalculationCanceled() == XLL_SUCCESS);
+    REQUIRE(wait_for([&] { return xll::async_stats().canceled == before.canceled + 2; }));
+    REQUIRE(unwound == unwinds + 2);
+    REQUIRE(host.async_returned() == 0);
+
+    // Coroutines still sleeping when the add-in closes are woken up, and unwind the same way:
+    auto handle = host.async_handle();
+    TaskCancelled(static_cast<const xll::AsyncHandle*>(&handle));
+    REQUIRE(wait_for([&] { return xll::impl::AsyncRuntime::instance().timers().pending() == 1; }));
+    REQUIRE(host.close() == XLL_SUCCESS);
+    REQUIRE(unwound == unwinds + 3);
+    REQUIRE(host.async_returned() == 0);
+    host.uninstall();
+}
@@ -0,0 +1,215 @@
+//
+// Created by kenne on 18/10/2026.
+//
+
+#include <catch2/catch_test_macros.hpp>
+#include <xlcall.hpp>
+#include "../Mock/ExcelHost.hpp"
+#include "../Register.hpp"
+#include "../Types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    double scale_sum(double factor, std::span<const double> values)
+    {
+        return factor * std::accumulate(values.begin(), values.end(), 0.0);
+    }
+
+    double checked_sqrt(double value)
+    {
+        if (value < 0.0) throw std::domain_error("negative argument");
+        return std::sqrt(value);
+    }
+
+    std::string describe(const xll::Number& value, bool upper)
+    {
+        if (value < 0.0) throw xll::ErrNA;
+        return upper ? "POSITIVE" : "positive";
+    }
+
+    xll::Array<xll::Number> repeat(const xll::Number& value, int32_t count)
+    {
+        if (count < 0) throw std::invalid_argument("negative count");
+        auto result = xll::Array<xll::Number>(static_cast<size_t>(count), 1);
+        std::ranges::fill(result, value);
+        return result;
+    }
+
+    constexpr auto answer = [] { return 42.0; };
+
+    constexpr auto count_text = [](const xll::StringRef& text) noexcept { return static_cast<int32_t>(text.size()); };
+}    // namespace
+
+XLL_UDF(UdfScaleSum, scale_sum, factor, values)
+XLL_UDF(UdfCheckedSqrt, checked_sqrt, value)
+XLL_UDF(UdfDescribe, describe, value, upper)
+XLL_UDF(UdfRepeat, repeat, value, count)
+XLL_UDF(UdfAnswer, answer)
+XLL_UDF(UdfCountText, count_text, text)
+
+TEST_CASE( "Udf Thunks", "[xll::Udf]" )
+{
+    // Numbers are passed by value, ranges of numbers as one FP12 block:
+    auto values = xll::NumericArray::make(3, 1);
+    std::ranges::copy(std::array { 1.0, 2.0, 3.0 }, values->begin());
+
+    auto* result = UdfScaleSum(2.0, values.get());
+    REQUIRE(result->xltype == xltypeNum);
+    REQUIRE(result->val.num == 12.0);
+
+    // Exceptions become Excel errors:
+    REQUIRE(UdfCheckedSqrt(4.0)->val.num == 2.0);
+    REQUIRE(UdfCheckedSqrt(-1.0)->xltype == xltypeErr);
+    REQUIRE(UdfCheckedSqrt(-1.0)->val.err == xlerrNum);
+
+    // XLOPER12 arguments are checked against the parameter type:
+    auto num = xll::Number(1.5);
+    REQUIRE(xll::String(*UdfDescribe(&num, 1)) == "POSITIVE");
+    REQUIRE(xll::String(*UdfDescribe(&num, 0)) == "positive");
+
+    auto negative = xll::Number(-1.5);
+    REQUIRE(UdfDescribe(&negative, 1)->val.err == xlerrNA);
+
+    auto text = xll::String("not a number");
+    REQUIRE(UdfDescribe(reinterpret_cast<const xll::Number*>(&text), 1)->xltype == xltypeErr);
+    REQUIRE(UdfDescribe(reinterpret_cast<const xll::Number*>(&text), 1)->val.err == xlerrValue);
+
+    // Owning results stay alive until the next call on the same thread:
+    auto* array = UdfRepeat(&num, 3);
+    REQUIRE(array->xltype == xltypeMulti);
+    REQUIRE(array->val.array.rows == 3);
+    REQUIRE(array->val.array.lparray[2].val.num == 1.5);
+    REQUIRE((array->xltype & xlbitDLLFree) == 0);
+    REQUIRE(UdfRepeat(&num, -1)->val.err == xlerrValue);
+
+    // Stateless function objects, and functions without parameters:
+    REQUIRE(UdfAnswer()->val.num == 42.0);
+    auto ref = xll::StringRef(text);
+    REQUIRE(UdfCountText(&ref)->val.num == 12.0);
+}
+
+XLL_FUNCTION xll::Number* XLLAPI UdfHandWritten(xll::Number const*, xll::NumericArray*, double, short)
+{
+    return nullptr;
+}
+
+XLL_FUNCTION xll::Number* XLLAPI UdfHandAdd(xll::Number const* lhs, xll::Number const* rhs)
+{
+    return xll::Number(*lhs + *rhs) | xll::ThreadLocal();
+}
+
+XLL_FUNCTION xll::Array<xll::Number>* XLLAPI UdfHandRepeat(xll::Number const* value, int32_t count)
+{
+    return xll::Array<xll::Number>(static_cast<size_t>(count), 1, *value) | xll::ThreadLocal();
+}
+
+TEST_CASE( "Udf Return Slots", "[xll::Udf]" )
+{
+    const auto one = xll::Number(1.0);
+    const auto two = xll::Number(2.0);
+
+    // Results are returned from a per-thread slot, without xlbitDLLFree:
+    auto* result = UdfHandAdd(&one, &two);
+    REQUIRE(result->xltype == xltypeNum);
+    REQUIRE(result->val.num == 3.0);
+    REQUIRE(UdfHandAdd(&two, &two) == result);
+    REQUIRE(result->val.num == 4.0);
+
+    // ... of which every calculation thread has its own:
+    xll::Number* other = nullptr;
+    std::thread([&] { other = UdfHandAdd(&one, &one); }).join();
+    REQUIRE(other != result);
+    REQUIRE(result->val.num == 4.0);
+
+    // Owning results release the previous value when the slot is reused:
+    auto* cells = UdfHandRepeat(&two, 3);
+    REQUIRE(cells->xltype == xltypeMulti);
+    REQUIRE(cells->val.array.rows == 3);
+    REQUIRE(std::ranges::all_of(*cells, [](const xll::Number& n) { return n == 2.0; }));
+    REQUIRE(UdfHandRepeat(&one, 5) == cells);
+    REQUIRE(cells->val.array.rows == 5);
+    REQUIRE(std::ranges::all_of(*cells, [](const xll::Number& n) { return n == 1.0; }));
+}
+
+TEST_CASE( "Udf Registration", "[xll::Udf]" )
+{
+    // The type text is derived at compile time from the exported procedure:
+    STATIC_REQUIRE(xll::impl::TypeText<UdfScaleSum>::view() == "QBK%");
+    STATIC_REQUIRE(xll::impl::TypeText<UdfDescribe>::view() == "QQA");
+    STATIC_REQUIRE(xll::impl::TypeText<UdfRepeat, "$">::view() == "QQJ$");
+    STATIC_REQUIRE(xll::impl::TypeText<UdfAnswer, "!">::view() == "Q!");
+    STATIC_REQUIRE(xll::impl::TypeText<UdfHandWritten, "$&">::view() == "QQK%BA$&");
+    STATIC_REQUIRE(xll::impl::TypeText<UdfHandWritten>::arity == 4);
+    STATIC_REQUIRE(xll::impl::Thunk<answer>::arity == 0);
+
+    // Procedures that Excel can't call, and conflicting modifiers, are rejected:
+    STATIC_REQUIRE(xll::impl::has_type_text<xll::Array<xll::Number> const*>);
+    STATIC_REQUIRE_FALSE(xll::impl::has_type_text<std::vector<double>>);
+    STATIC_REQUIRE_FALSE(xll::impl::has_type_text<void>);
+    STATIC_REQUIRE_FALSE(xll::impl::valid_modifiers("$$"));
+    STATIC_REQUIRE_FALSE(xll::impl::valid_modifiers("#$"));
+    STATIC_REQUIRE_FALSE(xll::impl::valid_modifiers("X"));
+
+    // No allocation: the String refers to the static text.
+    REQUIRE(xll::impl::TypeText<UdfScaleSum, "$">::string().is_borrowed());
+    REQUIRE(xll::impl::TypeText<UdfScaleSum, "$">::string() == "QBK%$");
+
+    auto& host = xll::mock::ExcelHost::instance();
+    host.install();
+    host.reset();
+
+    xll::Function("UDF.SCALE.SUM")
+        | xll::Procedure("UdfScaleSum")
+        | xll::Signature<UdfScaleSum, "$">()
+        | xll::Argument("factor", "The scale factor")
+        | xll::Argument("values", "The values to sum")
+        | xll::Register();
+
+    xll::Function("UDF.DESCRIBE")
+        | xll::Procedure("UdfDescribe")
+        | xll::Signature<UdfDescribe>()
+        | xll::Argument("value", "The value")
+        | xll::Argument("upper", "Upper case")
+        | xll::ThreadSafe()
+        | xll::Register();
+
+    REQUIRE(host.open() == XLL_SUCCESS);
+
+    auto registrations = host.registrations();
+    auto reg = std::ranges::find(registrations, std::string("UdfScaleSum"), &xll::mock::ExcelHost::Registration::procedure);
+    REQUIRE(reg != registrations.end());
+    REQUIRE(reg->typeText == "QBK%$");
+    REQUIRE(reg->argumentText == "factor,values");
+    REQUIRE(reg->argumentHelp.size() == 2);
+
+    reg = std::ranges::find(registrations, std::string("UdfDescribe"), &xll::mock::ExcelHost::Registration::procedure);
+    REQUIRE(reg != registrations.end());
+    REQUIRE(reg->typeText == "QQA$");
+
+    // The arguments must all be named, and ThreadSafe() can't be combined with a macro sheet equivalent:
+    REQUIRE_THROWS(xll::Function("UDF.MISSING")
+        | xll::Procedure("UdfScaleSum")
+        | xll::Signature<UdfScaleSum, "$">()
+        | xll::Argument("factor", "The scale factor")
+        | xll::Register());
+    REQUIRE_THROWS(xll::Function("UDF.MACRO")
+        | xll::Procedure("UdfDescribe")
+        | xll::Signature<UdfDescribe, "#">()
+        | xll::Argument("value", "The value")
+        | xll::Argument("upper", "Upper case")
+        | xll::ThreadSafe()
+        | xll::Register());
+
+    REQUIRE(host.close() == XLL_SUCCESS);
+    host.uninstall();
+}
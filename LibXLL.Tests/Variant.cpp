@@ -6,6 +6,9 @@
 #include <xlcall.hpp>
 #include "../Types/Variant.hpp"
 
+#include <string>
+#include <variant>
+
 TEST_CASE( "Variant Construction", "[xll::Variant]" ) {
 
     // // Check default construction. Should default to Number with a value of zero.
@@ -127,4 +130,145 @@ TEST_CASE( "Variant Visitation", "[xll::Variant]" )
     //
     // var = xll::Missing();
     // REQUIRE(xll::visit(visitor, var) == "MISSING");
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Variant Dispatch", "[xll::Variant]" )
+{
+    using variant_t = xll::Variant<xll::Nil, xll::String, xll::Int, xll::Number, xll::Bool, xll::Error>;
+
+    auto type_name = xll::overload {
+        [](const xll::Nil&) { return 'z'; },
+        [](const xll::String&) { return 's'; },
+        [](const xll::Int&) { return 'i'; },
+        [](const xll::Number&) { return 'n'; },
+        [](const xll::Bool&) { return 'b'; },
+        [](const xll::Error&) { return 'e'; },
+    };
+
+    SECTION("Default construction holds the first alternative")
+    {
+        REQUIRE(variant_t().xltype == xltypeNil);
+        REQUIRE(xll::Variant<xll::String, xll::Nil>().xltype == xltypeStr);
+        REQUIRE(xll::get<xll::String>(xll::Variant<xll::String, xll::Nil>()).empty());
+    }
+
+    SECTION("Copy creates an independent String, and copies other alternatives bitwise")
+    {
+        const auto str  = variant_t(xll::String("Hello World"));
+        const auto copy = variant_t(str);
+        REQUIRE(copy.xltype == xltypeStr);
+        REQUIRE(xll::get<xll::String>(copy) == "Hello World");
+        REQUIRE(copy.val.str != str.val.str);
+
+        const auto num = variant_t(xll::Number(3.14));
+        REQUIRE(xll::get<xll::Number>(variant_t(num)) == 3.14);
+    }
+
+    SECTION("Move relocates the String and detaches it from the source")
+    {
+        auto        str    = variant_t(xll::String("Hello World"));
+        const auto* buffer = str.val.str;
+
+        auto moved = variant_t(std::move(str));
+        REQUIRE(moved.val.str == buffer);
+        REQUIRE(str.xltype == xltypeStr);    // NOLINT (moved-from state is specified)
+        REQUIRE(str.val.str == nullptr);
+
+        auto target = variant_t(xll::Int(1));
+        target      = std::move(moved);
+        REQUIRE(target.val.str == buffer);
+        REQUIRE(xll::get<xll::String>(target) == "Hello World");
+    }
+
+    SECTION("Assignment between alternatives")
+    {
+        auto var = variant_t(xll::String("abc"));
+        var      = variant_t(xll::Number(1.5));
+        REQUIRE(xll::get<xll::Number>(var) == 1.5);
+
+        var = variant_t(xll::String("def"));
+        REQUIRE(xll::get<xll::String>(var) == "def");
+
+        var = xll::Bool(true);
+        REQUIRE(var.xltype == xltypeBool);
+
+        auto str = xll::String("ghi");
+        var      = str;
+        REQUIRE(xll::get<xll::String>(var) == "ghi");
+
+        var = std::move(str);
+        REQUIRE(xll::get<xll::String>(var) == "ghi");
+
+        var = xll::Missing();
+        REQUIRE(var.xltype == xltypeNil);
+
+        var = variant_t(xll::String("jkl"));
+        const auto& self = var;
+        var              = self;
+        REQUIRE(xll::get<xll::String>(var) == "jkl");
+
+        var = xll::get<xll::String>(var);
+        REQUIRE(xll::get<xll::String>(var) == "jkl");
+    }
+
+    SECTION("Visit dispatches on xltype")
+    {
+        REQUIRE(xll::visit(type_name, variant_t()) == 'z');
+        REQUIRE(xll::visit(type_name, variant_t(xll::String("x"))) == 's');
+        REQUIRE(xll::visit(type_name, variant_t(xll::Int(1))) == 'i');
+        REQUIRE(xll::visit(type_name, variant_t(xll::Number(1.0))) == 'n');
+        REQUIRE(xll::visit(type_name, variant_t(xll::Bool(true))) == 'b');
+        REQUIRE(xll::visit(type_name, variant_t(xll::ErrNA)) == 'e');
+
+        // An argument passed by Excel may hold Missing, which is visited as Nil
+        auto missing   = variant_t();
+        missing.xltype = xltypeMissing;
+        REQUIRE(xll::visit(type_name, missing) == 'z');
+
+        auto invalid   = variant_t();
+        invalid.xltype = xltypeMulti;
+        REQUIRE_THROWS_AS(xll::visit(type_name, invalid), std::bad_variant_access);
+        invalid.xltype = xltypeNum | xltypeInt;
+        REQUIRE_THROWS_AS(xll::visit(type_name, invalid), std::bad_variant_access);
+        invalid.xltype = xltypeNil;
+    }
+
+    SECTION("Visit returns references")
+    {
+        const auto  var   = variant_t(xll::Number(2.5));
+        const auto& value = xll::visit([](const auto& v) -> const XLOPER12& { return v; }, var);
+        REQUIRE(&value == &var);
+    }
+
+    SECTION("Two-variant visit dispatches on both xltypes")
+    {
+        using other_t = xll::Variant<xll::Number, xll::Nil>;
+
+        auto pair_name = [&](const auto& a, const auto& b) { return std::string { type_name(a), type_name(b) }; };
+
+        REQUIRE(xll::visit(pair_name, variant_t(xll::String("x")), other_t(xll::Number(1.0))) == "sn");
+        REQUIRE(xll::visit(pair_name, variant_t(xll::ErrNA), other_t()) == "en");
+        REQUIRE(xll::visit(pair_name, variant_t(xll::Bool(true)), other_t(xll::Nil())) == "bz");
+        REQUIRE(xll::visit(pair_name, variant_t(), variant_t(xll::Int(1))) == "zi");
+
+        auto sum = xll::overload {
+            [](const xll::Number& a, const xll::Number& b) { return a.val.num + b.val.num; },
+            [](const xll::Number& a, const xll::Int& b) { return a.val.num + b.val.w; },
+            [](const auto&, const auto&) { return 0.0; },
+        };
+        REQUIRE(xll::visit(sum, variant_t(xll::Number(1.5)), variant_t(xll::Number(2.0))) == 3.5);
+        REQUIRE(xll::visit(sum, variant_t(xll::Number(1.5)), variant_t(xll::Int(2))) == 3.5);
+        REQUIRE(xll::visit(sum, variant_t(xll::Int(2)), variant_t(xll::Number(1.5))) == 0.0);
+
+        auto invalid   = other_t();
+        invalid.xltype = xltypeStr;
+        REQUIRE_THROWS_AS(xll::visit(pair_name, variant_t(), invalid), std::bad_variant_access);
+        invalid.xltype = xltypeNil;
+    }
+
+    SECTION("Plain variants are plain data")
+    {
+        STATIC_REQUIRE(xll::Variant<xll::Nil, xll::Number, xll::Int>::is_plain_data);
+        STATIC_REQUIRE(not variant_t::is_plain_data);
+    }
+}